@@ -0,0 +1,175 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "Data.hpp"
+#include "Process.hpp"
+
+// count every allocation so that the benchmarks can report allocations per iteration
+namespace {
+	std::atomic<uint64_t> allocations = 0;
+}  // namespace
+
+// not inlined, so that GCC does not warn about pairing malloc and free with new and delete
+[[gnu::noinline]] void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+	throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+	enum class Signal { silence, sine, noise };
+
+	constexpr uint32_t sampleRate = 44100;
+	constexpr float smoothingLevel = 16.f;
+
+	/**
+	 * Interleaved samples of the given signal, as copied out of the AudioSampler
+	 */
+	std::vector<float> generateSignal(Signal signal, size_t channels, size_t bufferSize) {
+		std::vector<float> samples(channels * bufferSize);
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+		for (size_t i = 0; i < bufferSize; ++i) {
+			for (size_t channel = 0; channel < channels; ++channel) {
+				float& sample = samples[i * channels + channel];
+				switch (signal) {
+					case Signal::silence:
+						sample = 0.f;
+						break;
+					case Signal::sine:
+						// a chord with a different fundamental in each channel
+						sample = 0.f;
+						for (float frequency : {110.f, 440.f, 1760.f})
+							sample += std::sin(2.f * static_cast<float>(M_PI) * frequency *
+							                   (channel + 1) * i / sampleRate) /
+							          3.f;
+						break;
+					case Signal::noise:
+						sample = distribution(generator);
+						break;
+				}
+			}
+		}
+		return samples;
+	}
+
+	Process createProcess(size_t bufferSize, size_t channels, bool smoothing) {
+		Process::Settings settings = {};
+		settings.size = bufferSize;
+		settings.channels = static_cast<unsigned char>(channels);
+		settings.smoothingLevel = smoothing ? smoothingLevel : 0.f;
+		settings.amplitude = 1.f;
+		settings.sampleRate = sampleRate;
+		return Process(settings);
+	}
+
+	void setCounters(benchmark::State& state, size_t samples, uint64_t allocationCount) {
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * samples));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * samples * sizeof(float)));
+		state.counters["allocations"] =
+		    benchmark::Counter(static_cast<double>(allocationCount),
+		                       benchmark::Counter::kAvgIterations);
+	}
+
+	/**
+	 * Arguments: buffer size, channels and whether smoothing is enabled
+	 */
+	void processSignal(benchmark::State& state, Signal signal) {
+		const auto bufferSize = static_cast<size_t>(state.range(0));
+		const auto channels = static_cast<size_t>(state.range(1));
+		const bool smoothing = state.range(2);
+
+		Process process = createProcess(bufferSize, channels, smoothing);
+		AudioData audioData;
+		audioData.allocate(channels, bufferSize);
+		const auto samples = generateSignal(signal, channels, bufferSize);
+
+		const auto allocationsBefore = allocations.load();
+		for (auto _ : state) {
+			// processSignal works in place, so the samples are copied in as from the sampler
+			std::copy(samples.begin(), samples.end(), audioData.buffer);
+			process.processSignal(audioData);
+			benchmark::DoNotOptimize(audioData.lBuffer[0]);
+			benchmark::ClobberMemory();
+		}
+		setCounters(state, samples.size(), allocations.load() - allocationsBefore);
+	}
+
+	/**
+	 * Arguments: buffer size and channels, smoothing is always enabled
+	 */
+	void processStage(benchmark::State& state, Process::Stage stage) {
+		const auto bufferSize = static_cast<size_t>(state.range(0));
+		const auto channels = static_cast<size_t>(state.range(1));
+
+		Process process = createProcess(bufferSize, channels, true);
+		AudioData audioData;
+		audioData.allocate(channels, bufferSize);
+		const auto samples = generateSignal(Signal::noise, channels, bufferSize);
+
+		// give the later stages the input they would see in processSignal
+		std::copy(samples.begin(), samples.end(), audioData.buffer);
+		for (auto previous : {Process::Stage::window, Process::Stage::magnitudes}) {
+			if (previous >= stage) break;
+			process.processStage(audioData, previous);
+		}
+		// stages up to magnitudes modify the samples in place
+		const bool refill = stage <= Process::Stage::magnitudes;
+
+		const auto allocationsBefore = allocations.load();
+		for (auto _ : state) {
+			if (refill) std::copy(samples.begin(), samples.end(), audioData.buffer);
+			process.processStage(audioData, stage);
+			benchmark::DoNotOptimize(audioData.buffer[0]);
+			benchmark::DoNotOptimize(audioData.lBuffer[0]);
+			benchmark::ClobberMemory();
+		}
+		setCounters(state, samples.size(), allocations.load() - allocationsBefore);
+	}
+
+	const std::vector<int64_t> bufferSizes = benchmark::CreateRange(256, 65536, 4);
+}  // namespace
+
+BENCHMARK_CAPTURE(processSignal, silence, Signal::silence)
+    ->ArgsProduct({bufferSizes, {1, 2}, {0, 1}})
+    ->ArgNames({"bufferSize", "channels", "smoothing"});
+BENCHMARK_CAPTURE(processSignal, sine, Signal::sine)
+    ->ArgsProduct({bufferSizes, {1, 2}, {0, 1}})
+    ->ArgNames({"bufferSize", "channels", "smoothing"});
+BENCHMARK_CAPTURE(processSignal, noise, Signal::noise)
+    ->ArgsProduct({bufferSizes, {1, 2}, {0, 1}})
+    ->ArgNames({"bufferSize", "channels", "smoothing"});
+
+BENCHMARK_CAPTURE(processStage, window, Process::Stage::window)
+    ->ArgsProduct({bufferSizes, {1, 2}})
+    ->ArgNames({"bufferSize", "channels"});
+BENCHMARK_CAPTURE(processStage, fft, Process::Stage::fft)
+    ->ArgsProduct({bufferSizes, {1, 2}})
+    ->ArgNames({"bufferSize", "channels"});
+BENCHMARK_CAPTURE(processStage, magnitudes, Process::Stage::magnitudes)
+    ->ArgsProduct({bufferSizes, {1, 2}})
+    ->ArgNames({"bufferSize", "channels"});
+BENCHMARK_CAPTURE(processStage, equalise, Process::Stage::equalise)
+    ->ArgsProduct({bufferSizes, {1, 2}})
+    ->ArgNames({"bufferSize", "channels"});
+BENCHMARK_CAPTURE(processStage, volume, Process::Stage::volume)
+    ->ArgsProduct({bufferSizes, {1, 2}})
+    ->ArgNames({"bufferSize", "channels"});
+BENCHMARK_CAPTURE(processStage, smoothing, Process::Stage::smoothing)
+    ->ArgsProduct({bufferSizes, {1, 2}})
+    ->ArgNames({"bufferSize", "channels"});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * Places allocations within a block of memory of a fixed size. Offsets are aligned as requested
+ * and linear resources (buffers and linearly tiled images) never share a page of granularity
+ * bytes with non-linear ones (optimally tiled images), as bufferImageGranularity requires.
+ */
+class BlockAllocator {
+public:
+	enum class Strategy {
+		// first fit in any gap, including those left by freed allocations
+		freeList,
+		// only after the last allocation, for short lived allocations that are freed together
+		linear
+	};
+
+	struct Allocation {
+		uint64_t offset;
+		uint64_t size;
+		bool linear;
+	};
+
+	BlockAllocator() = default;
+	/**
+	 * Throws std::invalid_argument if granularity is not a power of two
+	 */
+	BlockAllocator(uint64_t blockSize, uint64_t granularity = 1,
+	               Strategy allocationStrategy = Strategy::freeList);
+
+	/**
+	 * Returns the offset of the allocation, or nothing if it does not fit. Throws
+	 * std::invalid_argument if size is zero or alignment is not a power of two.
+	 */
+	std::optional<uint64_t> allocate(uint64_t size, uint64_t alignment, bool linear);
+
+	/**
+	 * Throws std::invalid_argument if no allocation starts at offset
+	 */
+	void free(uint64_t offset);
+
+	uint64_t size() const { return blockSize; }
+	// bytes allocated, excluding padding
+	uint64_t used() const { return usedSize; }
+	size_t count() const { return allocations.size(); }
+	bool empty() const { return allocations.empty(); }
+	Strategy strategy() const { return allocationStrategy; }
+
+private:
+	uint64_t blockSize = 0;
+	uint64_t granularity = 1;
+	Strategy allocationStrategy = Strategy::freeList;
+	uint64_t usedSize = 0;
+
+	// sorted by offset
+	std::vector<Allocation> allocations;
+
+	std::optional<uint64_t> fit(size_t index, uint64_t size, uint64_t alignment,
+	                            bool linear) const;
+};
+
+#endif
@@ -2,6 +2,8 @@
 #ifndef AUDIO_HPP
 #define AUDIO_HPP
 
+#include <cstdint>
+#include <optional>
 #include <string>
 struct AudioData;
 
@@ -16,6 +18,18 @@ public:
 		std::string sinkName;
 	};
 
+	/**
+	 * Counters of capture problems since the sampler was created
+	 */
+	struct Stats {
+		// times the backend reported that it lost input because it was not read in time
+		uint64_t overruns = 0;
+		// gaps in the stream reported by the backend
+		uint64_t holes = 0;
+		// blocks replaced by a newer one before copyData was called
+		uint64_t droppedBlocks = 0;
+	};
+
 	AudioSampler() = default;
 	AudioSampler(const Settings& audioSettings);
 	~AudioSampler();
@@ -25,6 +39,13 @@ public:
 	bool running() const;
 	bool modified() const;
 	int ups() const;
+	Stats stats() const;
+
+	/**
+	 * Milliseconds from audio being captured until it is heard, if the backend can measure it.
+	 * The monitor of a sink runs ahead of its output by the latency of the sink.
+	 */
+	std::optional<double> playbackLatency() const;
 
 	void copyData(AudioData& audioData);
 
@@ -1,4 +1,92 @@
+#pragma once
+#ifndef CALCULATE_HPP
+#define CALCULATE_HPP
+
+#include <cstdint>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 template <class NumType>
 NumType calculate(std::string_view expression);
+
+/**
+ * Evaluates expression with the names in variables replaced by their values
+ */
+template <class NumType>
+NumType calculate(std::string_view expression,
+                  const std::unordered_map<std::string, float>& variables);
+
+/**
+ * An expression compiled once into bytecode so that it can be evaluated cheaply many times,
+ * e.g. once per frame with new variable values. Constant subexpressions are folded.
+ */
+class Expression {
+public:
+	Expression() = default;
+
+	/**
+	 * Throws std::invalid_argument if expression is invalid or refers to a name that is neither
+	 * a constant nor one of variables
+	 */
+	Expression(std::string_view expression, const std::vector<std::string>& variables = {});
+
+	/**
+	 * variables holds the values of the variables in the order their names were given
+	 */
+	float evaluate(const float* variables = nullptr) const;
+
+	/**
+	 * Evaluates the expression count times, the ith result with the ith value of every
+	 * variable. variables[v] points to the count values of the vth variable. The values are
+	 * processed in blocks of laneCount so that each instruction becomes a vectorisable loop.
+	 */
+	void evaluate(const float* const* variables, float* results, size_t count) const;
+
+	// whether the expression does not depend on any variable
+	bool constant() const;
+
+	// number of instructions after constant folding
+	size_t size() const { return code.size(); }
+
+	struct Instruction {
+		enum class Op : uint8_t {
+			eConstant,
+			eVariable,
+			eAdd,
+			eSubtract,
+			eMultiply,
+			eDivide,
+			eModulo,
+			ePower,
+			eNegate,
+			eSin,
+			eCos,
+			eTan,
+			eLog,
+			eLog10,
+			eExp,
+			eSqrt,
+			eAbs,
+			eMax,
+			eMin
+		};
+
+		Op op;
+		union {
+			float value;
+			uint32_t variable;
+		};
+	};
+
+	// deepest the operand stack can get during evaluation
+	static constexpr size_t maxDepth = 32;
+	// values evaluated at once by the batch evaluation
+	static constexpr size_t laneCount = 8;
+
+private:
+	std::vector<Instruction> code;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+#ifndef CONTROL_HPP
+#define CONTROL_HPP
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * A single request received through the control socket.
+ * Requests are newline terminated and take one of the following forms:
+ * 	modules {"MODULE", ...}
+ * 	set "MODULE" PARAMETER VALUE
+ * 	amplitude VALUE
+ * 	smoothingLevel VALUE
+ * 	stats
+ */
+struct ControlCommand {
+	enum class Type { modules, set, amplitude, smoothingLevel, stats };
+
+	Type type;
+
+	std::vector<std::string> modules;
+
+	std::string module;
+	std::string parameter;
+
+	float value = 0.f;
+};
+
+/**
+ * Throws std::invalid_argument if line is not a valid command
+ */
+ControlCommand parseControlCommand(std::string_view line);
+
+class ControlServer {
+public:
+	struct Settings {
+		std::filesystem::path socketPath;
+	};
+
+	ControlServer() = default;
+	ControlServer(const Settings& serverSettings);
+	~ControlServer();
+
+	ControlServer& operator=(ControlServer&& other) noexcept;
+
+	/**
+	 * Answers all pending requests by calling handler on the calling thread.
+	 * handler returns the reply sent back to the client.
+	 */
+	void poll(const std::function<std::string(const ControlCommand&)>& handler);
+
+	static std::filesystem::path defaultSocketPath();
+
+	static bool supported();
+
+private:
+	class ControlServerImpl;
+	ControlServerImpl* impl = nullptr;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+#ifndef FUSION_HPP
+#define FUSION_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * A module whose fragment shader is merged into a fused shader.
+ * Fusable fragment shaders must wrap the declarations shared by all modules
+ * (constants 0 to 5, set 0 and outColor) in #ifndef VKAV_FUSED, and may only declare
+ * their parameters, their entry point and uniquely named helpers at file scope. Included files
+ * are compiled without the module's renamed names, so they must not refer to its parameters.
+ */
+struct FusedModule {
+	std::filesystem::path fragmentShader;
+	// name of the function writing outColor
+	std::string entryPoint = "main";
+	// parameter names are prefixed in order to avoid collisions between modules
+	std::vector<std::string> parameterNames;
+	// added to every constant id of 6 or above
+	uint32_t constantIdOffset = 0;
+};
+
+/**
+ * Returns the source of a fragment shader that calls the entry point of every module in order
+ * and blends the results in registers, matching the alpha blending used between separate
+ * draws onto a cleared attachment.
+ */
+std::string generateFusedShader(const std::vector<FusedModule>& modules);
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef GOVERNOR_HPP
+#define GOVERNOR_HPP
+
+#include <cstdint>
+
+/**
+ * Steps quality down while frames take longer than a budget and back up once they leave enough
+ * headroom. Frame times are averaged over windows of frames, and stepping up waits for several
+ * windows in a row, waiting longer every time a step up has to be undone straight away.
+ */
+class Governor {
+public:
+	struct Settings {
+		// milliseconds a frame may take
+		double frameBudget = 0.0;
+		// quality levels below the highest one
+		uint32_t levels = 3;
+		// frames averaged for every decision
+		uint32_t window = 30;
+		// fraction of the budget the average must stay below to step up
+		double headroom = 0.6;
+		// windows below the headroom needed to step up
+		uint32_t stepUpWindows = 3;
+		// limit of stepUpWindows as it doubles
+		uint32_t maxStepUpWindows = 48;
+	};
+
+	Governor() = default;
+	/**
+	 * Throws std::invalid_argument if the budget is not positive, the window is empty or the
+	 * headroom is not between 0 and 1
+	 */
+	Governor(const Settings& governorSettings);
+
+	/**
+	 * Adds the time of a frame in milliseconds, returns true if the level changed
+	 */
+	bool addFrame(double frameTime);
+
+	// 0 is the highest quality, settings.levels the lowest
+	uint32_t level() const { return currentLevel; }
+	// 1 at the highest quality level, halved by every level below it
+	float quality() const;
+	// average frame time of the last complete window
+	double average() const { return lastAverage; }
+
+private:
+	Settings settings;
+
+	uint32_t currentLevel = 0;
+	double frameTimes = 0.0;
+	uint32_t frames = 0;
+	double lastAverage = 0.0;
+
+	uint32_t stepUpWindows = 0;
+	uint32_t windowsBelowHeadroom = 0;
+	// windows since the last step up, to tell whether a step down undoes it
+	uint32_t windowsSinceStepUp = 0;
+	// the window after a change is skipped while the new level settles
+	bool settling = false;
+};
+
+#endif
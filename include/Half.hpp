@@ -0,0 +1,72 @@
+#pragma once
+#ifndef HALF_HPP
+#define HALF_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Converts to IEEE 754 half precision, rounding to the nearest even value. Values too large
+ * for a half become infinity and NaNs stay NaNs.
+ */
+inline uint16_t floatToHalf(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const uint16_t sign = (bits >> 16) & 0x8000;
+	bits &= 0x7fffffff;
+
+	// at least 65536, rounds to infinity
+	if (bits >= 0x47800000) return sign | (bits > 0x7f800000 ? 0x7e00 : 0x7c00);
+
+	// below the smallest normal half, let the float addition round the subnormal
+	if (bits < 0x38800000) {
+		constexpr uint32_t magicBits = 126u << 23;
+		float magic, sum;
+		std::memcpy(&magic, &magicBits, sizeof(magic));
+		std::memcpy(&sum, &bits, sizeof(sum));
+		sum += magic;
+		std::memcpy(&bits, &sum, sizeof(bits));
+		return sign | static_cast<uint16_t>(bits - magicBits);
+	}
+
+	const uint32_t mantissaOdd = (bits >> 13) & 1;
+	// rebias the exponent and round the dropped mantissa bits
+	bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff + mantissaOdd;
+	return sign | static_cast<uint16_t>(bits >> 13);
+}
+
+inline float halfToFloat(uint16_t half) {
+	constexpr uint32_t exponentMask = 0x7c00u << 13;
+	uint32_t bits = (half & 0x7fffu) << 13;
+	const uint32_t exponent = bits & exponentMask;
+	bits += static_cast<uint32_t>(127 - 15) << 23;
+
+	if (exponent == exponentMask) {
+		// infinity or NaN
+		bits += static_cast<uint32_t>(128 - 16) << 23;
+	} else if (exponent == 0) {
+		// subnormal, renormalise with a float subtraction
+		constexpr uint32_t magicBits = 113u << 23;
+		float magic, value;
+		bits += 1u << 23;
+		std::memcpy(&magic, &magicBits, sizeof(magic));
+		std::memcpy(&value, &bits, sizeof(value));
+		value -= magic;
+		std::memcpy(&bits, &value, sizeof(bits));
+	}
+
+	bits |= static_cast<uint32_t>(half & 0x8000u) << 16;
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/**
+ * Converts count values of first and second to halves and interleaves them, first in the low
+ * half of every element of packed. Uses F16C when the CPU supports it, with the same rounding as
+ * floatToHalf.
+ */
+void packHalf2(const float* first, const float* second, uint32_t* packed, size_t count);
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef MESH_HPP
+#define MESH_HPP
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <vector>
+
+/**
+ * Indexed triangle list, read by vertex shaders as a vec3 position at location 0 and a vec3
+ * normal at location 1
+ */
+struct Mesh {
+	struct Vertex {
+		std::array<float, 3> position;
+		std::array<float, 3> normal;
+	};
+
+	std::vector<Vertex> vertices;
+	// three per triangle
+	std::vector<uint32_t> indices;
+};
+
+/**
+ * Reads the vertices, normals and faces of a Wavefront OBJ file. Polygons are split into
+ * triangle fans and vertices without a normal get the average normal of their faces.
+ * Throws std::invalid_argument if the file is malformed.
+ */
+Mesh parseObj(std::istream& stream);
+
+/**
+ * Reads the binary format written by writeMesh.
+ * Throws std::invalid_argument if the data is malformed.
+ */
+Mesh readMesh(std::istream& stream);
+
+/**
+ * Writes the mesh in a compact binary format that can be loaded without any parsing: a header
+ * followed by the vertex and index arrays as stored in memory.
+ */
+void writeMesh(std::ostream& stream, const Mesh& mesh);
+
+/**
+ * Loads an OBJ file if its extension is .obj, the binary format otherwise.
+ * Throws std::runtime_error if the file cannot be read or is malformed.
+ */
+Mesh loadMesh(const std::filesystem::path& path);
+
+#endif
@@ -1,7 +1,11 @@
+#include <algorithm>
+#include <array>
 #include <iosfwd>
+#include <limits>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
@@ -26,20 +30,137 @@ public:
 struct ModuleConfig {
 	struct Parameter {
 		uint32_t id;
+		std::string name;
 		std::variant<uint32_t, int32_t, float> value;
+		// dynamic parameters are stored in a uniform buffer instead of a specialization constant
+		// so that they can be changed without recreating the pipelines
+		bool dynamic = false;
+		// re-evaluated every frame if not empty, only dynamic parameters may refer to the
+		// frame variables
+		std::string expression;
 	};
 
+	// variables that the expressions of dynamic parameters can refer to
+	static inline const std::vector<std::string> frameVariables = {
+	    "time", "volume", "lVolume", "rVolume", "low", "mid", "high", "quality"};
+	// index of the quality level in frameVariables
+	static inline const size_t qualityVariable = static_cast<size_t>(
+	    std::find(frameVariables.begin(), frameVariables.end(), "quality") -
+	    frameVariables.begin());
+
+	/**
+	 * Values of the frame variables before the first frame, all zero but the full quality of 1
+	 */
+	static std::vector<float> initialFrameVariables();
+
 	struct Resource {
 		uint32_t id;
 		std::string path;
 	};
 
+	// zero initialized and persistent across frames, writable from compute layers
+	struct StorageBuffer {
+		uint32_t id;
+		// in bytes
+		uint64_t size;
+	};
+
+	struct StorageImage {
+		uint32_t id;
+		// width and height, expressions that may refer to the width and height of the window
+		std::array<std::string, 2> size;
+	};
+
+	// offscreen image that layers can draw to and sample
+	struct Target {
+		uint32_t id;
+		std::string name;
+		// width and height, expressions that may refer to the width and height of the window
+		std::array<std::string, 2> size;
+	};
+
+	// read only values, listed inline or loaded from a file
+	struct Table {
+		uint32_t id;
+		std::vector<float> values;
+		// file the values are read from if not empty
+		std::string path;
+	};
+
+	// vertex and index data drawn by the layers that list it as an input
+	struct Mesh {
+		uint32_t id;
+		std::string name;
+		// an OBJ file or a mesh in the binary format
+		std::string path;
+	};
+
+	// declared as `layer.N = INPUT, ... -> OUTPUT`
+	struct Layer {
+		// number of the layer directory
+		uint32_t layer;
+		// names of the targets sampled by the layer, or of the mesh drawn by it
+		std::vector<std::string> inputs;
+		// name of the target drawn to, the window if empty
+		std::string output;
+	};
+
 	std::optional<std::string> moduleName;
 	std::optional<uint32_t> vertexCount;
+	// number of instances of the vertices to draw, an expression that may refer to the width
+	// and height of the window and to parameters that are not dynamic
+	std::optional<std::string> instanceCount;
+	// binding within the module descriptor set used for the dynamic parameter uniform buffer
+	std::optional<uint32_t> parameterBinding;
+	// whether the module can be merged with neighbouring modules into a single shader
+	bool fusable = false;
+	// whether the module reads the spectrum from the packed half precision stereoBuffer instead
+	// of lBuffer and rBuffer
+	bool packedSpectrum = false;
+	// whether the module samples the linearly filtered and mipmapped spectrumImage
+	bool spectrumImage = false;
+	// x, y, width and height of the area the module draws to, in pixels from the top left corner.
+	// Each is an expression that may refer to the width and height of the window.
+	std::optional<std::array<std::string, 4>> bounds;
+	// number of work groups dispatched for every compute layer, expressions like bounds
+	std::optional<std::array<std::string, 3>> workGroups;
+
+	std::vector<Layer> layers;
 
 	std::vector<Parameter> params;
 
 	std::vector<Resource> images;
+	std::vector<StorageBuffer> storageBuffers;
+	std::vector<StorageImage> storageImages;
+	std::vector<Target> targets;
+	std::vector<Mesh> meshes;
+	// bound as texel buffers of floats
+	std::vector<Table> buffers;
+	// bound as linearly filtered 1D images of RGBA texels, four values per texel
+	std::vector<Table> luts;
 };
 
+/**
+ * Converts a parameter value that is not NaN to the type T of a parameter, integer types are
+ * saturated instead of overflowing
+ */
+template <typename T>
+T convertParameter(float value) {
+	if constexpr (std::is_integral_v<T>) {
+		// both limits are exactly representable as doubles, unlike as floats
+		if (value <= static_cast<double>(std::numeric_limits<T>::min()))
+			return std::numeric_limits<T>::min();
+		if (value >= static_cast<double>(std::numeric_limits<T>::max()))
+			return std::numeric_limits<T>::max();
+	}
+	return static_cast<T>(value);
+}
+
 ModuleConfig parseConfig(std::istream& stream);
+
+/**
+ * Reads constant expressions separated by commas, which may contain spaces, e.g. "1, 2 * 3".
+ * A list may span several lines and '#' comments are ignored.
+ * Throws std::invalid_argument if an expression cannot be evaluated.
+ */
+std::vector<float> parseValues(std::istream& stream);
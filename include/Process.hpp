@@ -2,6 +2,9 @@
 #ifndef SIGNAL_FUNCTIONS_HPP
 #define SIGNAL_FUNCTIONS_HPP
 
+#include <cstddef>
+#include <string>
+
 struct AudioData;
 
 class Process {
@@ -11,8 +14,15 @@ public:
 		float smoothingLevel;
 		float amplitude;
 		unsigned char channels;
+		unsigned int sampleRate;
+		// gain of every frequency bin as an expression of its index n and frequency f in Hz,
+		// applied on top of the default weighting
+		std::string equaliser = "1";
 	};
 
+	// the steps of processSignal in the order they are performed
+	enum class Stage { window, fft, magnitudes, equalise, volume, smoothing };
+
 	Process() = default;
 	Process(const Settings& settings);
 	~Process();
@@ -21,6 +31,12 @@ public:
 
 	void processSignal(AudioData& audio);
 
+	/**
+	 * Performs a single stage of processSignal, so that each can be measured on its own.
+	 * The fft stage only transforms the buffer in place, magnitudes includes the fft.
+	 */
+	void processStage(AudioData& audio, Stage stage);
+
 private:
 	class ProcessImpl;
 	ProcessImpl* impl = nullptr;
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef RECORDING_HPP
+#define RECORDING_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+struct AudioData;
+
+/**
+ * Appends processed AudioData to a recording file: a header followed by one fixed size record
+ * per update holding its timestamp, the volumes and audioSize values of lBuffer and rBuffer.
+ */
+class RecordingWriter {
+public:
+	RecordingWriter() = default;
+
+	/**
+	 * Truncates path. Throws std::runtime_error if it cannot be opened for writing.
+	 */
+	RecordingWriter(const std::filesystem::path& path, size_t audioSize);
+
+	bool isOpen() const { return file.is_open(); }
+
+	/**
+	 * timestamp is the time since the start of the recording.
+	 * Throws std::runtime_error if the record cannot be written.
+	 */
+	void write(const AudioData& audioData, std::chrono::nanoseconds timestamp);
+
+private:
+	std::ofstream file;
+	size_t audioSize = 0;
+};
+
+/**
+ * A recording written by RecordingWriter, memory mapped so that any record can be read without
+ * parsing. A truncated last record, e.g. from a recording that was killed, is ignored.
+ */
+class Recording {
+public:
+	Recording() = default;
+
+	/**
+	 * Throws std::runtime_error if path cannot be read or is not a recording
+	 */
+	explicit Recording(const std::filesystem::path& path);
+	~Recording();
+
+	Recording(Recording&& other) noexcept;
+	Recording& operator=(Recording&& other) noexcept;
+
+	// number of records
+	size_t size() const { return recordCount; }
+	size_t audioSize() const { return valueCount; }
+
+	std::chrono::nanoseconds timestamp(size_t record) const;
+
+	/**
+	 * Index of the last record with a timestamp no later than timestamp, or 0 if there is none
+	 */
+	size_t find(std::chrono::nanoseconds timestamp) const;
+
+	/**
+	 * Copies a record into audioData, whose lBuffer and rBuffer must hold audioSize values
+	 */
+	void copyRecord(size_t record, AudioData& audioData) const;
+
+private:
+	const std::byte* data = nullptr;
+	size_t dataSize = 0;
+	// holds the file where it cannot be mapped
+	std::vector<std::byte> contents;
+
+	// values per channel in every record
+	size_t valueCount = 0;
+	size_t recordCount = 0;
+
+	const std::byte* recordData(size_t record) const;
+	void unmap();
+};
+
+#endif
@@ -37,19 +37,79 @@ public:
 		std::vector<std::filesystem::path> moduleLocations;
 		std::vector<std::filesystem::path> modules = {1, "bars"};
 		std::filesystem::path backgroundImage;
+		std::filesystem::path shaderCacheLocation;
+		// draw leading fusable modules in a single pass
+		bool fuseModules = true;
+		// levels of the spectrumImage, each averaging pairs of values of the previous one
+		uint32_t spectrumMipLevels = 1;
 
 		std::optional<uint32_t> physicalDevice;
 
 		bool vsync;
+
+		// render offscreen at the window size without creating a window, nothing is presented
+		bool headless = false;
 	};
 
 	Renderer() = default;
 	Renderer(const Settings& renderSettings);
+
+	/**
+	 * Whether there is a Vulkan device with a graphics queue, without creating a window
+	 */
+	static bool deviceAvailable();
 	~Renderer();
 
 	Renderer& operator=(Renderer&& other) noexcept;
 
 	bool drawFrame(const AudioData& audioData);
+
+	/**
+	 * Average GPU time in milliseconds of the frames completed since the last call, measured
+	 * with timestamp queries, on devices supporting them.
+	 */
+	std::optional<double> frameTime();
+
+	/**
+	 * Name of the physical device drawing the frames
+	 */
+	std::string deviceName() const;
+
+	/**
+	 * Estimated milliseconds from the start of a frame until it is shown, from the present mode
+	 * and the average time between frames. Nothing is shown in headless mode.
+	 */
+	std::optional<double> presentLatency() const;
+
+	/**
+	 * Sets the quality frame variable, which dynamic module parameters can scale with to draw
+	 * cheaper frames. 1 is the highest quality.
+	 */
+	void setQuality(float quality);
+
+	/**
+	 * Average time in milliseconds spent uploading audio data to the GPU for the frames drawn
+	 * since the last call
+	 */
+	double uploadTime();
+
+	/**
+	 * Loads the given modules in the background and switches to them at the start of the
+	 * first frame after they are ready. The current modules are kept if loading fails.
+	 */
+	void setModules(const std::vector<std::filesystem::path>& modules);
+
+	/**
+	 * Rebuilds the module pipelines in the background using the new smoothing level
+	 */
+	void setSmoothingLevel(float smoothingLevel);
+
+	/**
+	 * Updates a dynamic module parameter, returns false if no such parameter exists.
+	 * The new value is used from the next frame without recreating any pipelines, integer
+	 * parameters are clamped to the range of their type. Throws std::invalid_argument for NaN.
+	 */
+	bool setParameter(const std::string& module, const std::string& parameter, float value);
 private:
 	class RendererImpl;
 	RendererImpl* rendererImpl = nullptr;
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef RENDER_GRAPH_HPP
+#define RENDER_GRAPH_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * A graphics layer of a module and the offscreen targets it uses
+ */
+struct RenderGraphLayer {
+	// targets sampled by the layer
+	std::vector<uint32_t> inputs;
+	// target drawn to by the layer, the window if unset
+	std::optional<uint32_t> output;
+};
+
+struct RenderGraphPass {
+	uint32_t layer;
+	uint32_t target;
+	// false if an earlier pass of the same frame already drew to the target
+	bool clear;
+};
+
+struct RenderGraph {
+	// offscreen passes in the order they are recorded, all of them before the window pass
+	std::vector<RenderGraphPass> passes;
+	// layers drawn to the window in order
+	std::vector<uint32_t> windowLayers;
+
+	// memory block of every target, targets that are never in use at the same time share one
+	std::vector<uint32_t> memoryBlocks;
+	uint32_t memoryBlockCount = 0;
+};
+
+/**
+ * Orders the layers into passes and assigns targets to memory blocks.
+ * Throws std::invalid_argument if a layer samples a target that no earlier layer draws to,
+ * or samples the target it draws to.
+ */
+RenderGraph compileRenderGraph(const std::vector<RenderGraphLayer>& layers, uint32_t targetCount);
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef SHADER_COMPILER_HPP
+#define SHADER_COMPILER_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+class ShaderCompiler {
+public:
+	enum class Stage { vertex, fragment, compute };
+
+	struct Settings {
+		// directory used to store compiled SPIR-V, caching is disabled if empty
+		std::filesystem::path cacheLocation;
+	};
+
+	ShaderCompiler() = default;
+	ShaderCompiler(const Settings& compilerSettings);
+	~ShaderCompiler();
+
+	ShaderCompiler& operator=(ShaderCompiler&& other) noexcept;
+
+	/**
+	 * Returns the SPIR-V for the shader stage located in directory.
+	 * GLSL sources are compiled and cached by content hash when runtime compilation
+	 * is available, otherwise the prebuilt SPIR-V binary is used.
+	 */
+	std::vector<char> load(const std::filesystem::path& directory, Stage stage);
+
+	/**
+	 * Compiles GLSL source held in memory, caching the result like load.
+	 * Relative includes are resolved against the directory of sourcePath.
+	 */
+	std::vector<char> compile(const std::string& source, const std::filesystem::path& sourcePath,
+	                          Stage stage);
+
+	static bool hasShader(const std::filesystem::path& directory, Stage stage);
+
+	static bool supported();
+
+private:
+	class ShaderCompilerImpl;
+	ShaderCompilerImpl* impl = nullptr;
+};
+
+/**
+ * Hashes the GLSL source file together with every file it #includes
+ */
+uint64_t hashShaderSource(const std::filesystem::path& sourcePath);
+
+/**
+ * Returns the descriptor set and binding of every resource declared by a SPIR-V module.
+ * Throws std::invalid_argument if spirv is not a SPIR-V module.
+ */
+std::vector<std::pair<uint32_t, uint32_t>> descriptorBindings(const std::vector<char>& spirv);
+
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+#ifndef SHARED_SPECTRUM_HPP
+#define SHARED_SPECTRUM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct AudioData;
+
+/**
+ * Processed spectra published in a POSIX shared memory object, so that other local processes
+ * can read the latest analysis without capturing or processing audio themselves.
+ *
+ * The object starts with a SharedSpectrumHeader followed by slotCount slots of slotSize bytes.
+ * Update n (counting from 1) is written to slot n % slotCount as a SharedSpectrumSlot followed
+ * by audioSize floats of the left channel and audioSize floats of the right channel. Every slot
+ * is a seqlock: its sequence is 2n - 1 while update n is written and 2n once it is complete.
+ * A reader loads latest, copies slot latest % slotCount if its sequence is 2 * latest and
+ * keeps the copy if the sequence is unchanged afterwards.
+ */
+struct SharedSpectrumHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t audioSize;
+	uint32_t slotCount;
+	uint32_t slotSize;
+	// number of the newest complete update, 0 before the first
+	std::atomic<uint64_t> latest;
+	// set once the writer is gone
+	std::atomic<uint32_t> closed;
+	// process id of the writer
+	int64_t owner;
+};
+
+struct SharedSpectrumSlot {
+	std::atomic<uint64_t> sequence;
+	// steady clock (CLOCK_MONOTONIC on Linux) nanoseconds of when the update was published
+	int64_t timestamp;
+	float lVolume;
+	float rVolume;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "atomics in shared memory must be lock free");
+
+/**
+ * Creates the shared memory object name and removes it again when destroyed. An existing object
+ * is only replaced if its writer has closed it or is no longer running. Throws
+ * std::runtime_error if the name is in use, the object cannot be created or shared memory is
+ * unsupported.
+ */
+class SharedSpectrumWriter {
+public:
+	SharedSpectrumWriter() = default;
+	SharedSpectrumWriter(const std::string& name, size_t audioSize);
+	~SharedSpectrumWriter();
+
+	SharedSpectrumWriter(SharedSpectrumWriter&& other) noexcept;
+	SharedSpectrumWriter& operator=(SharedSpectrumWriter&& other) noexcept;
+
+	bool isOpen() const { return header; }
+
+	void publish(const AudioData& audioData, std::chrono::steady_clock::time_point timestamp);
+
+	static constexpr uint32_t slotCount = 8;
+
+private:
+	std::string name;
+	SharedSpectrumHeader* header = nullptr;
+	size_t mappingSize = 0;
+	uint64_t published = 0;
+};
+
+/**
+ * Attaches to the shared memory object of a SharedSpectrumWriter.
+ * Throws std::runtime_error if it does not exist or is not a shared spectrum.
+ */
+class SharedSpectrumReader {
+public:
+	SharedSpectrumReader() = default;
+	explicit SharedSpectrumReader(const std::string& name);
+	~SharedSpectrumReader();
+
+	SharedSpectrumReader(SharedSpectrumReader&& other) noexcept;
+	SharedSpectrumReader& operator=(SharedSpectrumReader&& other) noexcept;
+
+	size_t audioSize() const;
+	// whether the writer has removed the object
+	bool closed() const;
+
+	/**
+	 * Copies the newest update into audioData, whose lBuffer and rBuffer must hold audioSize
+	 * values. Returns false if there has been no new update since the last call.
+	 */
+	bool read(AudioData& audioData);
+
+	// number and publication time of the update read last
+	uint64_t sequence() const { return lastRead; }
+	std::chrono::steady_clock::time_point timestamp() const { return lastTimestamp; }
+
+private:
+	const SharedSpectrumHeader* header = nullptr;
+	size_t mappingSize = 0;
+	uint64_t lastRead = 0;
+	std::chrono::steady_clock::time_point lastTimestamp;
+};
+
+#endif
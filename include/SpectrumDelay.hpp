@@ -0,0 +1,52 @@
+#pragma once
+#ifndef SPECTRUM_DELAY_HPP
+#define SPECTRUM_DELAY_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+struct AudioData;
+
+/**
+ * Holds processed spectra back, so that they can be drawn when the audio they were analysed from
+ * is heard rather than when it was captured. Spectra are kept with their timestamps in a ring of
+ * a fixed capacity, once it is full the oldest one is dropped for every new one.
+ */
+class SpectrumDelay {
+public:
+	SpectrumDelay() = default;
+	/**
+	 * Throws std::invalid_argument if capacity is zero
+	 */
+	SpectrumDelay(size_t audioSize, size_t capacity);
+
+	/**
+	 * Copies audioSize values of both channels and the volumes of audioData
+	 */
+	void push(const AudioData& audioData, std::chrono::steady_clock::time_point timestamp);
+
+	/**
+	 * Copies the newest spectrum pushed at or before time into audioData and drops it along with
+	 * every older one. Returns false if no spectrum is that old.
+	 */
+	bool pop(AudioData& audioData, std::chrono::steady_clock::time_point time);
+
+	void clear() { count = 0; }
+
+	size_t size() const { return count; }
+	size_t capacity() const { return timestamps.size(); }
+
+private:
+	size_t audioSize = 0;
+
+	// capacity spectra of audioSize left values followed by audioSize right values
+	std::vector<float> spectra;
+	std::vector<float> volumes;
+	std::vector<std::chrono::steady_clock::time_point> timestamps;
+	// index of the oldest spectrum
+	size_t first = 0;
+	size_t count = 0;
+};
+
+#endif
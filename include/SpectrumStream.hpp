@@ -0,0 +1,136 @@
+#pragma once
+#ifndef SPECTRUM_STREAM_HPP
+#define SPECTRUM_STREAM_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct AudioData;
+
+/**
+ * How the values of a spectrum are sent: as half precision floats, or as one byte each on a
+ * logarithmic scale from logFloor to logCeiling (about 2.4% steps, 0 for anything quieter).
+ */
+enum class SpectrumEncoding : uint8_t { fp16, log8 };
+
+/**
+ * One update of a spectrum reduced to bands values per channel.
+ *
+ * Its datagram is little endian: the magic "VKSS", version (u8), encoding (u8), band count
+ * (u16), sequence (u32), timestamp in nanoseconds of the sender's steady clock (i64), lVolume
+ * and rVolume (f32), then the encoded values of the left channel followed by the right one.
+ */
+struct SpectrumPacket {
+	uint32_t sequence = 0;
+	int64_t timestamp = 0;
+	float lVolume = 0.f;
+	float rVolume = 0.f;
+	std::vector<float> left;
+	std::vector<float> right;
+
+	static constexpr float logFloor = 1e-4f;
+	static constexpr float logCeiling = 16.f;
+
+	// largest datagram that fits a 1500 byte ethernet frame
+	static constexpr size_t maxDatagramSize = 1472;
+	static constexpr size_t headerSize = 28;
+
+	static size_t maxBands(SpectrumEncoding encoding);
+};
+
+void encodeSpectrumPacket(const SpectrumPacket& packet, SpectrumEncoding encoding,
+                          std::vector<uint8_t>& datagram);
+
+/**
+ * Throws std::invalid_argument if the datagram is not a valid packet
+ */
+void decodeSpectrumPacket(const uint8_t* datagram, size_t size, SpectrumPacket& packet);
+
+/**
+ * Sends every update given to it as a single UDP datagram to a unicast or multicast address
+ */
+class SpectrumSender {
+public:
+	struct Settings {
+		// HOST:PORT, HOST can be a multicast group
+		std::string destination;
+		SpectrumEncoding encoding = SpectrumEncoding::fp16;
+		// values per channel sent, the spectrum is averaged down to this many bands
+		size_t bands = 256;
+		// values per channel of the spectra sent
+		size_t audioSize = 0;
+		// routers a multicast datagram may cross
+		int multicastTtl = 1;
+	};
+
+	SpectrumSender() = default;
+	/**
+	 * Throws std::invalid_argument if the settings are invalid and std::runtime_error if the
+	 * socket cannot be created or networking is unsupported
+	 */
+	SpectrumSender(const Settings& senderSettings);
+	~SpectrumSender();
+
+	SpectrumSender& operator=(SpectrumSender&& other) noexcept;
+
+	bool isOpen() const { return impl; }
+
+	void send(const AudioData& audioData, std::chrono::steady_clock::time_point timestamp);
+
+private:
+	class SpectrumSenderImpl;
+	SpectrumSenderImpl* impl = nullptr;
+};
+
+/**
+ * Receives the datagrams of a SpectrumSender without blocking
+ */
+class SpectrumReceiver {
+public:
+	struct Settings {
+		// PORT, GROUP:PORT to join a multicast group or ADDRESS:PORT to only listen on ADDRESS
+		std::string source;
+		// values per channel written to AudioData, interpolated from the bands received
+		size_t audioSize = 0;
+	};
+
+	struct Stats {
+		uint64_t received = 0;
+		// datagrams skipped in the sequence
+		uint64_t lost = 0;
+		// datagrams arriving after a newer one, which are ignored
+		uint64_t late = 0;
+		uint64_t invalid = 0;
+	};
+
+	SpectrumReceiver() = default;
+	/**
+	 * Throws std::invalid_argument if the source is invalid and std::runtime_error if the
+	 * socket cannot be bound or networking is unsupported
+	 */
+	SpectrumReceiver(const Settings& receiverSettings);
+	~SpectrumReceiver();
+
+	SpectrumReceiver& operator=(SpectrumReceiver&& other) noexcept;
+
+	/**
+	 * Reads all pending datagrams and copies the newest update into audioData, whose lBuffer
+	 * and rBuffer must hold audioSize values. Returns false if there was no newer update.
+	 */
+	bool receive(AudioData& audioData);
+
+	// the local port, useful when binding port 0
+	uint16_t port() const;
+	Stats stats() const;
+	// the packet copied last
+	const SpectrumPacket& packet() const;
+
+private:
+	class SpectrumReceiverImpl;
+	SpectrumReceiverImpl* impl = nullptr;
+};
+
+#endif
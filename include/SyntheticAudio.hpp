@@ -0,0 +1,53 @@
+#pragma once
+#ifndef SYNTHETIC_AUDIO_HPP
+#define SYNTHETIC_AUDIO_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Audio.hpp"
+
+struct AudioData;
+
+/**
+ * Stands in for AudioSampler without any audio device. Produces a deterministic chord with a
+ * sweeping fundamental and a little noise, in blocks of sampleSize samples arriving at
+ * sampleRate in real time, so that the rest of the pipeline sees the same load as when
+ * capturing.
+ */
+class SyntheticAudio {
+public:
+	SyntheticAudio() = default;
+	SyntheticAudio(const AudioSampler::Settings& audioSettings);
+
+	// whether a block is due that has not been copied yet
+	bool modified() const;
+	int ups() const { return updatesPerSecond; }
+
+	/**
+	 * Generates the blocks due since the last call and copies the latest bufferSize samples
+	 */
+	void copyData(AudioData& audioData);
+
+private:
+	AudioSampler::Settings settings;
+
+	std::chrono::steady_clock::time_point start;
+	// index of the next frame (one sample per channel) to generate
+	uint64_t nextFrame = 0;
+	// interleaved ring of the latest bufferSize frames
+	std::vector<float> ring;
+	size_t ringPosition = 0;
+	uint32_t noiseState = 1;
+
+	// blocks generated per second
+	int updatesPerSecond = 0;
+	int updates = 0;
+	std::chrono::steady_clock::time_point lastUpdate;
+
+	uint64_t dueFrames() const;
+	float sample(uint64_t frame, size_t channel);
+};
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+/**
+ * Starts recording the spans of every TraceScope, from any thread, until stopTrace writes them
+ * to path in the Chrome trace event format, viewable in chrome://tracing or Perfetto.
+ * Throws std::runtime_error if path cannot be opened for writing.
+ */
+void startTrace(const std::filesystem::path& path);
+
+/**
+ * Writes the recorded spans and stops recording. Does nothing if no trace was started.
+ */
+void stopTrace();
+
+extern std::atomic<bool> tracing;
+
+/**
+ * Records the time between its construction and destruction as a span named name, which must
+ * outlive the trace. Costs a single relaxed load while no trace is being recorded.
+ */
+class TraceScope {
+public:
+	explicit TraceScope(const char* name)
+	    : name(tracing.load(std::memory_order_relaxed) ? name : nullptr) {
+		if (this->name) start = std::chrono::steady_clock::now();
+	}
+
+	~TraceScope() {
+		if (name) record(name, start, std::chrono::steady_clock::now());
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* name;
+	std::chrono::steady_clock::time_point start;
+
+	static void record(const char* name, std::chrono::steady_clock::time_point start,
+	                   std::chrono::steady_clock::time_point end);
+};
+
+#define TRACE_CONCAT_HELPER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_HELPER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#endif
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "Allocator.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	bool isPowerOfTwo(uint64_t value) { return value && !(value & (value - 1)); }
+
+	uint64_t alignUp(uint64_t value, uint64_t alignment) {
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	bool samePage(uint64_t first, uint64_t second, uint64_t granularity) {
+		return (first & ~(granularity - 1)) == (second & ~(granularity - 1));
+	}
+}  // namespace
+
+BlockAllocator::BlockAllocator(uint64_t blockSize, uint64_t granularity,
+                               Strategy allocationStrategy)
+    : blockSize(blockSize), granularity(granularity), allocationStrategy(allocationStrategy) {
+	if (!isPowerOfTwo(granularity))
+		throw std::invalid_argument(LOCATION "granularity must be a power of two!");
+}
+
+std::optional<uint64_t> BlockAllocator::allocate(uint64_t size, uint64_t alignment, bool linear) {
+	if (size == 0) throw std::invalid_argument(LOCATION "cannot allocate zero bytes!");
+	if (!isPowerOfTwo(alignment))
+		throw std::invalid_argument(LOCATION "alignment must be a power of two!");
+
+	const size_t first = allocationStrategy == Strategy::linear ? allocations.size() : 0;
+	for (size_t index = first; index <= allocations.size(); ++index) {
+		if (const auto offset = fit(index, size, alignment, linear)) {
+			allocations.insert(allocations.begin() + index, {*offset, size, linear});
+			usedSize += size;
+			return offset;
+		}
+	}
+
+	return std::nullopt;
+}
+
+void BlockAllocator::free(uint64_t offset) {
+	const auto allocation =
+	    std::lower_bound(allocations.begin(), allocations.end(), offset,
+	                     [](const Allocation& a, uint64_t offset) { return a.offset < offset; });
+	if (allocation == allocations.end() || allocation->offset != offset)
+		throw std::invalid_argument(LOCATION "no allocation at offset " + std::to_string(offset) +
+		                            "!");
+
+	usedSize -= allocation->size;
+	allocations.erase(allocation);
+}
+
+/**
+ * Finds the first suitable offset in the gap before allocations[index], or after the last
+ * allocation if index is the number of allocations
+ */
+std::optional<uint64_t> BlockAllocator::fit(size_t index, uint64_t size, uint64_t alignment,
+                                            bool linear) const {
+	const Allocation* previous = index ? &allocations[index - 1] : nullptr;
+	const Allocation* next = index < allocations.size() ? &allocations[index] : nullptr;
+
+	const uint64_t begin = previous ? previous->offset + previous->size : 0;
+	const uint64_t end = next ? next->offset : blockSize;
+
+	uint64_t offset = alignUp(begin, alignment);
+	if (previous && previous->linear != linear &&
+	    samePage(previous->offset + previous->size - 1, offset, granularity))
+		offset = alignUp(offset, granularity);
+
+	if (offset > end || size > end - offset) return std::nullopt;
+
+	if (next && next->linear != linear && samePage(offset + size - 1, next->offset, granularity))
+		return std::nullopt;
+
+	return offset;
+}
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <cmath>
 #include <queue>
@@ -8,6 +9,7 @@
 #include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Calculate.hpp"
 
@@ -21,12 +23,33 @@
 
 namespace {
 	struct Token {
-		enum class Function { eSin, eCos, eTan, eMax, eMin };
-		enum class Type { eUndefined, eNumber, eOperator, eFunction, eParentheses, eComma };
+		enum class Function {
+			eSin,
+			eCos,
+			eTan,
+			eLog,
+			eLog10,
+			eExp,
+			eSqrt,
+			eAbs,
+			eMax,
+			eMin,
+			eNegate
+		};
+		enum class Type {
+			eUndefined,
+			eNumber,
+			eVariable,
+			eOperator,
+			eFunction,
+			eParentheses,
+			eComma
+		};
 
 		Type type;
 		union {
 			float num;
+			uint32_t variable;
 			Function func;
 			char op;
 		};
@@ -34,8 +57,15 @@ namespace {
 		constexpr Token() : type(Type::eUndefined), num(0.f) {}
 		constexpr Token(Type tokenType) : type(tokenType), num(0.f) {}
 		constexpr Token(Type tokenType, float number) : type(tokenType), num(number) {}
+		constexpr Token(Type tokenType, uint32_t index) : type(tokenType), variable(index) {}
 		constexpr Token(Type tokenType, Function function) : type(tokenType), func(function) {}
 		constexpr Token(Type tokenType, char operation) : type(tokenType), op(operation) {}
+
+		// whether the token can end an operand, so that a following '-' is an operator
+		bool endsOperand() const {
+			return type == Type::eNumber || type == Type::eVariable ||
+			       (type == Type::eParentheses && op == ')');
+		}
 	};
 
 	struct OpProperties {
@@ -43,10 +73,17 @@ namespace {
 		bool leftAssociative;
 	};
 
+	typedef Expression::Instruction::Op Op;
+
 	static const std::unordered_map<std::string, Token::Function> functions = {
 	    {"sin", Token::Function::eSin},
 	    {"cos", Token::Function::eCos},
 	    {"tan", Token::Function::eTan},
+	    {"log", Token::Function::eLog},
+	    {"log10", Token::Function::eLog10},
+	    {"exp", Token::Function::eExp},
+	    {"sqrt", Token::Function::eSqrt},
+	    {"abs", Token::Function::eAbs},
 	    {"max", Token::Function::eMax},
 	    {"min", Token::Function::eMin}};
 
@@ -56,25 +93,8 @@ namespace {
 	static const std::unordered_map<std::string, float> constants = {{"e", std::exp(1)},
 	                                                                 {"pi", M_PI}};
 
-	static constexpr float eval(char op, float op1, float op2) {
-		switch (op) {
-			case '+':
-				return op1 + op2;
-			case '-':
-				return op1 - op2;
-			case '*':
-				return op1 * op2;
-			case '/':
-				return op1 / op2;
-			case '%':
-				return std::fmod(op1, op2);
-			case '^':
-				return std::pow(op1, op2);
-		}
-		throw std::invalid_argument(LOCATION "Invalid operation!");
-	}
-
-	Token extractToken(std::string_view& str, Token::Type lastTokenType) {
+	Token extractToken(std::string_view& str, Token lastToken,
+	                   const std::unordered_map<std::string, uint32_t>& variables) {
 		if (str.front() == ',') {
 			str.remove_prefix(1);
 			return Token(Token::Type::eComma);
@@ -82,11 +102,19 @@ namespace {
 
 		char* ptr;
 		if (float value = std::strtof(str.data(), &ptr);
-		    lastTokenType != Token::Type::eNumber && ptr != str.data()) {
+		    !lastToken.endsOperand() && ptr != str.data()) {
 			str.remove_prefix(ptr - str.data());
 			return Token(Token::Type::eNumber, value);
 		}
 
+		auto nameEnd = std::find_if_not(str.begin(), str.end(),
+		                                [](char c) { return std::isalnum(c) || c == '_'; });
+		if (auto it = variables.find(std::string(str.begin(), nameEnd)); it != variables.end()) {
+			Token rtrn(Token::Type::eVariable, it->second);
+			str.remove_prefix(nameEnd - str.begin());
+			return rtrn;
+		}
+
 		auto constEnd =
 		    std::find_if_not(str.begin(), str.end(), [](char c) { return std::isalpha(c); });
 		if (auto it = constants.find(std::string(str.begin(), constEnd)); it != constants.end()) {
@@ -102,6 +130,12 @@ namespace {
 			return rtrn;
 		}
 
+		// a minus in place of an operand negates it, e.g. "-width"
+		if (str.front() == '-' && !lastToken.endsOperand()) {
+			str.remove_prefix(1);
+			return Token(Token::Type::eFunction, Token::Function::eNegate);
+		}
+
 		if (operators.find(str.front()) != operators.end()) {
 			Token rtrn(Token::Type::eOperator, str.front());
 			str.remove_prefix(1);
@@ -117,18 +151,20 @@ namespace {
 		throw std::invalid_argument(LOCATION "Unrecognized token!");
 	}
 
-	std::queue<Token> constructStack(std::string_view expr) {
-		while (std::isspace(expr.back())) expr.remove_suffix(1);
+	std::queue<Token> constructStack(std::string_view expr,
+	                                 const std::unordered_map<std::string, uint32_t>& variables) {
+		while (!expr.empty() && std::isspace(expr.back())) expr.remove_suffix(1);
 
 		std::stack<Token> operatorStack;
 		std::queue<Token> output;
 		Token token;
 		while (!expr.empty()) {
 			while (std::isspace(expr.front())) expr.remove_prefix(1);
-			token = extractToken(expr, token.type);
+			token = extractToken(expr, token, variables);
 
 			switch (token.type) {
 				case Token::Type::eNumber:
+				case Token::Type::eVariable:
 					output.push(token);
 					break;
 				case Token::Type::eOperator:
@@ -177,78 +213,286 @@ namespace {
 		return output;
 	}
 
-	float deconstructStack(std::queue<Token>& tokens) {
-		std::stack<float> operandStack;
-		while (!tokens.empty()) {
-			Token token = tokens.front();
-			tokens.pop();
-			switch (token.type) {
-				case Token::Type::eNumber:
-					operandStack.push(token.num);
+	Op instructionOp(const Token& token) {
+		if (token.type == Token::Type::eFunction) {
+			switch (token.func) {
+				case Token::Function::eSin:
+					return Op::eSin;
+				case Token::Function::eCos:
+					return Op::eCos;
+				case Token::Function::eTan:
+					return Op::eTan;
+				case Token::Function::eLog:
+					return Op::eLog;
+				case Token::Function::eLog10:
+					return Op::eLog10;
+				case Token::Function::eExp:
+					return Op::eExp;
+				case Token::Function::eSqrt:
+					return Op::eSqrt;
+				case Token::Function::eAbs:
+					return Op::eAbs;
+				case Token::Function::eMax:
+					return Op::eMax;
+				case Token::Function::eMin:
+					return Op::eMin;
+				case Token::Function::eNegate:
+					return Op::eNegate;
+			}
+		}
+
+		switch (token.op) {
+			case '+':
+				return Op::eAdd;
+			case '-':
+				return Op::eSubtract;
+			case '*':
+				return Op::eMultiply;
+			case '/':
+				return Op::eDivide;
+			case '%':
+				return Op::eModulo;
+			case '^':
+				return Op::ePower;
+		}
+		throw std::invalid_argument(LOCATION "Invalid operation!");
+	}
+
+	constexpr size_t operandCount(Op op) {
+		switch (op) {
+			case Op::eConstant:
+			case Op::eVariable:
+				return 0;
+			case Op::eAdd:
+			case Op::eSubtract:
+			case Op::eMultiply:
+			case Op::eDivide:
+			case Op::eModulo:
+			case Op::ePower:
+			case Op::eMax:
+			case Op::eMin:
+				return 2;
+			default:
+				return 1;
+		}
+	}
+
+	/**
+	 * Applies op to the operands at the top of stack, the last operand at the top
+	 */
+	inline float apply(Op op, const float* operands) {
+		switch (op) {
+			case Op::eAdd:
+				return operands[0] + operands[1];
+			case Op::eSubtract:
+				return operands[0] - operands[1];
+			case Op::eMultiply:
+				return operands[0] * operands[1];
+			case Op::eDivide:
+				return operands[0] / operands[1];
+			case Op::eModulo:
+				return std::fmod(operands[0], operands[1]);
+			case Op::ePower:
+				return std::pow(operands[0], operands[1]);
+			case Op::eNegate:
+				return -operands[0];
+			case Op::eSin:
+				return std::sin(operands[0]);
+			case Op::eCos:
+				return std::cos(operands[0]);
+			case Op::eTan:
+				return std::tan(operands[0]);
+			case Op::eLog:
+				return std::log(operands[0]);
+			case Op::eLog10:
+				return std::log10(operands[0]);
+			case Op::eExp:
+				return std::exp(operands[0]);
+			case Op::eSqrt:
+				return std::sqrt(operands[0]);
+			case Op::eAbs:
+				return std::abs(operands[0]);
+			case Op::eMax:
+				return std::max(operands[0], operands[1]);
+			case Op::eMin:
+				return std::min(operands[0], operands[1]);
+			default:
+				return 0.f;
+		}
+	}
+}  // namespace
+
+Expression::Expression(std::string_view expr, const std::vector<std::string>& variables) {
+	std::unordered_map<std::string, uint32_t> indices;
+	for (uint32_t i = 0; i < variables.size(); ++i) indices.emplace(variables[i], i);
+
+	auto tokens = constructStack(expr, indices);
+
+	size_t depth = 0;
+	while (!tokens.empty()) {
+		Token token = tokens.front();
+		tokens.pop();
+
+		Instruction instruction = {};
+		switch (token.type) {
+			case Token::Type::eNumber:
+				instruction.op = Op::eConstant;
+				instruction.value = token.num;
+				break;
+			case Token::Type::eVariable:
+				instruction.op = Op::eVariable;
+				instruction.variable = token.variable;
+				break;
+			case Token::Type::eOperator:
+			case Token::Type::eFunction:
+				instruction.op = instructionOp(token);
+				break;
+			default:
+				throw std::invalid_argument(LOCATION "Invalid token!");
+		}
+
+		const size_t operands = operandCount(instruction.op);
+		if (depth < operands) {
+			if (token.type == Token::Type::eOperator)
+				throw std::invalid_argument(
+				    std::string(LOCATION "Encountered unexpected operator '") + token.op + "'");
+			throw std::invalid_argument(operands == 1 ? LOCATION "Expected function argument"
+			                                          : LOCATION "Expected function arguments");
+		}
+
+		depth = depth - operands + 1;
+		if (depth > maxDepth) throw std::invalid_argument(LOCATION "Expression is too deep!");
+
+		// operands that are constants are the constant instructions emitted last
+		const bool foldable =
+		    operands > 0 && std::all_of(code.end() - operands, code.end(), [](const auto& i) {
+			    return i.op == Op::eConstant;
+		    });
+		if (foldable) {
+			std::array<float, 2> values;
+			for (size_t i = 0; i < operands; ++i) values[i] = code[code.size() - operands + i].value;
+			code.resize(code.size() - operands);
+
+			instruction.value = apply(instruction.op, values.data());
+			instruction.op = Op::eConstant;
+		}
+
+		code.push_back(instruction);
+	}
+
+	if (depth == 0) throw std::invalid_argument(LOCATION "Empty expression!");
+	if (depth > 1) throw std::invalid_argument(LOCATION "Expected an operator!");
+}
+
+float Expression::evaluate(const float* variables) const {
+	std::array<float, maxDepth> stack;
+	size_t top = 0;
+
+	for (const auto& instruction : code) {
+		switch (instruction.op) {
+			case Op::eConstant:
+				stack[top++] = instruction.value;
+				break;
+			case Op::eVariable:
+				stack[top++] = variables[instruction.variable];
+				break;
+			default:
+				if (operandCount(instruction.op) == 2) --top;
+				stack[top - 1] = apply(instruction.op, &stack[top - 1]);
+				break;
+		}
+	}
+
+	return stack[0];
+}
+
+void Expression::evaluate(const float* const* variables, float* results, size_t count) const {
+	typedef std::array<float, laneCount> Lanes;
+	std::array<Lanes, maxDepth> stack;
+
+	for (size_t first = 0; first < count; first += laneCount) {
+		// the lanes past the end of the values of the last block are padded with zeros
+		const size_t lanes = std::min(laneCount, count - first);
+		size_t top = 0;
+
+		for (const auto& instruction : code) {
+			switch (instruction.op) {
+				case Op::eConstant:
+					stack[top++].fill(instruction.value);
+					break;
+				case Op::eVariable:
+					stack[top].fill(0.f);
+					std::copy_n(variables[instruction.variable] + first, lanes, stack[top++].begin());
+					break;
+				case Op::eAdd:
+					--top;
+					for (size_t l = 0; l < laneCount; ++l) stack[top - 1][l] += stack[top][l];
+					break;
+				case Op::eSubtract:
+					--top;
+					for (size_t l = 0; l < laneCount; ++l) stack[top - 1][l] -= stack[top][l];
+					break;
+				case Op::eMultiply:
+					--top;
+					for (size_t l = 0; l < laneCount; ++l) stack[top - 1][l] *= stack[top][l];
+					break;
+				case Op::eDivide:
+					--top;
+					for (size_t l = 0; l < laneCount; ++l) stack[top - 1][l] /= stack[top][l];
+					break;
+				case Op::eNegate:
+					for (size_t l = 0; l < laneCount; ++l) stack[top - 1][l] = -stack[top - 1][l];
 					break;
-				case Token::Type::eOperator: {
-					if (operandStack.size() < 2)
-						throw std::invalid_argument(
-						    std::string(LOCATION "Encountered unexpected operator '") + token.op +
-						    "'");
-
-					float op1 = operandStack.top();
-					operandStack.pop();
-					float op2 = operandStack.top();
-					operandStack.pop();
-					operandStack.push(eval(token.op, op2, op1));
-				} break;
-				case Token::Type::eFunction: {
-					switch (token.func) {
-						case Token::Function::eSin:
-							if (operandStack.empty())
-								throw std::invalid_argument(LOCATION "Expected function argument");
-							operandStack.top() = std::sin(operandStack.top());
-							break;
-						case Token::Function::eCos:
-							if (operandStack.empty())
-								throw std::invalid_argument(LOCATION "Expected function argument");
-							operandStack.top() = std::cos(operandStack.top());
-							break;
-						case Token::Function::eTan:
-							if (operandStack.empty())
-								throw std::invalid_argument(LOCATION "Expected function argument");
-							operandStack.top() = std::tan(operandStack.top());
-							break;
-						case Token::Function::eMax: {
-							if (operandStack.size() < 2)
-								throw std::invalid_argument(LOCATION "Expected function arguments");
-							float arg1 = operandStack.top();
-							operandStack.pop();
-							float arg2 = operandStack.top();
-							operandStack.pop();
-							operandStack.push(std::max(arg1, arg2));
-						} break;
-						case Token::Function::eMin: {
-							if (operandStack.size() < 2)
-								throw std::invalid_argument(LOCATION "Expected function arguments");
-							float arg1 = operandStack.top();
-							operandStack.pop();
-							float arg2 = operandStack.top();
-							operandStack.pop();
-							operandStack.push(std::min(arg1, arg2));
-						} break;
-					}
-				} break;
 				default:
-					throw std::invalid_argument(LOCATION "Invalid token!");
+					if (operandCount(instruction.op) == 2) {
+						--top;
+						for (size_t l = 0; l < laneCount; ++l) {
+							const float operands[] = {stack[top - 1][l], stack[top][l]};
+							stack[top - 1][l] = apply(instruction.op, operands);
+						}
+					} else {
+						for (size_t l = 0; l < laneCount; ++l)
+							stack[top - 1][l] = apply(instruction.op, &stack[top - 1][l]);
+					}
+					break;
 			}
 		}
-		return operandStack.top();
+
+		std::copy_n(stack[0].begin(), lanes, results + first);
 	}
-}  // namespace
+}
+
+bool Expression::constant() const {
+	return std::none_of(code.begin(), code.end(),
+	                    [](const auto& instruction) { return instruction.op == Op::eVariable; });
+}
 
 template <class NumType>
 NumType calculate(std::string_view expr) {
-	auto tokens = constructStack(expr);
-	return static_cast<NumType>(deconstructStack(tokens));
+	return static_cast<NumType>(Expression(expr).evaluate());
+}
+
+template <class NumType>
+NumType calculate(std::string_view expr, const std::unordered_map<std::string, float>& variables) {
+	std::vector<std::string> names;
+	std::vector<float> values;
+	names.reserve(variables.size());
+	values.reserve(variables.size());
+	for (const auto& [name, value] : variables) {
+		names.push_back(name);
+		values.push_back(value);
+	}
+
+	return static_cast<NumType>(Expression(expr, names).evaluate(values.data()));
 }
 
 template int calculate<int>(std::string_view expr);
 template size_t calculate<size_t>(std::string_view expr);
 template float calculate<float>(std::string_view expr);
+
+template int calculate<int>(std::string_view expr,
+                            const std::unordered_map<std::string, float>& variables);
+template size_t calculate<size_t>(std::string_view expr,
+                                  const std::unordered_map<std::string, float>& variables);
+template float calculate<float>(std::string_view expr,
+                                const std::unordered_map<std::string, float>& variables);
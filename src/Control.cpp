@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(LINUX) || defined(MACOS)
+	#define CONTROL_SOCKET_SUPPORTED
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <poll.h>
+	#include <sys/socket.h>
+	#include <sys/stat.h>
+	#include <sys/types.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+
+	#ifndef MSG_NOSIGNAL
+		#define MSG_NOSIGNAL 0
+	#endif
+#endif
+
+#include "Calculate.hpp"
+#include "Control.hpp"
+#include "Settings.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	void trim(std::string_view& str) {
+		while (!str.empty() && std::isspace(str.front())) str.remove_prefix(1);
+		while (!str.empty() && std::isspace(str.back())) str.remove_suffix(1);
+	}
+
+	/**
+	 * Removes and returns the first word or double quoted string of str
+	 */
+	std::string_view nextToken(std::string_view& str) {
+		trim(str);
+		if (str.empty()) throw std::invalid_argument(LOCATION "unexpected end of command!");
+
+		size_t end;
+		if (str.front() == '"') {
+			end = str.find('"', 1);
+			if (end == std::string_view::npos)
+				throw std::invalid_argument(LOCATION "Mismatched double quotes!");
+			++end;
+		} else {
+			end = 0;
+			while (end < str.size() && !std::isspace(str[end])) ++end;
+		}
+
+		auto token = str.substr(0, end);
+		str.remove_prefix(end);
+		return token;
+	}
+}  // namespace
+
+ControlCommand parseControlCommand(std::string_view line) {
+	ControlCommand command;
+
+	const auto name = nextToken(line);
+	trim(line);
+
+	if (name == "modules") {
+		command.type = ControlCommand::Type::modules;
+		if (line.empty()) throw std::invalid_argument(LOCATION "expected a list of modules!");
+		for (auto module : parseAsArray(line))
+			command.modules.emplace_back(parseAsString(module));
+	} else if (name == "set") {
+		command.type = ControlCommand::Type::set;
+		command.module = parseAsString(nextToken(line));
+		command.parameter = nextToken(line);
+		trim(line);
+		command.value = calculate<float>(line);
+	} else if (name == "amplitude") {
+		command.type = ControlCommand::Type::amplitude;
+		command.value = calculate<float>(line);
+	} else if (name == "smoothingLevel") {
+		command.type = ControlCommand::Type::smoothingLevel;
+		command.value = calculate<float>(line);
+	} else if (name == "stats") {
+		command.type = ControlCommand::Type::stats;
+	} else {
+		throw std::invalid_argument(LOCATION "unrecognized command '" + std::string(name) + "'");
+	}
+
+	return command;
+}
+
+class ControlServer::ControlServerImpl {
+public:
+	ControlServerImpl(const Settings& serverSettings) {
+		settings = serverSettings;
+
+#ifdef CONTROL_SOCKET_SUPPORTED
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		const std::string path = settings.socketPath.string();
+		if (path.size() >= sizeof(address.sun_path))
+			throw std::runtime_error(LOCATION "control socket path too long!");
+		path.copy(address.sun_path, path.size());
+
+		// only remove sockets left behind by previous instances, not those still listening
+		if (!stale(address))
+			throw std::runtime_error(LOCATION "control socket '" + path + "' already in use!");
+		unlink(path.c_str());
+
+		listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listenSocket < 0) throw std::runtime_error(LOCATION "failed to create control socket!");
+
+		struct stat socketStat;
+		if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+		    listen(listenSocket, 4) < 0 || stat(path.c_str(), &socketStat) < 0) {
+			close(listenSocket);
+			throw std::runtime_error(LOCATION "failed to bind control socket '" + path + "'!");
+		}
+		socketDevice = socketStat.st_dev;
+		socketInode = socketStat.st_ino;
+
+		if (pipe(wakePipe) < 0) {
+			close(listenSocket);
+			throw std::runtime_error(LOCATION "failed to create pipe!");
+		}
+
+		serverThread = std::thread(&ControlServerImpl::serve, this);
+#else
+		throw std::runtime_error(LOCATION "control socket unsupported on this platform!");
+#endif
+	}
+
+	~ControlServerImpl() {
+#ifdef CONTROL_SOCKET_SUPPORTED
+		stop = true;
+		[[maybe_unused]] auto written = write(wakePipe[1], "", 1);
+		serverThread.join();
+
+		close(wakePipe[0]);
+		close(wakePipe[1]);
+		close(listenSocket);
+		// the path may have been replaced since, e.g. by hand
+		struct stat socketStat;
+		if (stat(settings.socketPath.string().c_str(), &socketStat) == 0 &&
+		    socketStat.st_dev == socketDevice && socketStat.st_ino == socketInode)
+			unlink(settings.socketPath.string().c_str());
+#endif
+	}
+
+	void poll(const std::function<std::string(const ControlCommand&)>& handler) {
+		std::lock_guard<std::mutex> lock(requestMutex);
+		for (auto& request : requests) {
+			try {
+				request.reply.set_value(handler(parseControlCommand(request.line)));
+			} catch (const std::exception& e) {
+				request.reply.set_value(std::string("error: ") + e.what() + "\n");
+			}
+		}
+		requests.clear();
+	}
+
+private:
+	struct Request {
+		std::string line;
+		std::promise<std::string> reply;
+	};
+
+	Settings settings;
+
+	std::mutex requestMutex;
+	std::deque<Request> requests;
+
+	std::atomic<bool> stop{false};
+
+#ifdef CONTROL_SOCKET_SUPPORTED
+	int listenSocket = -1;
+	int wakePipe[2] = {-1, -1};
+	std::thread serverThread;
+	// identify the socket file bound by this server
+	dev_t socketDevice = 0;
+	ino_t socketInode = 0;
+
+	/**
+	 * Whether nothing listens on address, either because there is no file or no server accepts
+	 * connections on it any more
+	 */
+	static bool stale(const sockaddr_un& address) {
+		const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (probe < 0) throw std::runtime_error(LOCATION "failed to create control socket!");
+
+		const bool connected =
+		    connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+		const int error = errno;
+		close(probe);
+		return !connected && (error == ECONNREFUSED || error == ENOENT);
+	}
+
+	void serve() {
+		struct Client {
+			int socket;
+			std::string buffer;
+		};
+		std::vector<Client> clients;
+
+		while (!stop) {
+			std::vector<pollfd> fds;
+			fds.push_back({wakePipe[0], POLLIN, 0});
+			fds.push_back({listenSocket, POLLIN, 0});
+			for (auto& client : clients) fds.push_back({client.socket, POLLIN, 0});
+
+			if (::poll(fds.data(), fds.size(), -1) < 0) continue;
+			if (fds[0].revents) break;
+
+			if (fds[1].revents & POLLIN) {
+				int clientSocket = accept(listenSocket, nullptr, nullptr);
+				if (clientSocket >= 0) clients.push_back({clientSocket, {}});
+			}
+
+			for (size_t i = 2; i < fds.size(); ++i) {
+				if (!fds[i].revents) continue;
+
+				auto& client = clients[i - 2];
+				char data[256];
+				const auto size = read(client.socket, data, sizeof(data));
+				if (size <= 0) {
+					close(client.socket);
+					client.socket = -1;
+					continue;
+				}
+				client.buffer.append(data, size);
+
+				for (auto end = client.buffer.find('\n'); end != std::string::npos;
+				     end = client.buffer.find('\n')) {
+					std::string line = client.buffer.substr(0, end);
+					client.buffer.erase(0, end + 1);
+					if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+					std::string reply = submit(std::move(line));
+					if (send(client.socket, reply.data(), reply.size(), MSG_NOSIGNAL) < 0) break;
+				}
+			}
+
+			clients.erase(std::remove_if(clients.begin(), clients.end(),
+			                             [](const Client& client) { return client.socket < 0; }),
+			              clients.end());
+		}
+
+		for (auto& client : clients) close(client.socket);
+	}
+
+	/**
+	 * Queues line to be handled by the next call to poll and waits for the reply
+	 */
+	std::string submit(std::string line) {
+		std::future<std::string> reply;
+		{
+			std::lock_guard<std::mutex> lock(requestMutex);
+			requests.push_back({std::move(line), {}});
+			reply = requests.back().reply.get_future();
+		}
+
+		while (reply.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+			if (stop) return "";
+
+		return reply.get();
+	}
+#endif
+};
+
+ControlServer::ControlServer(const Settings& serverSettings) {
+	impl = new ControlServerImpl(serverSettings);
+}
+
+ControlServer::~ControlServer() { delete impl; }
+
+ControlServer& ControlServer::operator=(ControlServer&& other) noexcept {
+	std::swap(impl, other.impl);
+	return *this;
+}
+
+void ControlServer::poll(const std::function<std::string(const ControlCommand&)>& handler) {
+	if (impl) impl->poll(handler);
+}
+
+std::filesystem::path ControlServer::defaultSocketPath() {
+#ifdef CONTROL_SOCKET_SUPPORTED
+	if (const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR"); runtimeDir && *runtimeDir)
+		return std::filesystem::path(runtimeDir) / "vkav.sock";
+	return std::filesystem::temp_directory_path() / ("vkav-" + std::to_string(getuid()) + ".sock");
+#else
+	return {};
+#endif
+}
+
+bool ControlServer::supported() {
+#ifdef CONTROL_SOCKET_SUPPORTED
+	return true;
+#else
+	return false;
+#endif
+}
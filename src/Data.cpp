@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstddef>
 
 #include "Data.hpp"
@@ -14,7 +15,8 @@ void AudioData::allocate(size_t channels, size_t channelSize) {
 	delete[] buffer;
 	lBuffer = new float[channelSize / 2];
 	rBuffer = new float[channelSize / 2];
-	buffer = new float[channels * channelSize];
+	// smoothing reuses buffer for channelSize complex values, even for a single channel
+	buffer = new float[std::max<size_t>(channels, 2) * channelSize];
 }
 
 AudioData::~AudioData() {
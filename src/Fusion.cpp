@@ -0,0 +1,159 @@
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Fusion.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	constexpr const char* prelude =
+	    "#version 450\n"
+	    "#extension GL_ARB_separate_shader_objects : enable\n"
+	    "#extension GL_GOOGLE_include_directive : enable\n"
+	    "\n"
+	    "#define VKAV_FUSED\n"
+	    "\n"
+	    "layout(constant_id = 0) const int audioSize        = 1;\n"
+	    "layout(constant_id = 1) const float smoothingLevel = 0.0;\n"
+	    "layout(constant_id = 2) const int width            = 1;\n"
+	    "layout(constant_id = 3) const int height           = 1;\n"
+	    "layout(constant_id = 4) const int vertexCount      = 6;\n"
+	    "layout(constant_id = 5) const int instanceCount    = 1;\n"
+	    "\n"
+	    "layout(set = 0, binding = 0) uniform data {\n"
+	    "\tfloat lVolume;\n"
+	    "\tfloat rVolume;\n"
+	    "\tuint time;\n"
+	    "};\n"
+	    "\n"
+	    "layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;\n"
+	    "layout(set = 0, binding = 2) uniform samplerBuffer rBuffer;\n"
+	    "layout(set = 0, binding = 3) uniform sampler2D backgroundImage;\n"
+	    "layout(set = 0, binding = 4) uniform samplerBuffer stereoBuffer;\n"
+	    "layout(set = 0, binding = 5) uniform sampler1D spectrumImage;\n"
+	    "\n"
+	    "layout(location = 0) out vec4 outColor;\n";
+
+	std::string readTextFile(const std::filesystem::path& filePath) {
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file.is_open())
+			throw std::runtime_error(LOCATION "failed to open file '" + filePath.string() + "'!");
+
+		std::stringstream contents;
+		contents << file.rdbuf();
+		return contents.str();
+	}
+
+	/**
+	 * Renames the entry point and parameters of a module to names starting with prefix
+	 */
+	std::string defineRenames(const FusedModule& module, const std::string& prefix) {
+		std::string defines = "#define " + module.entryPoint + ' ' + prefix + "entry\n";
+		for (const auto& name : module.parameterNames)
+			defines += "#define " + name + ' ' + prefix + name + '\n';
+		return defines;
+	}
+
+	std::string undefineRenames(const FusedModule& module) {
+		std::string undefines = "#undef " + module.entryPoint + '\n';
+		for (const auto& name : module.parameterNames) undefines += "#undef " + name + '\n';
+		return undefines;
+	}
+
+	/**
+	 * Makes a module fragment shader includable from the fused shader
+	 */
+	std::string prepareSource(const std::string& source, const FusedModule& module,
+	                          const std::string& prefix) {
+		static const std::regex versionRegex(R"(^[ \t]*#[ \t]*(version|extension)\b.*$)");
+		static const std::regex includeRegex(R"re(^([ \t]*#[ \t]*include[ \t]*)"([^"]*)")re");
+		static const std::regex constantIdRegex(R"(constant_id[ \t]*=[ \t]*(\d+))");
+
+		const auto directory = std::filesystem::absolute(module.fragmentShader).parent_path();
+
+		std::stringstream output;
+		std::stringstream stream(source);
+		std::string line;
+		size_t lineNum = 0;
+		while (std::getline(stream, line)) {
+			++lineNum;
+			std::smatch match;
+			if (std::regex_search(line, match, versionRegex)) {
+				// the fused shader declares these once
+				output << '\n';
+				continue;
+			}
+
+			if (std::regex_search(line, match, includeRegex)) {
+				// included files are guarded and shared by every module, so their code must not
+				// pick up the names of the module that happens to include them first
+				output << undefineRenames(module);
+				output << match[1] << '"' << (directory / match[2].str()).generic_string() << '"'
+				       << match.suffix() << '\n';
+				output << defineRenames(module, prefix) << "#line " << lineNum + 1 << '\n';
+				continue;
+			}
+
+			std::string remapped;
+			auto begin = line.cbegin();
+			for (std::sregex_iterator it(line.cbegin(), line.cend(), constantIdRegex), end;
+			     it != end; ++it) {
+				uint32_t id = std::stoul((*it)[1].str());
+				if (id >= 6) id += module.constantIdOffset;
+
+				remapped.append(begin, (*it)[0].first);
+				remapped += "constant_id = " + std::to_string(id);
+				begin = (*it)[0].second;
+			}
+			remapped.append(begin, line.cend());
+
+			output << remapped << '\n';
+		}
+
+		return output.str();
+	}
+}  // namespace
+
+std::string generateFusedShader(const std::vector<FusedModule>& modules) {
+	std::stringstream shader;
+	shader << prelude;
+
+	for (size_t i = 0; i < modules.size(); ++i) {
+		const std::string prefix = "vkav_module" + std::to_string(i) + "_";
+
+		shader << "\n// " << modules[i].fragmentShader.generic_string() << "\n";
+		shader << defineRenames(modules[i], prefix);
+
+		shader << "#line 1\n";
+		shader << prepareSource(readTextFile(modules[i].fragmentShader), modules[i], prefix);
+
+		shader << undefineRenames(modules[i]);
+	}
+
+	// blend equation: color = src*src.a + dst*(1 - src.a), alpha = src.a
+	shader << "\nvoid main() {\n"
+	          "\tvec4 color = vec4(0);\n";
+	for (size_t i = 0; i < modules.size(); ++i) {
+		shader << "\n\toutColor = vec4(0);\n"
+		          "\tvkav_module"
+		       << i
+		       << "_entry();\n"
+		          "\tcolor = vec4(outColor.rgb*outColor.a + color.rgb*(1.0-outColor.a), "
+		          "outColor.a);\n";
+	}
+	shader << "\n\toutColor = color;\n"
+	          "}\n";
+
+	return shader.str();
+}
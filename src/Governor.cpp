@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "Governor.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+Governor::Governor(const Settings& governorSettings) : settings(governorSettings) {
+	if (!(settings.frameBudget > 0.0))
+		throw std::invalid_argument(LOCATION "the frame budget must be positive!");
+	if (settings.window == 0)
+		throw std::invalid_argument(LOCATION "the window must contain at least one frame!");
+	if (!(settings.headroom > 0.0 && settings.headroom < 1.0))
+		throw std::invalid_argument(LOCATION "the headroom must be between 0 and 1!");
+
+	settings.stepUpWindows = std::max(settings.stepUpWindows, 1u);
+	settings.maxStepUpWindows = std::max(settings.maxStepUpWindows, settings.stepUpWindows);
+	stepUpWindows = settings.stepUpWindows;
+	windowsSinceStepUp = std::numeric_limits<uint32_t>::max();
+}
+
+bool Governor::addFrame(double frameTime) {
+	frameTimes += frameTime;
+	if (++frames < settings.window) return false;
+
+	lastAverage = frameTimes / frames;
+	frameTimes = 0.0;
+	frames = 0;
+
+	if (settling) {
+		settling = false;
+		return false;
+	}
+
+	if (windowsSinceStepUp != std::numeric_limits<uint32_t>::max()) ++windowsSinceStepUp;
+	// a step up that held for long enough resets the wait
+	if (windowsSinceStepUp == settings.maxStepUpWindows) stepUpWindows = settings.stepUpWindows;
+
+	if (lastAverage > settings.frameBudget) {
+		windowsBelowHeadroom = 0;
+		if (currentLevel == settings.levels) return false;
+
+		// the level stepped up to could not hold the budget, wait longer before trying again
+		if (windowsSinceStepUp <= 1)
+			stepUpWindows = std::min(2 * stepUpWindows, settings.maxStepUpWindows);
+
+		++currentLevel;
+		settling = true;
+		return true;
+	}
+
+	if (lastAverage < settings.headroom * settings.frameBudget && currentLevel > 0) {
+		if (++windowsBelowHeadroom < stepUpWindows) return false;
+
+		windowsBelowHeadroom = 0;
+		windowsSinceStepUp = 0;
+		--currentLevel;
+		settling = true;
+		return true;
+	}
+
+	windowsBelowHeadroom = 0;
+	return false;
+}
+
+float Governor::quality() const { return std::ldexp(1.f, -static_cast<int>(currentLevel)); }
@@ -0,0 +1,51 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "Half.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+	#define F16C_SUPPORTED
+	#include <immintrin.h>
+#endif
+
+namespace {
+	void packHalf2Scalar(const float* first, const float* second, uint32_t* packed, size_t count) {
+		for (size_t i = 0; i < count; ++i)
+			packed[i] = floatToHalf(first[i]) | static_cast<uint32_t>(floatToHalf(second[i])) << 16;
+	}
+
+#ifdef F16C_SUPPORTED
+	__attribute__((target("avx,f16c"))) void packHalf2F16C(const float* first,
+	                                                         const float* second, uint32_t* packed,
+	                                                         size_t count) {
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m128i firstHalves =
+			    _mm256_cvtps_ph(_mm256_loadu_ps(first + i), _MM_FROUND_TO_NEAREST_INT);
+			const __m128i secondHalves =
+			    _mm256_cvtps_ph(_mm256_loadu_ps(second + i), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i),
+			                 _mm_unpacklo_epi16(firstHalves, secondHalves));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i + 4),
+			                 _mm_unpackhi_epi16(firstHalves, secondHalves));
+		}
+		packHalf2Scalar(first + i, second + i, packed + i, count - i);
+	}
+
+	bool f16cSupported() {
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+	}
+#endif
+}  // namespace
+
+void packHalf2(const float* first, const float* second, uint32_t* packed, size_t count) {
+#ifdef F16C_SUPPORTED
+	static const bool useF16C = f16cSupported();
+	if (useF16C) {
+		packHalf2F16C(first, second, packed, count);
+		return;
+	}
+#endif
+	packHalf2Scalar(first, second, packed, count);
+}
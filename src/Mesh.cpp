@@ -0,0 +1,227 @@
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Mesh.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	constexpr char meshMagic[8] = {'V', 'K', 'A', 'V', 'M', 'E', 'S', 'H'};
+	constexpr uint32_t meshVersion = 1;
+
+	static_assert(sizeof(Mesh::Vertex) == 6 * sizeof(float), "vertices must be tightly packed");
+
+	struct MeshHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+	};
+
+	/**
+	 * Converts a one based, possibly negative OBJ index into a zero based one
+	 */
+	std::optional<size_t> objIndex(const std::string& str, size_t count) {
+		long index;
+		try {
+			size_t end;
+			index = std::stol(str, &end);
+			if (end != str.size()) return std::nullopt;
+		} catch (const std::exception&) {
+			return std::nullopt;
+		}
+
+		if (index > 0 && static_cast<size_t>(index) <= count) return index - 1;
+		if (index < 0 && static_cast<size_t>(-index) <= count) return count + index;
+		return std::nullopt;
+	}
+
+	/**
+	 * Number of bytes left after the read position of stream, none if it can't seek
+	 */
+	std::optional<uint64_t> remainingBytes(std::istream& stream) {
+		const auto position = stream.tellg();
+		if (position < 0 || !stream.seekg(0, std::ios::end)) {
+			stream.clear();
+			return std::nullopt;
+		}
+		const auto end = stream.tellg();
+		stream.seekg(position);
+		if (end < position) return std::nullopt;
+		return static_cast<uint64_t>(end - position);
+	}
+
+	std::array<float, 3> subtract(const std::array<float, 3>& a, const std::array<float, 3>& b) {
+		return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+	}
+
+	std::array<float, 3> cross(const std::array<float, 3>& a, const std::array<float, 3>& b) {
+		return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+	}
+}  // namespace
+
+Mesh parseObj(std::istream& stream) {
+	std::vector<std::array<float, 3>> positions;
+	std::vector<std::array<float, 3>> normals;
+
+	Mesh mesh;
+	// vertex of the mesh for every pair of position and normal index, normal -1 if missing
+	std::map<std::pair<size_t, long>, uint32_t> vertices;
+	std::vector<bool> generatedNormal;
+
+	size_t lineNum = 0;
+	std::string lineStr;
+	while (std::getline(stream, lineStr)) {
+		++lineNum;
+		auto error = [&](const std::string& what) {
+			return std::invalid_argument("line " + std::to_string(lineNum) + ": " + what);
+		};
+
+		std::stringstream line(lineStr.substr(0, lineStr.find('#')));
+		std::string keyword;
+		if (!(line >> keyword)) continue;
+
+		if (keyword == "v" || keyword == "vn") {
+			std::array<float, 3> vector;
+			if (!(line >> vector[0] >> vector[1] >> vector[2]))
+				throw error("expected three coordinates");
+			(keyword == "v" ? positions : normals).push_back(vector);
+		} else if (keyword == "f") {
+			std::vector<uint32_t> face;
+			std::string element;
+			while (line >> element) {
+				// v, v/vt, v//vn or v/vt/vn
+				const auto firstSlash = element.find('/');
+				const auto secondSlash = firstSlash == std::string::npos
+				                             ? std::string::npos
+				                             : element.find('/', firstSlash + 1);
+
+				auto position = objIndex(element.substr(0, firstSlash), positions.size());
+				if (!position) throw error("invalid vertex '" + element + "'");
+
+				long normal = -1;
+				if (secondSlash != std::string::npos) {
+					auto index = objIndex(element.substr(secondSlash + 1), normals.size());
+					if (!index) throw error("invalid vertex '" + element + "'");
+					normal = static_cast<long>(*index);
+				}
+
+				auto [vertex, inserted] =
+				    vertices.try_emplace({*position, normal}, mesh.vertices.size());
+				if (inserted) {
+					mesh.vertices.push_back({positions[*position], {0.f, 0.f, 0.f}});
+					if (normal >= 0) mesh.vertices.back().normal = normals[normal];
+					generatedNormal.push_back(normal < 0);
+				}
+				face.push_back(vertex->second);
+			}
+			if (face.size() < 3) throw error("faces need at least three vertices");
+
+			for (size_t i = 1; i + 1 < face.size(); ++i) {
+				std::array<uint32_t, 3> triangle = {face[0], face[i], face[i + 1]};
+				mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+
+				// area weighted face normal for vertices without one
+				auto faceNormal = cross(subtract(mesh.vertices[triangle[1]].position,
+				                                 mesh.vertices[triangle[0]].position),
+				                        subtract(mesh.vertices[triangle[2]].position,
+				                                 mesh.vertices[triangle[0]].position));
+				for (auto vertex : triangle)
+					if (generatedNormal[vertex])
+						for (size_t c = 0; c < 3; ++c)
+							mesh.vertices[vertex].normal[c] += faceNormal[c];
+			}
+		}
+		// texture coordinates, groups and materials are not used
+	}
+
+	for (size_t vertex = 0; vertex < mesh.vertices.size(); ++vertex) {
+		if (!generatedNormal[vertex]) continue;
+
+		auto& normal = mesh.vertices[vertex].normal;
+		const float length =
+		    std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (length > 0.f)
+			for (auto& c : normal) c /= length;
+	}
+
+	return mesh;
+}
+
+Mesh readMesh(std::istream& stream) {
+	MeshHeader header;
+	if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+	    std::memcmp(header.magic, meshMagic, sizeof(meshMagic)) != 0)
+		throw std::invalid_argument("not a mesh file");
+	if (header.version != meshVersion)
+		throw std::invalid_argument("unsupported mesh version " + std::to_string(header.version));
+	if (header.indexCount % 3 != 0)
+		throw std::invalid_argument("index count is not a multiple of three");
+
+	// don't allocate whatever a corrupt header claims before knowing the data is there
+	const uint64_t size = static_cast<uint64_t>(header.vertexCount) * sizeof(Mesh::Vertex) +
+	                      static_cast<uint64_t>(header.indexCount) * sizeof(uint32_t);
+	if (auto remaining = remainingBytes(stream); remaining && size > *remaining)
+		throw std::invalid_argument("mesh file is truncated");
+
+	Mesh mesh;
+	mesh.vertices.resize(header.vertexCount);
+	mesh.indices.resize(header.indexCount);
+	if (!stream.read(reinterpret_cast<char*>(mesh.vertices.data()),
+	                 mesh.vertices.size() * sizeof(Mesh::Vertex)) ||
+	    !stream.read(reinterpret_cast<char*>(mesh.indices.data()),
+	                 mesh.indices.size() * sizeof(uint32_t)))
+		throw std::invalid_argument("mesh file is truncated");
+
+	for (auto index : mesh.indices)
+		if (index >= mesh.vertices.size())
+			throw std::invalid_argument("index " + std::to_string(index) + " is out of range");
+
+	return mesh;
+}
+
+void writeMesh(std::ostream& stream, const Mesh& mesh) {
+	MeshHeader header = {};
+	std::memcpy(header.magic, meshMagic, sizeof(meshMagic));
+	header.version = meshVersion;
+	header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(mesh.vertices.data()),
+	             mesh.vertices.size() * sizeof(Mesh::Vertex));
+	stream.write(reinterpret_cast<const char*>(mesh.indices.data()),
+	             mesh.indices.size() * sizeof(uint32_t));
+}
+
+Mesh loadMesh(const std::filesystem::path& path) {
+	const bool obj = path.extension() == ".obj";
+
+	std::ifstream file(path, obj ? std::ios::in : std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		throw std::runtime_error(LOCATION "failed to open mesh '" + path.string() + "'!");
+
+	try {
+		return obj ? parseObj(file) : readMesh(file);
+	} catch (const std::invalid_argument& e) {
+		throw std::runtime_error(LOCATION "failed to read mesh '" + path.string() + "': " +
+		                         e.what());
+	}
+}
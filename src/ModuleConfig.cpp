@@ -1,4 +1,6 @@
+#include <array>
 #include <cctype>
+#include <cmath>
 #include <iomanip>
 #include <istream>
 #include <limits>
@@ -6,6 +8,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -20,8 +23,87 @@ namespace {
 		if ((... || (s.get() != c))) s.setstate(std::ios::failbit);
 		return s;
 	}
+
+	bool isWindowExpression(const std::string& expression) {
+		try {
+			calculate<float>(expression, {{"width", 1.f}, {"height", 1.f}});
+			return true;
+		} catch (const std::exception&) {
+			return false;
+		}
+	}
+
+	/**
+	 * Splits "{a, b, ...}" into N window expressions on the commas that are not nested within
+	 * parentheses
+	 */
+	template <size_t N>
+	std::optional<std::array<std::string, N>> parseExpressions(const std::string& value) {
+		if (value.size() < 2 || value.front() != '{' || value.back() != '}') return std::nullopt;
+
+		std::vector<std::string> elements(1);
+		int depth = 0;
+		for (char c : value.substr(1, value.size() - 2)) {
+			if (c == '(') ++depth;
+			if (c == ')') --depth;
+
+			if (c == ',' && depth == 0)
+				elements.emplace_back();
+			else
+				elements.back() += c;
+		}
+		if (elements.size() != N) return std::nullopt;
+
+		std::array<std::string, N> expressions;
+		for (size_t i = 0; i < expressions.size(); ++i) {
+			auto begin = elements[i].find_first_not_of(" \t");
+			auto end = elements[i].find_last_not_of(" \t");
+			if (begin == std::string::npos) return std::nullopt;
+			expressions[i] = elements[i].substr(begin, end - begin + 1);
+
+			if (!isWindowExpression(expressions[i])) return std::nullopt;
+		}
+		return expressions;
+	}
+
+	std::string trimmed(const std::string& str) {
+		auto begin = str.find_first_not_of(" \t");
+		if (begin == std::string::npos) return "";
+		return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+	}
+
+	/**
+	 * Parses "INPUT, ... -> OUTPUT" where both sides may be empty
+	 */
+	std::optional<ModuleConfig::Layer> parseLayer(uint32_t layer, const std::string& value) {
+		const auto arrow = value.find("->");
+		if (arrow == std::string::npos) return std::nullopt;
+
+		ModuleConfig::Layer config = {};
+		config.layer = layer;
+		config.output = trimmed(value.substr(arrow + 2));
+		if (config.output == "window") config.output.clear();
+
+		if (trimmed(value.substr(0, arrow)).empty()) return config;
+
+		std::stringstream inputs(value.substr(0, arrow));
+		std::string input;
+		while (std::getline(inputs, input, ',')) {
+			input = trimmed(input);
+			if (input.empty()) return std::nullopt;
+			config.inputs.push_back(input);
+		}
+
+		return config;
+	}
 }  // namespace
 
+std::vector<float> ModuleConfig::initialFrameVariables() {
+	std::vector<float> variables(frameVariables.size(), 0.f);
+	variables[qualityVariable] = 1.f;
+	return variables;
+}
+
 ModuleConfig parseConfig(std::istream& stream) {
 	ModuleConfig config;
 
@@ -29,6 +111,8 @@ ModuleConfig parseConfig(std::istream& stream) {
 	Section section = Section::global;
 
 	size_t lineNum = 0;
+	// the instance count is checked once the parameters it may refer to are known
+	size_t instanceCountLine = 0;
 	std::string line_str;
 	while (std::getline(stream, line_str)) {
 		++lineNum;
@@ -74,10 +158,40 @@ ModuleConfig parseConfig(std::istream& stream) {
 			while (std::isspace(value.back())) value.pop_back();
 
 			if (name == "module")
-				config.moduleName = name;
+				config.moduleName = value;
 			else if (name == "vertexCount")
 				config.vertexCount = calculate<size_t>(value);
-			else
+			else if (name == "instanceCount") {
+				config.instanceCount = value;
+				instanceCountLine = lineNum;
+			} else if (name == "parameterBinding")
+				config.parameterBinding = calculate<size_t>(value);
+			else if (name == "fusable")
+				config.fusable = (value == "true");
+			else if (name == "packedSpectrum")
+				config.packedSpectrum = (value == "true");
+			else if (name == "spectrumImage")
+				config.spectrumImage = (value == "true");
+			else if (name == "bounds") {
+				config.bounds = parseExpressions<4>(value);
+				if (!config.bounds)
+					throw ParseException("expected bounds of the form '{x, y, width, height}'",
+					                     lineNum);
+			} else if (name == "workGroups") {
+				config.workGroups = parseExpressions<3>(value);
+				if (!config.workGroups)
+					throw ParseException("expected work groups of the form '{x, y, z}'", lineNum);
+			} else if (name.rfind("layer.", 0) == 0) {
+				std::optional<ModuleConfig::Layer> layer;
+				try {
+					layer = parseLayer(std::stoul(name.substr(6)), value);
+				} catch (const std::exception&) {
+				}
+				if (!layer)
+					throw ParseException("expected layer of the form 'layer.N = INPUT, ... -> OUTPUT'",
+					                     lineNum);
+				config.layers.push_back(layer.value());
+			} else
 				throw ParseException("unrecognized setting '" + name + "'", lineNum);
 		} else {
 			uint32_t id;
@@ -88,7 +202,15 @@ ModuleConfig parseConfig(std::istream& stream) {
 			std::string name;
 			std::string valueStr;
 
-			line >> type >> name >> std::ws;
+			bool dynamic = false;
+			line >> type;
+			if (type == "dynamic") {
+				if (section != Section::parameters)
+					throw ParseException("only parameters can be dynamic", lineNum);
+				dynamic = true;
+				line >> type;
+			}
+			line >> name >> std::ws;
 			if (line.get() != '=')
 				throw ParseException(std::string("expected '=' instead of '") +
 				                         static_cast<char>(line.unget().get()) + "'",
@@ -103,22 +225,96 @@ ModuleConfig parseConfig(std::istream& stream) {
 				case Section::parameters: {
 					ModuleConfig::Parameter param = {};
 					param.id = id;
+					param.name = name;
+					param.dynamic = dynamic;
+					if (type != "int" && type != "float")
+						throw ParseException("Unrecognized parameter type `" + type + "`", lineNum);
+
+					Expression expression;
+					try {
+						expression = Expression(
+						    valueStr, dynamic ? ModuleConfig::frameVariables
+						                      : std::vector<std::string>{});
+					} catch (const std::invalid_argument& e) {
+						throw ParseException(e.what(), lineNum);
+					}
+
+					// start from the value the renderer would evaluate before the first frame
+					const float value =
+					    expression.evaluate(ModuleConfig::initialFrameVariables().data());
+					if (std::isnan(value))
+						throw ParseException("initial value of '" + name + "' is not a number",
+						                     lineNum);
 					if (type == "int")
-						param.value = calculate<int32_t>(valueStr);
-					else if (type == "float")
-						param.value = calculate<float>(valueStr);
+						param.value = convertParameter<int32_t>(value);
 					else
-						throw ParseException("Unrecognized parameter type `" + type + "`", lineNum);
+						param.value = value;
+
+					if (!expression.constant()) param.expression = trimmed(valueStr);
 
 					config.params.push_back(param);
 					break;
 				}
 				case Section::resources: {
+					if (type == "storageBuffer") {
+						config.storageBuffers.push_back({id, calculate<size_t>(valueStr)});
+						break;
+					}
+
+					if (type == "target") {
+						auto size = parseExpressions<2>(valueStr);
+						if (!size)
+							throw ParseException("expected target size of the form "
+							                     "'{width, height}'",
+							                     lineNum);
+						config.targets.push_back({id, name, size.value()});
+						break;
+					}
+
+					if (type == "storageImage") {
+						auto size = parseExpressions<2>(valueStr);
+						if (!size)
+							throw ParseException("expected storage image size of the form "
+							                     "'{width, height}'",
+							                     lineNum);
+						config.storageImages.push_back({id, size.value()});
+						break;
+					}
+
+					if (type == "buffer" || type == "lut") {
+						ModuleConfig::Table table = {};
+						table.id = id;
+
+						auto value = trimmed(valueStr);
+						if (value.size() >= 2 && value.front() == '{' && value.back() == '}') {
+							try {
+								std::stringstream values(value.substr(1, value.size() - 2));
+								table.values = parseValues(values);
+							} catch (const std::invalid_argument& e) {
+								throw ParseException(e.what(), lineNum);
+							}
+						} else {
+							std::stringstream{valueStr} >> std::quoted(table.path);
+						}
+
+						if (table.values.empty() && table.path.empty())
+							throw ParseException("expected a file or a list of values of the form "
+							                     "'{a, b, ...}'",
+							                     lineNum);
+						if (type == "lut" && table.values.size() % 4 != 0)
+							throw ParseException("lookup tables need four values per texel", lineNum);
+
+						(type == "buffer" ? config.buffers : config.luts).push_back(table);
+						break;
+					}
+
 					std::string path;
 					std::stringstream{valueStr} >> std::quoted(path);
 
 					if (type == "image")
 						config.images.push_back({id, path});
+					else if (type == "mesh")
+						config.meshes.push_back({id, name, path});
 					else
 						throw ParseException("Unrecognized resource type `" + type + "`", lineNum);
 					break;
@@ -126,5 +322,39 @@ ModuleConfig parseConfig(std::istream& stream) {
 			}
 		}
 	}
+
+	if (config.instanceCount) {
+		std::unordered_map<std::string, float> variables = {{"width", 1.f}, {"height", 1.f}};
+		for (const auto& param : config.params)
+			if (!param.dynamic) variables.emplace(param.name, 1.f);
+		try {
+			calculate<float>(config.instanceCount.value(), variables);
+		} catch (const std::exception&) {
+			throw ParseException(
+			    "failed to parse instance count '" + config.instanceCount.value() + "'",
+			    instanceCountLine);
+		}
+	}
 	return config;
 }
+
+std::vector<float> parseValues(std::istream& stream) {
+	std::vector<float> values;
+
+	std::string line;
+	while (std::getline(stream, line)) {
+		line = trimmed(line.substr(0, line.find('#')));
+		if (line.empty()) continue;
+
+		// a trailing comma continues the list on the next line
+		std::stringstream lineStream(line);
+		std::string value;
+		while (std::getline(lineStream, value, ',')) {
+			value = trimmed(value);
+			if (value.empty()) throw std::invalid_argument("expected a value between commas");
+			values.push_back(calculate<float>(value));
+		}
+	}
+
+	return values;
+}
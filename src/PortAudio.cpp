@@ -30,6 +30,10 @@ public:
 	std::atomic<bool> running;
 	std::atomic<bool> modified;
 	std::atomic<int> ups;
+	std::atomic<uint64_t> overruns{0};
+	// PortAudio does not report holes
+	std::atomic<uint64_t> holes{0};
+	std::atomic<uint64_t> droppedBlocks{0};
 	PaError _result;
 	PaStream* stream;
 
@@ -214,7 +218,7 @@ private:
 
 		(void)outputBuffer; /* Prevent unused variable warnings. */
 		(void)timeInfo;
-		(void)statusFlags;
+		if (statusFlags & paInputOverflow) ++audio->overruns;
 
 		static float maxAmp = 0.f;
 		const float tgtVol = 9.99f;
@@ -244,7 +248,7 @@ private:
 		for (size_t i = 1; i * audio->settings.sampleSize < audio->settings.bufferSize; ++i)
 			std::swap(audio->ppAudioBuffer[i - 1], audio->ppAudioBuffer[i]);
 		audio->audioMutexLock.unlock();
-		audio->modified = true;
+		if (audio->modified.exchange(true)) ++audio->droppedBlocks;
 
 		++numUpdates;
 		std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
@@ -275,6 +279,17 @@ bool AudioSampler::modified() const { return audioSamplerImpl->modified; }
 
 int AudioSampler::ups() const { return audioSamplerImpl->ups; }
 
+AudioSampler::Stats AudioSampler::stats() const {
+	Stats stats;
+	stats.overruns = audioSamplerImpl->overruns.load(std::memory_order_relaxed);
+	stats.holes = audioSamplerImpl->holes.load(std::memory_order_relaxed);
+	stats.droppedBlocks = audioSamplerImpl->droppedBlocks.load(std::memory_order_relaxed);
+	return stats;
+}
+
+// the latency of the output whose audio is captured is not known
+std::optional<double> AudioSampler::playbackLatency() const { return std::nullopt; }
+
 void AudioSampler::copyData(AudioData& audioData) { audioSamplerImpl->copyData(audioData); }
 
 void AudioSampler::rethrowExceptions() { return audioSamplerImpl->rethrowExceptions(); }
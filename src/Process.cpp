@@ -2,7 +2,9 @@
 #include <complex>
 #include <numeric>
 #include <utility>
+#include <vector>
 
+#include "Calculate.hpp"
 #include "Data.hpp"
 #include "Process.hpp"
 
@@ -57,6 +59,21 @@ public:
 		}
 
 		wfCoeff = M_PI / (settings.size - 1);
+
+		// bake the weight of every bin once instead of evaluating it for every frame
+		const size_t bins = inputSize / 2;
+		std::vector<float> n(bins);
+		std::vector<float> f(bins);
+		for (size_t i = 0; i < bins; ++i) {
+			n[i] = static_cast<float>(i);
+			f[i] = static_cast<float>(i) * settings.sampleRate / inputSize;
+		}
+
+		weights.resize(bins);
+		const float* variables[] = {n.data(), f.data()};
+		Expression(settings.equaliser, {"n", "f"}).evaluate(variables, weights.data(), bins);
+		for (size_t i = 0; i < bins; ++i)
+			weights[i] *= 170.f * amplitude * std::log10(2.f * i / inputSize + 1.05f) / inputSize;
 	}
 
 	void processSignal(AudioData& audioData) {
@@ -67,6 +84,30 @@ public:
 		if (smooth) smoothBuffer(audioData);
 	}
 
+	void processStage(AudioData& audioData, Stage stage) {
+		switch (stage) {
+			case Stage::window:
+				windowFunction(audioData);
+				break;
+			case Stage::fft:
+				fft(reinterpret_cast<std::complex<float>*>(audioData.buffer),
+				    channels == 1 ? inputSize / 2 : inputSize);
+				break;
+			case Stage::magnitudes:
+				magnitudes(audioData);
+				break;
+			case Stage::equalise:
+				equalise(audioData);
+				break;
+			case Stage::volume:
+				calculateVolume(audioData);
+				break;
+			case Stage::smoothing:
+				if (smooth) smoothBuffer(audioData);
+				break;
+		}
+	}
+
 	~ProcessImpl() {
 		if (smooth) delete[] convolutionVec;
 	}
@@ -82,6 +123,8 @@ private:
 	unsigned char channels;
 
 	float amplitude;
+	// of each frequency bin
+	std::vector<float> weights;
 
 	// window function
 	float wfCoeff;
@@ -140,9 +183,8 @@ private:
 
 	void equalise(AudioData& audioData) const {
 		for (size_t n = 0; n < inputSize / 2; ++n) {
-			float weight = 170.f * amplitude * std::log10(2.f * n / inputSize + 1.05f) / inputSize;
-			audioData.lBuffer[n] *= weight;
-			audioData.rBuffer[n] *= weight;
+			audioData.lBuffer[n] *= weights[n];
+			audioData.rBuffer[n] *= weights[n];
 		}
 	}
 
@@ -212,20 +254,9 @@ private:
 	}
 
 	static void bitReverseShuffle(std::complex<float>* first, size_t size) {
-/**
- * num_bits = log2(size).
- * here i am assuming that the fft size is less than 2^16,
- * that it is not 0 and that it is a power of 2
- */
-#ifdef __builtin_ctz
-		uint8_t numBits = __builtin_ctz(size);  // count number of trailing 0s
-#else
-		uint8_t numBits = 15;
-		if (size & 0x00FF) numBits -= 8;
-		if (size & 0x0F0F) numBits -= 4;
-		if (size & 0x3333) numBits -= 2;
-		if (size & 0x5555) numBits -= 1;
-#endif
+		// num_bits = log2(size), assuming that size is a power of 2
+		uint8_t numBits = 0;
+		while ((size_t{1} << numBits) < size) ++numBits;
 
 		for (size_t i = 0; i < size; ++i) {
 			size_t j = reverseBits(i, numBits);
@@ -256,4 +287,8 @@ Process& Process::operator=(Process&& other) noexcept {
 
 void Process::processSignal(AudioData& audioData) { impl->processSignal(audioData); }
 
+void Process::processStage(AudioData& audioData, Stage stage) {
+	impl->processStage(audioData, stage);
+}
+
 Process::~Process() { delete impl; }
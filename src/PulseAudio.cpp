@@ -1,4 +1,5 @@
 // C++ standard libraries
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
@@ -31,6 +32,14 @@ public:
 	std::atomic<bool> running;
 	std::atomic<bool> modified;
 	std::atomic<int> ups;
+	// pa_simple does not report overruns or holes
+	std::atomic<uint64_t> overruns{0};
+	std::atomic<uint64_t> holes{0};
+	std::atomic<uint64_t> droppedBlocks{0};
+	// milliseconds of audio queued by the monitored sink, negative if unknown
+	std::atomic<double> sinkLatency{-1.0};
+	// milliseconds of audio recorded but not yet read
+	std::atomic<double> recordLatency{0.0};
 
 	AudioSamplerImpl(const Settings& audioSettings) {
 		init(audioSettings);
@@ -56,6 +65,12 @@ public:
 		delete[] pSampleBuffer;
 
 		pa_simple_free(s);
+
+		if (context) {
+			pa_context_disconnect(context);
+			pa_context_unref(context);
+		}
+		pa_mainloop_free(mainloop);
 	}
 
 	void copyData(AudioData& audioData) {
@@ -91,7 +106,12 @@ private:
 	// pulseaudio
 	pa_simple* s;
 
+	// kept connected after querySink() so that run() can refresh the sink latency
 	pa_mainloop* mainloop;
+	pa_context* context = nullptr;
+	uint32_t monitoredSink = PA_INVALID_INDEX;
+	// set while a request on context is waiting for its reply
+	bool querying = false;
 
 	int error;
 
@@ -113,9 +133,11 @@ private:
 		for (uint32_t i = 0; i < settings.bufferSize / settings.sampleSize; ++i)
 			ppAudioBuffer[i] = new float[settings.sampleSize];
 
-		if (settings.sinkName.empty()) getDefaultSink();
+		querySink();
 
 		std::clog << "Using PulseAudio sink: \"" << settings.sinkName << "\"\n";
+		if (const double latency = sinkLatency.load(std::memory_order_relaxed); latency >= 0.0)
+			std::clog << "Sink latency: " << latency << " ms\n";
 		setupPulse();
 	}
 
@@ -127,13 +149,18 @@ private:
 			if (pa_simple_read(s, pSampleBuffer, sizeof(float) * settings.sampleSize, &error) < 0)
 				throw std::runtime_error(std::string(LOCATION "pa_simple_read() failed: ") +
 				                         pa_strerror(error));
+			if (const pa_usec_t latency = pa_simple_get_latency(s, &error);
+			    latency != static_cast<pa_usec_t>(-1))
+				recordLatency.store(latency / 1e3, std::memory_order_relaxed);
+			// dispatch the reply to refreshSinkLatency() without blocking the read
+			if (querying) pa_mainloop_iterate(mainloop, 0, nullptr);
 
 			audioMutexLock.lock();
 			std::swap(ppAudioBuffer[0], pSampleBuffer);
 			for (size_t i = 1; i < settings.bufferSize / settings.sampleSize; ++i)
 				std::swap(ppAudioBuffer[i - 1], ppAudioBuffer[i]);
 			audioMutexLock.unlock();
-			this->modified = true;
+			if (this->modified.exchange(true)) ++droppedBlocks;
 
 			++numUpdates;
 			std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
@@ -142,28 +169,48 @@ private:
 				ups = numUpdates;
 				numUpdates = 0;
 				lastFrame = currentTime;
+				refreshSinkLatency();
 			}
 		}
 	}
 
-	void getDefaultSink() {
+	/**
+	 * Finds the default sink if no sink name is set, and the latency of the sink whose monitor
+	 * is sampled. The latency changes with the output, e.g. the codec of a Bluetooth device, so
+	 * the context stays connected for refreshSinkLatency().
+	 */
+	void querySink() {
 		pa_mainloop_api* mainloopAPI;
-		pa_context* context;
 
 		mainloop = pa_mainloop_new();
 		mainloopAPI = pa_mainloop_get_api(mainloop);
 		context = pa_context_new(mainloopAPI, "Vkav");
 
+		pa_context_set_state_callback(context, contextStateCallback, reinterpret_cast<void*>(this));
+
+		querying = true;
 		pa_context_connect(context, NULL, PA_CONTEXT_NOFLAGS, NULL);
 
-		pa_context_set_state_callback(context, contextStateCallback, reinterpret_cast<void*>(this));
+		// not pa_mainloop_run(), a quit mainloop cannot be iterated again
+		while (querying && pa_mainloop_iterate(mainloop, 1, nullptr) >= 0) {
+		}
 
-		pa_mainloop_run(mainloop, nullptr);
+		if (pa_context_get_state(context) != PA_CONTEXT_READY ||
+		    monitoredSink == PA_INVALID_INDEX) {
+			pa_context_disconnect(context);
+			pa_context_unref(context);
+			context = nullptr;
+		}
+	}
 
-		pa_context_disconnect(context);
-		pa_context_unref(context);
+	// called once a second by run(), the reply is dispatched by the following reads
+	void refreshSinkLatency() {
+		if (!context || querying) return;
+		if (pa_context_get_state(context) != PA_CONTEXT_READY) return;
 
-		pa_mainloop_free(mainloop);
+		querying = true;
+		pa_operation_unref(
+		    pa_context_get_sink_info_by_index(context, monitoredSink, sinkCallback, this));
 	}
 
 	void setupPulse() {
@@ -184,12 +231,39 @@ private:
 			                         pa_strerror(error));
 	}
 
-	static void callback(pa_context*, const pa_server_info* i, void* userdata) {
+	static void callback(pa_context* c, const pa_server_info* i, void* userdata) {
 		auto audio = reinterpret_cast<AudioSamplerImpl*>(userdata);
 		audio->settings.sinkName = i->default_sink_name;
 		audio->settings.sinkName += ".monitor";
 
-		pa_mainloop_quit(audio->mainloop, 0);
+		pa_operation_unref(pa_context_get_source_info_by_name(
+		    c, audio->settings.sinkName.c_str(), sourceCallback, userdata));
+	}
+
+	static void sourceCallback(pa_context* c, const pa_source_info* i, int eol, void* userdata) {
+		auto audio = reinterpret_cast<AudioSamplerImpl*>(userdata);
+		if (eol) {
+			// sinkCallback finishes once the latency of the monitored sink is known
+			if (eol < 0 || audio->monitoredSink == PA_INVALID_INDEX) audio->querying = false;
+			return;
+		}
+
+		if (i->monitor_of_sink != PA_INVALID_INDEX) {
+			audio->monitoredSink = i->monitor_of_sink;
+			pa_operation_unref(
+			    pa_context_get_sink_info_by_index(c, i->monitor_of_sink, sinkCallback, userdata));
+		}
+	}
+
+	static void sinkCallback(pa_context*, const pa_sink_info* i, int eol, void* userdata) {
+		auto audio = reinterpret_cast<AudioSamplerImpl*>(userdata);
+		if (eol) {
+			audio->querying = false;
+			return;
+		}
+
+		if (i->flags & PA_SINK_LATENCY)
+			audio->sinkLatency.store(i->latency / 1e3, std::memory_order_relaxed);
 	}
 
 	static void contextStateCallback(pa_context* c, void* userdata) {
@@ -197,11 +271,15 @@ private:
 
 		switch (pa_context_get_state(c)) {
 			case PA_CONTEXT_READY:
-				pa_operation_unref(pa_context_get_server_info(c, callback, userdata));
+				if (audio->settings.sinkName.empty())
+					pa_operation_unref(pa_context_get_server_info(c, callback, userdata));
+				else
+					pa_operation_unref(pa_context_get_source_info_by_name(
+					    c, audio->settings.sinkName.c_str(), sourceCallback, userdata));
 				break;
 			case PA_CONTEXT_FAILED:
 			case PA_CONTEXT_TERMINATED:
-				pa_mainloop_quit(audio->mainloop, 0);
+				audio->querying = false;
 				break;
 			default:
 				// Do nothing
@@ -227,6 +305,21 @@ bool AudioSampler::modified() const { return audioSamplerImpl->modified; }
 
 int AudioSampler::ups() const { return audioSamplerImpl->ups; }
 
+AudioSampler::Stats AudioSampler::stats() const {
+	Stats stats;
+	stats.overruns = audioSamplerImpl->overruns.load(std::memory_order_relaxed);
+	stats.holes = audioSamplerImpl->holes.load(std::memory_order_relaxed);
+	stats.droppedBlocks = audioSamplerImpl->droppedBlocks.load(std::memory_order_relaxed);
+	return stats;
+}
+
+std::optional<double> AudioSampler::playbackLatency() const {
+	const double sinkLatency = audioSamplerImpl->sinkLatency.load(std::memory_order_relaxed);
+	if (sinkLatency < 0.0) return std::nullopt;
+	return std::max(sinkLatency - audioSamplerImpl->recordLatency.load(std::memory_order_relaxed),
+	                0.0);
+}
+
 void AudioSampler::copyData(AudioData& audioData) { audioSamplerImpl->copyData(audioData); }
 
 void AudioSampler::rethrowExceptions() { return audioSamplerImpl->rethrowExceptions(); }
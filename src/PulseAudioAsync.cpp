@@ -1,4 +1,5 @@
 // C++ standard libraries
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
@@ -30,6 +31,13 @@ public:
 	std::atomic<bool> running;
 	std::atomic<bool> modified{false};
 	std::atomic<int> ups;
+	std::atomic<uint64_t> overruns{0};
+	std::atomic<uint64_t> holes{0};
+	std::atomic<uint64_t> droppedBlocks{0};
+	// milliseconds of audio queued by the monitored sink, negative if unknown
+	std::atomic<double> sinkLatency{-1.0};
+	// milliseconds of audio recorded but not yet read
+	std::atomic<double> recordLatency{0.0};
 
 	AudioSamplerImpl(const Settings& audioSettings) {
 		settings.channels = audioSettings.channels;
@@ -51,6 +59,7 @@ public:
 
 		std::clog << "Using PulseAudio sink: \"" << settings.sinkName << "\"\n";
 		initStream();
+		querySink();
 		running = true;
 	}
 
@@ -104,6 +113,8 @@ private:
 	pa_threaded_mainloop* mainloop;
 	pa_context* context;
 	pa_stream* stream;
+	// index of the sink whose monitor is sampled, only used by the mainloop thread
+	uint32_t monitoredSink = PA_INVALID_INDEX;
 
 	void getDefaultSink() {
 		running = true;
@@ -151,6 +162,7 @@ private:
 		attr.fragsize = sizeof(float) * settings.sampleSize;
 
 		pa_stream_set_read_callback(stream, read_callback, reinterpret_cast<void*>(this));
+		pa_stream_set_overflow_callback(stream, overflow_callback, reinterpret_cast<void*>(this));
 
 		if (int err = pa_stream_connect_record(stream, settings.sinkName.c_str(), &attr,
 		                                       PA_STREAM_ADJUST_LATENCY);
@@ -159,6 +171,25 @@ private:
 			    std::string(LOCATION "failed to connect pulseaudio stream!: ") + pa_strerror(err));
 	}
 
+	/**
+	 * Looks up the sink whose monitor is sampled. Its latency changes with the output, e.g. the
+	 * codec of a Bluetooth device, so read_callback refreshes it once a second.
+	 */
+	void querySink() {
+		pa_threaded_mainloop_lock(mainloop);
+		pa_operation_unref(pa_context_get_source_info_by_name(context, settings.sinkName.c_str(),
+		                                                      sourceCallback, this));
+		pa_threaded_mainloop_unlock(mainloop);
+	}
+
+	// called by read_callback, once the stream is ready
+	void updateLatencies() {
+		if (monitoredSink != PA_INVALID_INDEX)
+			pa_operation_unref(
+			    pa_context_get_sink_info_by_index(context, monitoredSink, sinkCallback, this));
+		pa_operation_unref(pa_stream_update_timing_info(stream, timingCallback, this));
+	}
+
 	static void read_callback(pa_stream* stream, size_t nBytes, void* userData) {
 		static auto lastFrame = std::chrono::steady_clock::now();
 		static int numUpdates = 0;
@@ -168,7 +199,8 @@ private:
 		size_t size;
 		pa_stream_peek(stream, reinterpret_cast<const void**>(&buf), &size);
 		if (!buf) {
-			// There is a hole in the stream
+			// There is a hole in the stream, unless it is empty
+			if (size) audio->holes.fetch_add(1, std::memory_order_relaxed);
 			pa_stream_drop(stream);
 			return;
 		}
@@ -177,7 +209,8 @@ private:
 		for (size_t i = 0; i < size; ++i, ++audio->bufPos) {
 			if (audio->bufPos == audio->settings.sampleSize) {
 				audio->audioMutexLock.lock();
-				audio->modified.store(true, std::memory_order_relaxed);
+				if (audio->modified.exchange(true, std::memory_order_relaxed))
+					audio->droppedBlocks.fetch_add(1, std::memory_order_relaxed);
 				std::swap(audio->ppAudioBuffer[0], audio->pSampleBuffer);
 				for (size_t i = 1; i * audio->settings.sampleSize < audio->settings.bufferSize; ++i)
 					std::swap(audio->ppAudioBuffer[i - 1], audio->ppAudioBuffer[i]);
@@ -190,6 +223,7 @@ private:
 					audio->ups.store(numUpdates, std::memory_order_relaxed);
 					numUpdates = 0;
 					lastFrame = currentTime;
+					audio->updateLatencies();
 				}
 				audio->bufPos = 0;
 			}
@@ -201,6 +235,35 @@ private:
 		pa_stream_drop(stream);
 	}
 
+	static void overflow_callback(pa_stream*, void* userData) {
+		reinterpret_cast<AudioSamplerImpl*>(userData)->overruns.fetch_add(
+		    1, std::memory_order_relaxed);
+	}
+
+	static void sourceCallback(pa_context* c, const pa_source_info* i, int eol, void* userdata) {
+		if (eol || i->monitor_of_sink == PA_INVALID_INDEX) return;
+
+		reinterpret_cast<AudioSamplerImpl*>(userdata)->monitoredSink = i->monitor_of_sink;
+		pa_operation_unref(
+		    pa_context_get_sink_info_by_index(c, i->monitor_of_sink, sinkCallback, userdata));
+	}
+
+	static void sinkCallback(pa_context*, const pa_sink_info* i, int eol, void* userdata) {
+		if (eol || !(i->flags & PA_SINK_LATENCY)) return;
+
+		reinterpret_cast<AudioSamplerImpl*>(userdata)->sinkLatency.store(
+		    i->latency / 1e3, std::memory_order_relaxed);
+	}
+
+	static void timingCallback(pa_stream* stream, int success, void* userData) {
+		pa_usec_t latency;
+		int negative;
+		if (!success || pa_stream_get_latency(stream, &latency, &negative) != 0) return;
+
+		reinterpret_cast<AudioSamplerImpl*>(userData)->recordLatency.store(
+		    negative ? 0.0 : latency / 1e3, std::memory_order_relaxed);
+	}
+
 	static void callback(pa_context*, const pa_server_info* i, void* userdata) {
 		auto audio = reinterpret_cast<AudioSamplerImpl*>(userdata);
 		audio->settings.sinkName = i->default_sink_name;
@@ -259,6 +322,21 @@ bool AudioSampler::modified() const {
 
 int AudioSampler::ups() const { return audioSamplerImpl->ups.load(std::memory_order_relaxed); }
 
+AudioSampler::Stats AudioSampler::stats() const {
+	Stats stats;
+	stats.overruns = audioSamplerImpl->overruns.load(std::memory_order_relaxed);
+	stats.holes = audioSamplerImpl->holes.load(std::memory_order_relaxed);
+	stats.droppedBlocks = audioSamplerImpl->droppedBlocks.load(std::memory_order_relaxed);
+	return stats;
+}
+
+std::optional<double> AudioSampler::playbackLatency() const {
+	const double sinkLatency = audioSamplerImpl->sinkLatency.load(std::memory_order_relaxed);
+	if (sinkLatency < 0.0) return std::nullopt;
+	return std::max(sinkLatency - audioSamplerImpl->recordLatency.load(std::memory_order_relaxed),
+	                0.0);
+}
+
 void AudioSampler::copyData(AudioData& audioData) { audioSamplerImpl->copyData(audioData); }
 
 void AudioSampler::rethrowExceptions() { return audioSamplerImpl->rethrowExceptions(); }
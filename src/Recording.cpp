@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(LINUX) || defined(MACOS)
+	#define RECORDING_MMAP_SUPPORTED
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "Data.hpp"
+#include "Recording.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	constexpr char recordingMagic[8] = {'V', 'K', 'A', 'V', 'R', 'E', 'C', 'S'};
+	constexpr uint32_t recordingVersion = 1;
+
+	struct RecordingHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t audioSize;
+	};
+
+	// followed by audioSize values of lBuffer, then of rBuffer
+	struct RecordHeader {
+		int64_t timestamp;
+		float lVolume;
+		float rVolume;
+	};
+
+	size_t recordSize(size_t audioSize) {
+		return sizeof(RecordHeader) + 2 * audioSize * sizeof(float);
+	}
+}  // namespace
+
+RecordingWriter::RecordingWriter(const std::filesystem::path& path, size_t audioSize)
+    : file(path, std::ios::out | std::ios::binary | std::ios::trunc), audioSize(audioSize) {
+	if (!file.is_open())
+		throw std::runtime_error(LOCATION "failed to open recording '" + path.string() + "'!");
+
+	RecordingHeader header = {};
+	std::memcpy(header.magic, recordingMagic, sizeof(recordingMagic));
+	header.version = recordingVersion;
+	header.audioSize = static_cast<uint32_t>(audioSize);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void RecordingWriter::write(const AudioData& audioData, std::chrono::nanoseconds timestamp) {
+	RecordHeader header = {};
+	header.timestamp = timestamp.count();
+	header.lVolume = audioData.lVolume;
+	header.rVolume = audioData.rVolume;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(audioData.lBuffer), audioSize * sizeof(float));
+	file.write(reinterpret_cast<const char*>(audioData.rBuffer), audioSize * sizeof(float));
+	if (!file) throw std::runtime_error(LOCATION "failed to write recording!");
+}
+
+Recording::Recording(const std::filesystem::path& path) {
+#ifdef RECORDING_MMAP_SUPPORTED
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::runtime_error(LOCATION "failed to open recording '" + path.string() + "'!");
+
+	struct stat status;
+	if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(RecordingHeader)) {
+		dataSize = status.st_size;
+		void* mapping = mmap(nullptr, dataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) data = static_cast<const std::byte*>(mapping);
+	}
+	close(fd);
+	if (!data)
+		throw std::runtime_error(LOCATION "failed to map recording '" + path.string() + "'!");
+#else
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		throw std::runtime_error(LOCATION "failed to open recording '" + path.string() + "'!");
+	contents.resize(file.tellg());
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char*>(contents.data()), contents.size()))
+		throw std::runtime_error(LOCATION "failed to read recording '" + path.string() + "'!");
+	data = contents.data();
+	dataSize = contents.size();
+#endif
+
+	RecordingHeader header = {};
+	if (dataSize >= sizeof(header)) std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, recordingMagic, sizeof(recordingMagic)) != 0) {
+		unmap();
+		throw std::runtime_error(LOCATION "'" + path.string() + "' is not a recording!");
+	}
+	if (header.version != recordingVersion) {
+		unmap();
+		throw std::runtime_error(LOCATION "unsupported recording version " +
+		                         std::to_string(header.version) + " in '" + path.string() + "'!");
+	}
+
+	valueCount = header.audioSize;
+	recordCount = (dataSize - sizeof(header)) / recordSize(valueCount);
+}
+
+Recording::~Recording() { unmap(); }
+
+Recording::Recording(Recording&& other) noexcept { *this = std::move(other); }
+
+Recording& Recording::operator=(Recording&& other) noexcept {
+	std::swap(data, other.data);
+	std::swap(dataSize, other.dataSize);
+	std::swap(contents, other.contents);
+	std::swap(valueCount, other.valueCount);
+	std::swap(recordCount, other.recordCount);
+	return *this;
+}
+
+std::chrono::nanoseconds Recording::timestamp(size_t record) const {
+	int64_t timestamp;
+	std::memcpy(&timestamp, recordData(record) + offsetof(RecordHeader, timestamp),
+	            sizeof(timestamp));
+	return std::chrono::nanoseconds(timestamp);
+}
+
+size_t Recording::find(std::chrono::nanoseconds timestamp) const {
+	// first record later than timestamp, timestamps never decrease
+	size_t first = 0, count = recordCount;
+	while (count > 0) {
+		const size_t step = count / 2;
+		if (this->timestamp(first + step) <= timestamp) {
+			first += step + 1;
+			count -= step + 1;
+		} else {
+			count = step;
+		}
+	}
+	return first ? first - 1 : 0;
+}
+
+void Recording::copyRecord(size_t record, AudioData& audioData) const {
+	const std::byte* recordStart = recordData(record);
+	RecordHeader header;
+	std::memcpy(&header, recordStart, sizeof(header));
+	audioData.lVolume = header.lVolume;
+	audioData.rVolume = header.rVolume;
+
+	const std::byte* values = recordStart + sizeof(header);
+	std::memcpy(audioData.lBuffer, values, valueCount * sizeof(float));
+	std::memcpy(audioData.rBuffer, values + valueCount * sizeof(float), valueCount * sizeof(float));
+}
+
+const std::byte* Recording::recordData(size_t record) const {
+	if (record >= recordCount)
+		throw std::out_of_range(LOCATION "record " + std::to_string(record) +
+		                        " is out of range!");
+	return data + sizeof(RecordingHeader) + record * recordSize(valueCount);
+}
+
+void Recording::unmap() {
+#ifdef RECORDING_MMAP_SUPPORTED
+	if (data) munmap(const_cast<std::byte*>(data), dataSize);
+#endif
+	data = nullptr;
+	dataSize = 0;
+	contents.clear();
+}
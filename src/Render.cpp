@@ -5,23 +5,38 @@
 #include <array>
 #include <cctype>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
+#include "Allocator.hpp"
 #include "Calculate.hpp"
 #include "Data.hpp"
+#include "Fusion.hpp"
+#include "Half.hpp"
 #include "Image.hpp"
+#include "Mesh.hpp"
 #include "ModuleConfig.hpp"
 #include "NativeWindowHints.hpp"
 #include "Render.hpp"
+#include "RenderGraph.hpp"
+#include "ShaderCompiler.hpp"
+#include "Trace.hpp"
 #include "Version.hpp"
 
 #ifdef NDEBUG
@@ -77,9 +92,164 @@ namespace {
 		std::vector<VkPresentModeKHR> presentModes;
 	};
 
+	/**
+	 * Sub-allocates device memory from large blocks per memory type instead of allocating it
+	 * for every resource. Host visible blocks stay mapped for as long as they exist.
+	 */
+	class MemoryPool {
+	public:
+		struct Allocation {
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			// address of the allocation if the memory is host visible
+			void* mapped = nullptr;
+		};
+
+		struct Stats {
+			size_t allocations = 0;
+			size_t blocks = 0;
+			VkDeviceSize used = 0;
+			VkDeviceSize reserved = 0;
+		};
+
+		MemoryPool(VkPhysicalDevice physicalDevice, VkDevice device) : device(device) {
+			vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+			VkPhysicalDeviceProperties deviceProperties;
+			vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+			granularity = deviceProperties.limits.bufferImageGranularity;
+		}
+
+		~MemoryPool() {
+			for (auto& block : blocks) vkFreeMemory(device, block.memory, nullptr);
+		}
+
+		/**
+		 * linear is true for buffers and linearly tiled images. Transient allocations, such as
+		 * staging buffers, are placed one after another in blocks of their own.
+		 */
+		Allocation allocate(const VkMemoryRequirements& requirements, uint32_t memoryType,
+		                    bool linear, bool transient) {
+			std::lock_guard lock(mutex);
+			const auto strategy =
+			    transient ? BlockAllocator::Strategy::linear : BlockAllocator::Strategy::freeList;
+
+			for (auto& block : blocks) {
+				if (block.memoryType != memoryType || block.allocator.strategy() != strategy)
+					continue;
+				if (auto offset = block.allocator.allocate(requirements.size,
+				                                           requirements.alignment, linear))
+					return allocation(block, *offset);
+			}
+
+			// large resources get a block of their own
+			VkDeviceSize size = blockSize(memoryType, strategy);
+			if (requirements.size > size / 2) size = requirements.size;
+			auto& block = createBlock(memoryType, size, strategy);
+			return allocation(
+			    block, block.allocator.allocate(requirements.size, requirements.alignment, linear)
+			               .value());
+		}
+
+		void free(const Allocation& allocation) {
+			if (allocation.memory == VK_NULL_HANDLE) return;
+			std::lock_guard lock(mutex);
+
+			auto block = std::find_if(blocks.begin(), blocks.end(), [&](const auto& block) {
+				return block.memory == allocation.memory;
+			});
+			block->allocator.free(allocation.offset);
+			if (!block->allocator.empty()) return;
+
+			// keep a spare block of every kind so that resources which are recreated, such as
+			// those of modules, do not allocate it again
+			const auto strategy = block->allocator.strategy();
+			const bool spare =
+			    block->allocator.size() == blockSize(block->memoryType, strategy) &&
+			    std::none_of(blocks.begin(), blocks.end(), [&](const auto& other) {
+				    return &other != &*block && other.memoryType == block->memoryType &&
+				           other.allocator.strategy() == strategy && other.allocator.empty();
+			    });
+			if (spare) return;
+
+			vkFreeMemory(device, block->memory, nullptr);
+			blocks.erase(block);
+		}
+
+		Stats stats() {
+			std::lock_guard lock(mutex);
+			Stats stats;
+			stats.blocks = blocks.size();
+			for (const auto& block : blocks) {
+				stats.allocations += block.allocator.count();
+				stats.used += block.allocator.used();
+				stats.reserved += block.allocator.size();
+			}
+			return stats;
+		}
+
+	private:
+		struct Block {
+			VkDeviceMemory memory;
+			uint32_t memoryType;
+			void* mapped;
+			BlockAllocator allocator;
+		};
+
+		VkDevice device;
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		VkDeviceSize granularity;
+
+		std::mutex mutex;
+		std::vector<Block> blocks;
+
+		// an eighth of the heap at most, so that small heaps are not used up by a single block
+		VkDeviceSize blockSize(uint32_t memoryType, BlockAllocator::Strategy strategy) const {
+			const auto heapIndex = memoryProperties.memoryTypes[memoryType].heapIndex;
+			const VkDeviceSize size = strategy == BlockAllocator::Strategy::linear
+			                              ? VkDeviceSize(16) << 20
+			                              : VkDeviceSize(64) << 20;
+			return std::min(size, memoryProperties.memoryHeaps[heapIndex].size / 8);
+		}
+
+		Block& createBlock(uint32_t memoryType, VkDeviceSize size,
+		                   BlockAllocator::Strategy strategy) {
+			VkMemoryAllocateInfo allocInfo = {};
+			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocInfo.allocationSize = size;
+			allocInfo.memoryTypeIndex = memoryType;
+
+			Block block = {VK_NULL_HANDLE, memoryType, nullptr,
+			               BlockAllocator(size, granularity, strategy)};
+			if (vkAllocateMemory(device, &allocInfo, nullptr, &block.memory) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to allocate device memory!");
+
+			if (memoryProperties.memoryTypes[memoryType].propertyFlags &
+			    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+				if (vkMapMemory(device, block.memory, 0, VK_WHOLE_SIZE, 0, &block.mapped) !=
+				    VK_SUCCESS) {
+					vkFreeMemory(device, block.memory, nullptr);
+					throw std::runtime_error(LOCATION "failed to map device memory!");
+				}
+			}
+
+			blocks.push_back(std::move(block));
+			return blocks.back();
+		}
+
+		static Allocation allocation(const Block& block, VkDeviceSize offset) {
+			Allocation allocation;
+			allocation.memory = block.memory;
+			allocation.offset = offset;
+			if (block.mapped) allocation.mapped = static_cast<char*>(block.mapped) + offset;
+			return allocation;
+		}
+	};
+
 	struct Device {
 		VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
 		VkDevice device;
+		MemoryPool* memoryPool = nullptr;
 
 		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
 			VkPhysicalDeviceMemoryProperties memProperties;
@@ -99,7 +269,7 @@ namespace {
 		Device device;
 
 		VkImage image;
-		VkDeviceMemory memory;
+		MemoryPool::Allocation memory;
 		VkImageView view;
 		VkSampler sampler;
 
@@ -107,7 +277,7 @@ namespace {
 
 		Image(Device device, uint32_t width, uint32_t height, VkImageType imageType,
 		      VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
-		      VkMemoryPropertyFlags properties) {
+		      VkMemoryPropertyFlags properties, uint32_t mipLevels = 1) {
 			this->device = device;
 			VkImageCreateInfo imageInfo = {};
 			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -115,7 +285,7 @@ namespace {
 			imageInfo.extent.width = width;
 			imageInfo.extent.height = height;
 			imageInfo.extent.depth = 1;
-			imageInfo.mipLevels = 1;
+			imageInfo.mipLevels = mipLevels;
 			imageInfo.arrayLayers = 1;
 			imageInfo.format = format;
 			imageInfo.tiling = tiling;
@@ -130,37 +300,57 @@ namespace {
 			VkMemoryRequirements memRequirements;
 			vkGetImageMemoryRequirements(device.device, image, &memRequirements);
 
-			VkMemoryAllocateInfo allocInfo = {};
-			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-			allocInfo.allocationSize = memRequirements.size;
-			allocInfo.memoryTypeIndex =
-			    device.findMemoryType(memRequirements.memoryTypeBits, properties);
+			memory = device.memoryPool->allocate(
+			    memRequirements, device.findMemoryType(memRequirements.memoryTypeBits, properties),
+			    tiling == VK_IMAGE_TILING_LINEAR, false);
 
-			if (vkAllocateMemory(device.device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
-				throw std::runtime_error(LOCATION "failed to allocate image memory!");
-
-			vkBindImageMemory(device.device, image, memory, 0);
+			vkBindImageMemory(device.device, image, memory.memory, memory.offset);
 		}
 
 		static void destroy(Image image) {
 			vkDestroySampler(image.device.device, image.sampler, nullptr);
 			vkDestroyImageView(image.device.device, image.view, nullptr);
 			vkDestroyImage(image.device.device, image.image, nullptr);
-			vkFreeMemory(image.device.device, image.memory, nullptr);
+			image.device.memoryPool->free(image.memory);
 		}
 	};
 
 	typedef std::variant<uint32_t, int32_t, float> SpecializationConstant;
 
+	// audioSize, smoothingLevel, width, height, vertexCount and instanceCount
+	constexpr uint32_t builtinConstantCount = 6;
+
 	struct SpecializationConstants {
 		std::vector<SpecializationConstant> data;
 		std::vector<VkSpecializationMapEntry> specializationInfo;
 	};
 
+	struct DynamicParameter {
+		uint32_t id;
+		std::string name;
+		SpecializationConstant value;
+		// evaluated with the frame variables at the start of every frame if set
+		std::optional<Expression> expression;
+	};
+
 	struct GraphicsPipeline {
-		VkPipeline graphicsPipeline;
-		VkShaderModule fragShaderModule;
-		VkShaderModule vertShaderModule;
+		VkPipeline graphicsPipeline = VK_NULL_HANDLE;
+		VkShaderModule fragShaderModule = VK_NULL_HANDLE;
+		VkShaderModule vertShaderModule = VK_NULL_HANDLE;
+
+		// number of the layer directory
+		uint32_t directory = 1;
+		// index of the render target drawn to, the window if unset
+		std::optional<uint32_t> target;
+		// indices of the render targets sampled
+		std::vector<uint32_t> inputs;
+		// index of the mesh drawn, the vertices are generated by the vertex shader if unset
+		std::optional<uint32_t> mesh;
+	};
+
+	struct ComputePipeline {
+		VkPipeline computePipeline = VK_NULL_HANDLE;
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
 	};
 
 	template <class resourceType>
@@ -171,41 +361,20 @@ namespace {
 		resourceType rsrc;
 	};
 
-	struct Module {
-		std::filesystem::path location;
-
-		std::vector<GraphicsPipeline> layers;
-		SpecializationConstants specializationConstants;
-
-		std::vector<Resource<Image>> images;
-
-		// Name of the fragment shader function to call
-		std::string moduleName = "main";
-		uint32_t vertexCount = 6;
-
-		static void destroy(VkDevice device, Module& module) {
-			for (auto& layer : module.layers) {
-				vkDestroyShaderModule(device, layer.fragShaderModule, nullptr);
-				vkDestroyShaderModule(device, layer.vertShaderModule, nullptr);
-			}
-
-			for (auto& image : module.images) Image::destroy(image.rsrc);
-		}
-	};
-
 	struct Buffer {
 		Device device;
 
 		VkBuffer buffer;
-		VkDeviceMemory memory;
+		MemoryPool::Allocation memory;
 		VkBufferView view = VK_NULL_HANDLE;
 
 		VkDeviceSize size;
 
 		Buffer() = default;
 
+		// transient buffers, such as staging buffers, are destroyed shortly after being created
 		Buffer(Device device, VkDeviceSize size, VkBufferUsageFlags usage,
-		       VkMemoryPropertyFlags properties) {
+		       VkMemoryPropertyFlags properties, bool transient = false) {
 			this->device = device;
 			this->size = size;
 
@@ -221,16 +390,11 @@ namespace {
 			VkMemoryRequirements memRequirements;
 			vkGetBufferMemoryRequirements(device.device, buffer, &memRequirements);
 
-			VkMemoryAllocateInfo allocInfo = {};
-			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-			allocInfo.allocationSize = memRequirements.size;
-			allocInfo.memoryTypeIndex =
-			    device.findMemoryType(memRequirements.memoryTypeBits, properties);
-
-			if (vkAllocateMemory(device.device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
-				throw std::runtime_error(LOCATION "failed to allocate buffer memory!");
+			memory = device.memoryPool->allocate(
+			    memRequirements, device.findMemoryType(memRequirements.memoryTypeBits, properties),
+			    true, transient);
 
-			vkBindBufferMemory(device.device, buffer, memory, 0);
+			vkBindBufferMemory(device.device, buffer, memory.memory, memory.offset);
 		}
 
 		void createBufferView(VkFormat format) {
@@ -245,21 +409,186 @@ namespace {
 				throw std::runtime_error(LOCATION "failed to create buffer view!");
 		}
 
-		void* mapMemory() {
-			void* data;
-			vkMapMemory(device.device, memory, 0, size, 0, &data);
-			return data;
-		}
+		// host visible memory is mapped by the pool and always host coherent, so unmapping does
+		// nothing
+		void* mapMemory() { return memory.mapped; }
 
-		void unmapMemory() { vkUnmapMemory(device.device, memory); }
+		void unmapMemory() {}
 
 		static void destroy(Buffer& buffer) {
 			vkDestroyBufferView(buffer.device.device, buffer.view, nullptr);
 			vkDestroyBuffer(buffer.device.device, buffer.buffer, nullptr);
-			vkFreeMemory(buffer.device.device, buffer.memory, nullptr);
+			buffer.device.memoryPool->free(buffer.memory);
+		}
+	};
+
+	// read only values uploaded once and shared by all frames
+	template <class resourceType>
+	struct Table {
+		uint32_t id;
+		std::filesystem::path path;
+		std::vector<float> values;
+
+		resourceType rsrc = {};
+	};
+
+	constexpr VkFormat lutFormat = VK_FORMAT_R32G32B32A32_SFLOAT;
+
+	struct StorageBuffer {
+		uint32_t id;
+		VkDeviceSize size;
+
+		Buffer rsrc = {};
+	};
+
+	struct StorageImage {
+		uint32_t id;
+		std::array<std::string, 2> size;
+
+		VkExtent2D extent = {};
+
+		Image rsrc = {};
+	};
+
+	constexpr VkFormat storageImageFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+	// offscreen attachment, its memory may be shared with other targets of the module
+	struct RenderTarget {
+		uint32_t id;
+		std::string name;
+		std::array<std::string, 2> size;
+
+		VkExtent2D extent = {};
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		VkSampler sampler = VK_NULL_HANDLE;
+		VkFramebuffer framebuffer = VK_NULL_HANDLE;
+	};
+
+	constexpr VkFormat renderTargetFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+	// vertex and index buffers in device local memory, shared by all frames
+	struct MeshBuffers {
+		uint32_t id;
+		std::string name;
+		std::filesystem::path path;
+
+		uint32_t indexCount = 0;
+		Buffer vertexBuffer = {};
+		Buffer indexBuffer = {};
+	};
+
+	struct Module {
+		std::string name;
+		std::filesystem::path location;
+
+		std::vector<GraphicsPipeline> layers;
+		// dispatched in order before any graphics layer is drawn
+		std::vector<ComputePipeline> computeLayers;
+		std::array<std::string, 3> workGroups = {"1", "1", "1"};
+		SpecializationConstants specializationConstants;
+
+		VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+		// parameters stored in a uniform buffer in ascending id order
+		std::vector<DynamicParameter> dynamicParameters;
+		uint32_t parameterBinding = 0;
+		std::vector<Buffer> parameterBuffers;
+		// incremented every time a dynamic parameter changes
+		uint32_t parameterRevision = 0;
+		std::vector<uint32_t> uploadedParameterRevisions;
+
+		std::vector<Resource<Image>> images;
+		std::vector<StorageBuffer> storageBuffers;
+		std::vector<StorageImage> storageImages;
+
+		std::vector<MeshBuffers> meshes;
+		std::vector<Table<Buffer>> buffers;
+		std::vector<Table<Image>> luts;
+
+		std::vector<RenderTarget> targets;
+		RenderGraph renderGraph;
+		// one allocation per memory block of the render graph
+		std::vector<VkDeviceMemory> targetMemory;
+
+		// Name of the fragment shader function to call
+		std::string moduleName = "main";
+		uint32_t vertexCount = 6;
+		// expression evaluated with the window size and the specialization constant parameters
+		std::optional<std::string> instanceCount;
+		uint32_t instances = 1;
+
+		// names of the parameters stored as specialization constants
+		std::vector<std::string> parameterNames;
+		bool defaultVertexShader = false;
+		bool fusable = false;
+		// which of lBuffer and rBuffer, the packed stereoBuffer and the spectrumImage the shaders
+		// read
+		bool separateSpectrum = true;
+		bool packedSpectrum = false;
+		bool spectrumImage = false;
+		// fused modules blend in the shader and overwrite the attachment instead
+		bool blend = true;
+		// expressions for the area the module draws to, the whole window if unset
+		std::optional<std::array<std::string, 4>> bounds;
+
+		static void destroy(VkDevice device, Module& module) {
+			for (auto& layer : module.layers) {
+				vkDestroyShaderModule(device, layer.fragShaderModule, nullptr);
+				vkDestroyShaderModule(device, layer.vertShaderModule, nullptr);
+			}
+			for (auto& layer : module.computeLayers)
+				vkDestroyShaderModule(device, layer.shaderModule, nullptr);
+
+			vkDestroyPipelineLayout(device, module.pipelineLayout, nullptr);
+			vkDestroyDescriptorSetLayout(device, module.descriptorSetLayout, nullptr);
+
+			// images are only created once the module is in use
+			for (auto& image : module.images)
+				if (image.rsrc.image != VK_NULL_HANDLE) Image::destroy(image.rsrc);
+			for (auto& buffer : module.parameterBuffers) Buffer::destroy(buffer);
+			for (auto& buffer : module.storageBuffers)
+				if (buffer.rsrc.buffer != VK_NULL_HANDLE) Buffer::destroy(buffer.rsrc);
+			for (auto& image : module.storageImages)
+				if (image.rsrc.image != VK_NULL_HANDLE) Image::destroy(image.rsrc);
+			for (auto& buffer : module.buffers)
+				if (buffer.rsrc.buffer != VK_NULL_HANDLE) Buffer::destroy(buffer.rsrc);
+			for (auto& lut : module.luts)
+				if (lut.rsrc.image != VK_NULL_HANDLE) Image::destroy(lut.rsrc);
+			for (auto& mesh : module.meshes) {
+				if (mesh.vertexBuffer.buffer == VK_NULL_HANDLE) continue;
+				Buffer::destroy(mesh.vertexBuffer);
+				Buffer::destroy(mesh.indexBuffer);
+			}
+			destroyTargets(device, module);
+		}
+
+		static void destroyTargets(VkDevice device, Module& module) {
+			for (auto& target : module.targets) {
+				vkDestroyFramebuffer(device, target.framebuffer, nullptr);
+				vkDestroySampler(device, target.sampler, nullptr);
+				vkDestroyImageView(device, target.view, nullptr);
+				vkDestroyImage(device, target.image, nullptr);
+				target.framebuffer = VK_NULL_HANDLE;
+				target.sampler = VK_NULL_HANDLE;
+				target.view = VK_NULL_HANDLE;
+				target.image = VK_NULL_HANDLE;
+			}
+			for (auto memory : module.targetMemory) vkFreeMemory(device, memory, nullptr);
+			module.targetMemory.clear();
 		}
 	};
 
+	// a replaced module set, with the descriptor pool and command buffers referring to it
+	struct RetiredModules {
+		std::vector<Module> modules;
+		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+		std::vector<VkCommandBuffer> commandBuffers;
+		// in flight fences still to be waited for before no frame can use the set
+		size_t pendingFrames = MAX_FRAMES_IN_FLIGHT;
+	};
+
 	struct UniformBufferObject {
 		float lVolume;
 		float rVolume;
@@ -271,22 +600,56 @@ class Renderer::RendererImpl {
 public:
 	RendererImpl(const Settings& renderSettings) {
 		settings = renderSettings;
+		shaderCompiler = ShaderCompiler({settings.shaderCacheLocation});
 
-		initWindow();
+		if (!settings.headless) initWindow();
 		initVulkan();
 	}
 
 	bool drawFrame(const AudioData& audioData) {
-		glfwPollEvents();
-		if (glfwWindowShouldClose(window)) return false;
+		if (!settings.headless) {
+			glfwPollEvents();
+			if (glfwWindowShouldClose(window)) return false;
+		}
 
-		vkWaitForFences(device.device, 1, &inFlightFences[currentFrame], VK_TRUE,
-		                std::numeric_limits<uint64_t>::max());
+		const auto frameStart = std::chrono::steady_clock::now();
+		if (lastFrameStart != std::chrono::steady_clock::time_point{}) {
+			const double interval =
+			    std::chrono::duration<double, std::milli>(frameStart - lastFrameStart).count();
+			frameInterval = frameInterval ? frameInterval + 0.05 * (interval - frameInterval)
+			                              : interval;
+		}
+		lastFrameStart = frameStart;
+
+		if (pendingModules.valid() &&
+		    pendingModules.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+			swapModules();
+
+		{
+			TRACE_SCOPE("waitForFence");
+			vkWaitForFences(device.device, 1, &inFlightFences[currentFrame], VK_TRUE,
+			                std::numeric_limits<uint64_t>::max());
+		}
+
+		for (auto& retired : retiredModules) --retired.pendingFrames;
+		destroyRetiredModules(false);
 
 		uint32_t imageIndex;
-		VkResult result = vkAcquireNextImageKHR(
-		    device.device, swapChain, std::numeric_limits<uint64_t>::max(),
-		    imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+		VkResult result;
+		if (settings.headless) {
+			// every frame in flight has its own offscreen image
+			imageIndex = static_cast<uint32_t>(currentFrame);
+			readTimestamps(imageIndex);
+			result = VK_SUCCESS;
+		} else {
+			TRACE_SCOPE("acquireNextImage");
+			result = vkAcquireNextImageKHR(device.device, swapChain,
+			                               std::numeric_limits<uint64_t>::max(),
+			                               imageAvailableSemaphores[currentFrame],
+			                               VK_NULL_HANDLE, &imageIndex);
+			// an image is only acquired again once presented, after the frame drawing to it
+			if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) readTimestamps(imageIndex);
+		}
 
 		switch (result) {
 			case VK_SUCCESS:
@@ -299,14 +662,18 @@ public:
 				throw std::runtime_error(LOCATION "failed to acquire swap chain image!");
 		}
 
+		const auto uploadStart = std::chrono::steady_clock::now();
 		updateAudioBuffers(audioData, imageIndex);
+		uploadTimes += std::chrono::steady_clock::now() - uploadStart;
+		++uploads;
 
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
 		VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
 		VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-		submitInfo.waitSemaphoreCount = 1;
+		// there is no swap chain to synchronise with in headless mode
+		submitInfo.waitSemaphoreCount = settings.headless ? 0 : 1;
 		submitInfo.pWaitSemaphores = waitSemaphores;
 		submitInfo.pWaitDstStageMask = waitStages;
 
@@ -314,14 +681,24 @@ public:
 		submitInfo.pCommandBuffers = &commandBuffers[imageIndex];
 
 		VkSemaphore signalSemaphores[] = {renderFinishedSemaphores[currentFrame]};
-		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.signalSemaphoreCount = settings.headless ? 0 : 1;
 		submitInfo.pSignalSemaphores = signalSemaphores;
 
 		vkResetFences(device.device, 1, &inFlightFences[currentFrame]);
 
-		if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) !=
-		    VK_SUCCESS)
-			throw std::runtime_error(LOCATION "failed to submit draw command buffer!");
+		{
+			TRACE_SCOPE("submit");
+			if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) !=
+			    VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to submit draw command buffer!");
+		}
+
+		timestampsPending[imageIndex] = timestampPool != VK_NULL_HANDLE;
+
+		if (settings.headless) {
+			currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+			return true;
+		}
 
 		VkPresentInfoKHR presentInfo = {};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -332,7 +709,10 @@ public:
 		presentInfo.pSwapchains = &swapChain;
 		presentInfo.pImageIndices = &imageIndex;
 
-		result = vkQueuePresentKHR(presentQueue, &presentInfo);
+		{
+			TRACE_SCOPE("present");
+			result = vkQueuePresentKHR(presentQueue, &presentInfo);
+		}
 
 		switch (result) {
 			case VK_SUCCESS:
@@ -350,26 +730,106 @@ public:
 		return true;
 	}
 
+	void setModules(const std::vector<std::filesystem::path>& moduleNames) {
+		loadModulesAsync(moduleNames, pendingModules.valid() ? pendingSmoothingLevel
+		                                                     : settings.smoothingLevel);
+	}
+
+	void setSmoothingLevel(float smoothingLevel) {
+		loadModulesAsync(pendingModules.valid() ? pendingModuleNames : settings.modules,
+		                 smoothingLevel);
+	}
+
+	double uploadTime() {
+		const double average =
+		    uploads ? std::chrono::duration<double, std::milli>(uploadTimes).count() / uploads
+		            : 0.0;
+		uploadTimes = {};
+		uploads = 0;
+		return average;
+	}
+
+	void setQuality(float quality) { frameVariables[ModuleConfig::qualityVariable] = quality; }
+
+	std::string deviceName() const {
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(device.physicalDevice, &deviceProperties);
+		return deviceProperties.deviceName;
+	}
+
+	std::optional<double> presentLatency() const {
+		if (settings.headless || frameInterval == 0.0) return std::nullopt;
+
+		// with FIFO every frame waits for the frames in flight before it to be shown for a
+		// refresh each, other modes replace queued frames and show one by the next refresh
+		const int queuedFrames =
+		    swapChainPresentMode == VK_PRESENT_MODE_FIFO_KHR ? MAX_FRAMES_IN_FLIGHT : 1;
+		return queuedFrames * frameInterval;
+	}
+
+	std::optional<double> frameTime() {
+		if (gpuFrames == 0) return std::nullopt;
+
+		const double average = gpuTime / gpuFrames;
+		gpuTime = 0.0;
+		gpuFrames = 0;
+		return average;
+	}
+
+	bool setParameter(const std::string& moduleName, const std::string& parameterName,
+	                  float value) {
+		if (std::isnan(value))
+			throw std::invalid_argument(LOCATION "parameter '" + parameterName +
+			                            "' can't be set to NaN!");
+
+		bool found = false;
+		for (size_t i = 0; i < modules.size(); ++i) {
+			if (modules[i].name != moduleName) continue;
+
+			for (auto& param : modules[i].dynamicParameters) {
+				if (param.name != parameterName) continue;
+
+				std::visit(
+				    [value](auto& v) { v = convertParameter<std::decay_t<decltype(v)>>(value); },
+				    param.value);
+				// a value set explicitly replaces the expression of the parameter
+				param.expression.reset();
+				++modules[i].parameterRevision;
+				found = true;
+			}
+		}
+		return found;
+	}
+
 	~RendererImpl() {
 		vkDeviceWaitIdle(device.device);
 
+		destroyRetiredModules(true);
 		cleanupSwapChain();
 
-		for (size_t i = 0; i < modules.size(); ++i)
-			vkDestroyPipelineLayout(device.device, pipelineLayouts[i], nullptr);
+		if (pendingModules.valid()) {
+			try {
+				auto unusedModules = pendingModules.get();
+				destroyPipelines(unusedModules);
+				for (auto& module : unusedModules) Module::destroy(device.device, module);
+			} catch (const std::exception&) {
+			}
+		}
 
 		vkDestroyRenderPass(device.device, renderPass, nullptr);
+		for (auto targetRenderPass : targetRenderPasses)
+			vkDestroyRenderPass(device.device, targetRenderPass, nullptr);
 
 		vkDestroyDescriptorPool(device.device, descriptorPool, nullptr);
 
 		vkDestroyDescriptorSetLayout(device.device, commonDescriptorSetLayout, nullptr);
-		for (auto& layout : descriptorSetLayouts)
-			vkDestroyDescriptorSetLayout(device.device, layout, nullptr);
 
 		for (size_t i = 0; i < dataBuffers.size(); ++i) {
 			Buffer::destroy(dataBuffers[i]);
 			Buffer::destroy(lAudioBuffers[i]);
 			Buffer::destroy(rAudioBuffers[i]);
+			Buffer::destroy(stereoAudioBuffers[i]);
+			Image::destroy(spectrumImages[i]);
 		}
 
 		for (auto& module : modules) Module::destroy(device.device, module);
@@ -382,19 +842,24 @@ public:
 			vkDestroyFence(device.device, inFlightFences[i], nullptr);
 		}
 
+		vkDestroyQueryPool(device.device, timestampPool, nullptr);
+
 		vkDestroyCommandPool(device.device, commandPool, nullptr);
 
+		memoryPool.reset();
 		vkDestroyDevice(device.device, nullptr);
 
 		if constexpr (enableValidationLayers)
 			DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
 
-		vkDestroySurfaceKHR(instance, surface, nullptr);
+		if (!settings.headless) vkDestroySurfaceKHR(instance, surface, nullptr);
 		vkDestroyInstance(instance, nullptr);
 
-		glfwDestroyWindow(window);
+		if (!settings.headless) {
+			glfwDestroyWindow(window);
 
-		glfwTerminate();
+			glfwTerminate();
+		}
 	}
 
 private:
@@ -402,39 +867,64 @@ private:
 
 	Settings settings;
 
-	GLFWwindow* window;
+	ShaderCompiler shaderCompiler;
+
+	GLFWwindow* window = nullptr;
 
 	VkInstance instance;
 	VkDebugUtilsMessengerEXT debugMessenger;
 
-	VkSurfaceKHR surface;
+	VkSurfaceKHR surface = VK_NULL_HANDLE;
 
 	Device device;
+	std::unique_ptr<MemoryPool> memoryPool;
 
 	VkQueue graphicsQueue;
 	VkQueue presentQueue;
 
-	VkSwapchainKHR swapChain;
+	VkSwapchainKHR swapChain = VK_NULL_HANDLE;
 	std::vector<VkImage> swapChainImages;
+	// drawn to instead of the swap chain images in headless mode
+	std::vector<Image> offscreenImages;
 	VkFormat swapChainImageFormat;
 	VkExtent2D swapChainExtent;
+	VkPresentModeKHR swapChainPresentMode = VK_PRESENT_MODE_FIFO_KHR;
 
 	std::vector<VkImageView> swapChainImageViews;
 	std::vector<VkFramebuffer> swapChainFramebuffers;
 
 	VkRenderPass renderPass;
+	// clear and load variants of the render pass drawing to a render target
+	std::array<VkRenderPass, 2> targetRenderPasses = {};
 	VkDescriptorSetLayout commonDescriptorSetLayout;
-	std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
-	std::vector<VkPipelineLayout> pipelineLayouts;
 
 	std::vector<Module> modules;
 
+	// module set being prepared in the background, swapped in at the start of a frame
+	std::future<std::vector<Module>> pendingModules;
+	std::vector<std::filesystem::path> pendingModuleNames;
+	float pendingSmoothingLevel;
+	VkExtent2D pendingExtent;
+	// request made while another module set was still being prepared
+	std::optional<std::pair<std::vector<std::filesystem::path>, float>> queuedModules;
+	// replaced module sets the frames in flight may still draw
+	std::vector<RetiredModules> retiredModules;
+
 	VkCommandPool commandPool;
 	std::vector<VkCommandBuffer> commandBuffers;
 
+	// values of ModuleConfig::frameVariables for the current frame
+	std::vector<float> frameVariables = ModuleConfig::initialFrameVariables();
+
 	std::vector<Buffer> dataBuffers;
 	std::vector<Buffer> lAudioBuffers;
 	std::vector<Buffer> rAudioBuffers;
+	// lBuffer and rBuffer interleaved as half precision pairs
+	std::vector<Buffer> stereoAudioBuffers;
+	// the stereoBuffer copied to a linearly filtered image, with spectrumMipLevels box filtered
+	// mip levels
+	std::vector<Image> spectrumImages;
+	uint32_t spectrumMipLevels = 1;
 
 	Image backgroundImage;
 
@@ -447,9 +937,28 @@ private:
 	std::array<VkFence, MAX_FRAMES_IN_FLIGHT> inFlightFences;
 	size_t currentFrame = 0;
 
+	// start and end of every command buffer
+	VkQueryPool timestampPool = VK_NULL_HANDLE;
+	// nanoseconds per timestamp tick
+	float timestampPeriod;
+	// whether the timestamps of each image have been submitted but not read yet
+	std::vector<bool> timestampsPending;
+	// milliseconds spent by the frames measured since the last call to frameTime
+	double gpuTime = 0.0;
+	size_t gpuFrames = 0;
+
+	// moving average of the milliseconds between the starts of consecutive frames
+	double frameInterval = 0.0;
+	std::chrono::steady_clock::time_point lastFrameStart;
+
+	// spent in updateAudioBuffers since the last call to uploadTime
+	std::chrono::steady_clock::duration uploadTimes = {};
+	size_t uploads = 0;
+
 	// Member functions
 
 	void initWindow() {
+		TRACE_SCOPE("initWindow");
 		glfwInit();
 
 		if (!glfwVulkanSupported())
@@ -487,30 +996,40 @@ private:
 	}
 
 	void initVulkan() {
+		TRACE_SCOPE("initVulkan");
 		createInstance();
 		setupDebugCallback();
-		createSurface();
+		if (!settings.headless) createSurface();
 		pickPhysicalDevice();
 		createLogicalDevice();
 		createSwapchain();
+		createTimestampQueries();
 		createImageViews();
 		createRenderPass();
-		discoverModules();
+		createTargetRenderPasses();
 		createDescriptorSetLayouts();
-		createGraphicsPipelineLayouts();
-		createGraphicsPipelines();
+		modules = loadModules(settings.modules, settings.smoothingLevel, swapChainExtent);
 		createFramebuffers();
 		createCommandPool();
 		createAudioBuffers();
-		createModuleImages();
+		createModuleResources(modules);
 		createBackgroundImage();
 		createDescriptorPool();
 		createDescriptorSets();
 		createCommandBuffers();
 		createSyncObjects();
+		logMemoryUsage();
+	}
+
+	void logMemoryUsage() {
+		const auto stats = memoryPool->stats();
+		std::clog << "Device memory: " << stats.allocations << " allocation(s) using "
+		          << stats.used / 1024 << " KiB of " << stats.blocks << " block(s) totalling "
+		          << stats.reserved / 1024 << " KiB" << std::endl;
 	}
 
 	void createInstance() {
+		TRACE_SCOPE("createInstance");
 		const auto extensions = getRequiredExtensions();
 		if (!checkRequiredExtensionsPresent(extensions))
 			throw std::runtime_error(LOCATION "missing required vulkan extension!");
@@ -540,11 +1059,13 @@ private:
 	}
 
 	std::vector<const char*> getRequiredExtensions() const {
-		uint32_t glfwExtensionCount = 0;
-		const char** glfwExtensions;
-		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-		std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		std::vector<const char*> extensions;
+		if (!settings.headless) {
+			uint32_t glfwExtensionCount = 0;
+			const char** glfwExtensions;
+			glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+			extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		}
 
 		if constexpr (enableValidationLayers) {
 			extensions.reserve(extensions.size() + 1);
@@ -612,6 +1133,7 @@ private:
 	}
 
 	void pickPhysicalDevice() {
+		TRACE_SCOPE("pickPhysicalDevice");
 		uint32_t deviceCount = 0;
 		vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
 		if (deviceCount == 0)
@@ -645,8 +1167,8 @@ private:
 
 		bool extensionsSupported = checkDeviceExtensionSupport(device);
 
-		bool swapChainAdequate = false;
-		if (extensionsSupported) {
+		bool swapChainAdequate = settings.headless;
+		if (extensionsSupported && !settings.headless) {
 			SwapChainSupportDetails swapChainDetails = querySwapChainSupport(device);
 			swapChainAdequate =
 			    !swapChainDetails.formats.empty() && !swapChainDetails.presentModes.empty();
@@ -670,13 +1192,19 @@ private:
 		vkEnumerateDeviceExtensionProperties(device, nullptr, &availableExtensionCount,
 		                                     availableExtensions.data());
 
-		std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+		const auto extensions = getRequiredDeviceExtensions();
+		std::set<std::string> requiredExtensions(extensions.begin(), extensions.end());
 		for (const auto& availableExtension : availableExtensions)
 			requiredExtensions.erase(availableExtension.extensionName);
 
 		return requiredExtensions.empty();
 	}
 
+	std::vector<const char*> getRequiredDeviceExtensions() const {
+		// the swap chain extension is only needed for presenting
+		return settings.headless ? std::vector<const char*>() : deviceExtensions;
+	}
+
 	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device) const {
 		QueueFamilyIndices indices;
 
@@ -690,11 +1218,18 @@ private:
 			if (queueFamily.queueCount <= 0) continue;
 
 			VkBool32 presentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+			if (!settings.headless)
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
 
 			if (presentSupport) indices.presentFamily = i;
 
-			if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) indices.graphicsFamily = i;
+			// compute layers are dispatched on the graphics queue
+			if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
+			    (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+				indices.graphicsFamily = i;
+				// nothing is presented in headless mode
+				if (settings.headless) indices.presentFamily = i;
+			}
 
 			if (indices.isComplete()) break;
 
@@ -724,14 +1259,15 @@ private:
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 
 		const auto layers = getRequiredLayers();
+		const auto extensions = getRequiredDeviceExtensions();
 
 		VkDeviceCreateInfo deviceInfo = {};
 		deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 		deviceInfo.pQueueCreateInfos = queueInfos.data();
 		deviceInfo.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
 		deviceInfo.pEnabledFeatures = &deviceFeatures;
-		deviceInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-		deviceInfo.ppEnabledExtensionNames = deviceExtensions.data();
+		deviceInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+		deviceInfo.ppEnabledExtensionNames = extensions.data();
 		deviceInfo.enabledLayerCount = static_cast<uint32_t>(layers.size());
 		deviceInfo.ppEnabledLayerNames = layers.data();
 
@@ -741,9 +1277,17 @@ private:
 
 		vkGetDeviceQueue(device.device, indices.graphicsFamily.value(), 0, &graphicsQueue);
 		vkGetDeviceQueue(device.device, indices.presentFamily.value(), 0, &presentQueue);
+
+		memoryPool = std::make_unique<MemoryPool>(device.physicalDevice, device.device);
+		device.memoryPool = memoryPool.get();
 	}
 
 	void createSwapchain() {
+		if (settings.headless) {
+			createOffscreenImages();
+			return;
+		}
+
 		SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device.physicalDevice);
 
 		VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
@@ -811,6 +1355,7 @@ private:
 		}
 
 		swapChainInfo.presentMode = presentMode;
+		swapChainPresentMode = presentMode;
 		swapChainInfo.clipped = VK_TRUE;
 		swapChainInfo.oldSwapchain = VK_NULL_HANDLE;
 
@@ -825,6 +1370,70 @@ private:
 		swapChainExtent = extent;
 	}
 
+	/**
+	 * Creates an image for every frame in flight to take the place of the swap chain images
+	 */
+	void createOffscreenImages() {
+		swapChainImageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+		swapChainExtent = {settings.window.width, settings.window.height};
+
+		offscreenImages.resize(MAX_FRAMES_IN_FLIGHT);
+		swapChainImages.clear();
+		for (auto& image : offscreenImages) {
+			image = Image(device, swapChainExtent.width, swapChainExtent.height,
+			              VK_IMAGE_TYPE_2D, swapChainImageFormat, VK_IMAGE_TILING_OPTIMAL,
+			              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			// the views are created with those of the swap chain images
+			image.view = VK_NULL_HANDLE;
+			image.sampler = VK_NULL_HANDLE;
+			swapChainImages.push_back(image.image);
+		}
+	}
+
+	/**
+	 * Creates a pair of timestamp queries for every swap chain image
+	 */
+	void createTimestampQueries() {
+		timestampsPending.assign(swapChainImages.size(), false);
+
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(device.physicalDevice, &deviceProperties);
+		if (!deviceProperties.limits.timestampComputeAndGraphics) {
+			std::cerr << LOCATION "timestamp queries unsupported, frame times unavailable!"
+			          << std::endl;
+			return;
+		}
+		timestampPeriod = deviceProperties.limits.timestampPeriod;
+
+		VkQueryPoolCreateInfo queryPoolInfo = {};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = static_cast<uint32_t>(2 * swapChainImages.size());
+
+		if (vkCreateQueryPool(device.device, &queryPoolInfo, nullptr, &timestampPool) !=
+		    VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create timestamp query pool!");
+	}
+
+	/**
+	 * Adds the GPU time of the last frame drawn to image to gpuTime, if it has not been yet.
+	 * The frame is skipped if its timestamps are not available yet.
+	 */
+	void readTimestamps(uint32_t image) {
+		if (!timestampsPending[image]) return;
+		timestampsPending[image] = false;
+
+		std::array<uint64_t, 2> timestamps;
+		if (vkGetQueryPoolResults(device.device, timestampPool, 2 * image, 2,
+		                          sizeof(timestamps), timestamps.data(), sizeof(uint64_t),
+		                          VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+			return;
+
+		gpuTime += (timestamps[1] - timestamps[0]) * timestampPeriod / 1e6;
+		++gpuFrames;
+	}
+
 	SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) const {
 		SwapChainSupportDetails details;
 		vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
@@ -905,121 +1514,397 @@ private:
 			swapChainImageViews[i] = createImageView(swapChainImages[i], swapChainImageFormat);
 	}
 
-	void discoverModules() {
-		modules.resize(settings.modules.size());
+	/**
+	 * Creates the shaders and pipelines of the given modules.
+	 * Only uses objects which are never modified after initialisation, so that it can be
+	 * called from a background thread.
+	 */
+	std::vector<Module> loadModules(const std::vector<std::filesystem::path>& moduleNames,
+	                                float smoothingLevel, VkExtent2D extent) {
+		TRACE_SCOPE("loadModules");
+		std::vector<Module> newModules(moduleNames.size());
 
-		for (uint32_t i = 0; i < modules.size(); ++i) {
-			modules[i].location = findModule(settings.modules[i].string());
+		try {
+			for (uint32_t i = 0; i < newModules.size(); ++i) {
+				newModules[i].name = moduleNames[i].string();
+				discoverModule(moduleNames[i], newModules[i]);
+				newModules[i].specializationConstants.data[0] =
+				    static_cast<uint32_t>(settings.audioSize);
+				newModules[i].specializationConstants.data[1] = smoothingLevel;
+				newModules[i].specializationConstants.data[4] = newModules[i].vertexCount;
+				newModules[i].specializationConstants.data[5] = newModules[i].instances;
+			}
 
-			// find number of layers
-			uint32_t layerCount = 1;
-			while (std::filesystem::exists(modules[i].location / std::to_string(layerCount + 1)))
-				++layerCount;
-			modules[i].layers.resize(layerCount);
+			if (settings.fuseModules) fuseModules(newModules);
 
-			// find fallback vertex shader
-			const auto fallbackVertShaderPath =
-			    std::filesystem::exists(modules[i].location / "vert.spv")
-			        ? modules[i].location
-			        : settings.moduleLocations.front() / "modules";
+			for (auto& module : newModules) {
+				createModuleDescriptorSetLayout(module);
+				createGraphicsPipelineLayout(module);
+			}
 
-			// find and create shaders for each layer
-			for (uint32_t layer = 0; layer < layerCount; ++layer) {
-				auto vertexShaderPath = modules[i].location / std::to_string(layer + 1);
-				if (!std::filesystem::exists(vertexShaderPath / "vert.spv"))
-					vertexShaderPath = fallbackVertShaderPath;
+			createPipelines(newModules, extent);
+		} catch (...) {
+			destroyPipelines(newModules);
+			for (auto& module : newModules) Module::destroy(device.device, module);
+			throw;
+		}
 
-				auto vertShaderCode = readFile(vertexShaderPath / "vert.spv");
-				modules[i].layers[layer].vertShaderModule = createShaderModule(vertShaderCode);
+		return newModules;
+	}
 
-				auto fragmentShaderPath = modules[i].location / std::to_string(layer + 1);
-				auto fragShaderCode = readFile(fragmentShaderPath / "frag.spv");
-				modules[i].layers[layer].fragShaderModule = createShaderModule(fragShaderCode);
+	void discoverModule(const std::filesystem::path& moduleName, Module& module) {
+		TRACE_SCOPE("discoverModule");
+		module.location = findModule(moduleName.string());
+
+		// find number of layers
+		uint32_t layerCount = 1;
+		while (std::filesystem::exists(module.location / std::to_string(layerCount + 1)))
+			++layerCount;
+
+		// find fallback vertex shader
+		const auto fallbackVertShaderPath =
+		    ShaderCompiler::hasShader(module.location, ShaderCompiler::Stage::vertex)
+		        ? module.location
+		        : settings.moduleLocations.front() / "modules";
+
+		module.defaultVertexShader = true;
+
+		// bindings of set 0 declared by the shaders
+		std::set<uint32_t> globalBindings;
+		bool reflected = true;
+		auto addBindings = [&](const std::vector<char>& code) {
+			try {
+				for (auto [set, binding] : descriptorBindings(code))
+					if (set == 0) globalBindings.insert(binding);
+			} catch (const std::invalid_argument&) {
+				// vkCreateShaderModule reports invalid code
+				reflected = false;
+			}
+		};
+
+		// find and create shaders for each layer
+		for (uint32_t layer = 0; layer < layerCount; ++layer) {
+			const auto layerPath = module.location / std::to_string(layer + 1);
+
+			// layers containing a compute shader are dispatched instead of drawn
+			if (ShaderCompiler::hasShader(layerPath, ShaderCompiler::Stage::compute)) {
+				auto compShaderCode = shaderCompiler.load(layerPath, ShaderCompiler::Stage::compute);
+				addBindings(compShaderCode);
+				module.computeLayers.emplace_back();
+				module.computeLayers.back().shaderModule = createShaderModule(compShaderCode);
+				continue;
 			}
 
-			readConfig(modules[i].location / "config", modules[i]);
-			modules[i].specializationConstants.data[0] = static_cast<uint32_t>(settings.audioSize);
-			modules[i].specializationConstants.data[1] = settings.smoothingLevel;
-			modules[i].specializationConstants.data[4] = modules[i].vertexCount;
+			auto vertexShaderPath = layerPath;
+			if (!ShaderCompiler::hasShader(vertexShaderPath, ShaderCompiler::Stage::vertex))
+				vertexShaderPath = fallbackVertShaderPath;
+			if (vertexShaderPath != settings.moduleLocations.front() / "modules")
+				module.defaultVertexShader = false;
+
+			module.layers.emplace_back();
+			module.layers.back().directory = layer + 1;
+
+			auto vertShaderCode = shaderCompiler.load(vertexShaderPath, ShaderCompiler::Stage::vertex);
+			addBindings(vertShaderCode);
+			module.layers.back().vertShaderModule = createShaderModule(vertShaderCode);
+
+			auto fragShaderCode = shaderCompiler.load(layerPath, ShaderCompiler::Stage::fragment);
+			addBindings(fragShaderCode);
+			module.layers.back().fragShaderModule = createShaderModule(fragShaderCode);
 		}
-	}
 
-	std::filesystem::path findModule(const std::string& moduleName) const {
-		if (std::filesystem::path(moduleName).is_absolute()) return moduleName;
+		readConfig(module.location / "config", module);
+
+		// prebuilt SPIR-V older than a change of the spectrum inputs in the config still gets the
+		// buffers it reads instead of drawing an empty spectrum
+		const bool separateSpectrum = globalBindings.count(1) || globalBindings.count(2);
+		const bool packedSpectrum = globalBindings.count(4);
+		const bool spectrumImage = globalBindings.count(5);
+		if ((separateSpectrum && !module.separateSpectrum) ||
+		    (packedSpectrum && !module.packedSpectrum) || (spectrumImage && !module.spectrumImage))
+			std::cerr << "warning: the shaders of module '" << module.name
+			          << "' read other spectrum buffers than its config declares, they may need "
+			             "to be rebuilt with `make shaders`"
+			          << std::endl;
+		module.separateSpectrum |= separateSpectrum;
+		module.packedSpectrum |= packedSpectrum;
+		// copying the spectrumImage and generating its mip levels every frame is wasted if it is
+		// declared but never sampled, e.g. by a binary built before the config asked for it
+		module.spectrumImage = spectrumImage || (module.spectrumImage && !reflected);
 
-		for (auto& path : settings.moduleLocations)
-			if (std::filesystem::exists(path / "modules" / moduleName))
-				return path / "modules" / moduleName;
+		std::vector<RenderGraphLayer> graphLayers;
+		graphLayers.reserve(module.layers.size());
+		for (const auto& layer : module.layers) graphLayers.push_back({layer.inputs, layer.target});
 
-		throw std::invalid_argument(LOCATION "Unable to locate module!");
+		try {
+			module.renderGraph = compileRenderGraph(graphLayers, module.targets.size());
+		} catch (const std::invalid_argument& e) {
+			throw std::runtime_error(LOCATION "invalid layers in module '" + module.name +
+			                         "': " + e.what());
+		}
 	}
 
-	void createGraphicsPipelineLayouts() {
-		pipelineLayouts.resize(modules.size());
+	static bool isFusable(const Module& module) {
+		return module.fusable && module.layers.size() == 1 && module.computeLayers.empty() &&
+		       module.defaultVertexShader && module.storageBuffers.empty() &&
+		       module.storageImages.empty() && module.targets.empty() &&
+		       module.meshes.empty() && module.buffers.empty() && module.luts.empty() &&
+		       module.vertexCount == 6 && module.images.empty() &&
+		       module.dynamicParameters.empty() && !module.bounds && !module.instanceCount &&
+		       std::filesystem::exists(module.location / "1" / "shader.frag") &&
+		       ShaderCompiler::supported();
+	}
 
-		for (uint32_t module = 0; module < modules.size(); ++module) {
-			std::array<VkDescriptorSetLayout, 2> moduleDescSetLayouts = {
-			    commonDescriptorSetLayout, descriptorSetLayouts[module]};
-			VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
-			pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-			pipelineLayoutInfo.setLayoutCount = moduleDescSetLayouts.size();
-			pipelineLayoutInfo.pSetLayouts = moduleDescSetLayouts.data();
-			pipelineLayoutInfo.pushConstantRangeCount = 0;
-			pipelineLayoutInfo.pPushConstantRanges = nullptr;
+	/**
+	 * Replaces the leading run of fusable modules with a single module drawing all of them
+	 * in one pass. Only leading modules are fused since they are drawn onto a cleared
+	 * attachment, which allows the fused shader to reproduce the blending exactly.
+	 */
+	void fuseModules(std::vector<Module>& moduleSet) {
+		size_t count = 0;
+		while (count < moduleSet.size() && isFusable(moduleSet[count])) ++count;
+		if (count < 2) return;
+
+		Module fused;
+		fused.location = moduleSet.front().location;
+		fused.layers.resize(1);
+		fused.blend = false;
+		fused.renderGraph = compileRenderGraph({{}}, 0);
+		fused.separateSpectrum = false;
+
+		auto& fusedConstants = fused.specializationConstants;
+		const auto& firstConstants = moduleSet.front().specializationConstants;
+		fusedConstants.data.assign(firstConstants.data.begin(), firstConstants.data.begin() + builtinConstantCount);
+		fusedConstants.specializationInfo.assign(
+		    firstConstants.specializationInfo.begin(),
+		    firstConstants.specializationInfo.begin() + builtinConstantCount);
+
+		std::vector<FusedModule> fusedModules(count);
+		uint32_t nextId = builtinConstantCount;
+		for (size_t i = 0; i < count; ++i) {
+			const auto& constants = moduleSet[i].specializationConstants;
+
+			uint32_t minId = std::numeric_limits<uint32_t>::max();
+			uint32_t maxId = 0;
+			for (size_t entry = builtinConstantCount; entry < constants.specializationInfo.size();
+			     ++entry) {
+				minId = std::min(minId, constants.specializationInfo[entry].constantID);
+				maxId = std::max(maxId, constants.specializationInfo[entry].constantID);
+			}
+			const uint32_t offset = minId < nextId ? nextId - minId : 0;
+
+			fused.name += (i ? ", " : "") + moduleSet[i].name;
+			fused.separateSpectrum |= moduleSet[i].separateSpectrum;
+			fused.packedSpectrum |= moduleSet[i].packedSpectrum;
+			fused.spectrumImage |= moduleSet[i].spectrumImage;
+
+			fusedModules[i].fragmentShader = moduleSet[i].location / "1" / "shader.frag";
+			fusedModules[i].entryPoint = moduleSet[i].moduleName;
+			fusedModules[i].parameterNames = moduleSet[i].parameterNames;
+			fusedModules[i].constantIdOffset = offset;
+
+			for (size_t entry = builtinConstantCount; entry < constants.specializationInfo.size();
+			     ++entry) {
+				VkSpecializationMapEntry mapEntry = constants.specializationInfo[entry];
+				mapEntry.constantID += offset;
+				mapEntry.offset = fusedConstants.data.size() * sizeof(SpecializationConstant);
+				fusedConstants.specializationInfo.push_back(mapEntry);
+				fusedConstants.data.push_back(constants.data[entry]);
+			}
 
-			if (vkCreatePipelineLayout(device.device, &pipelineLayoutInfo, nullptr,
-			                           &pipelineLayouts[module]) != VK_SUCCESS)
-				throw std::runtime_error(LOCATION "failed to create pipeline layout!");
+			if (minId != std::numeric_limits<uint32_t>::max()) nextId = maxId + offset + 1;
 		}
-	}
 
-	void createGraphicsPipelines() {
-		VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
-		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-		vertexInputInfo.vertexBindingDescriptionCount = 0;
-		vertexInputInfo.vertexAttributeDescriptionCount = 0;
+		try {
+			auto fragShaderCode = shaderCompiler.compile(generateFusedShader(fusedModules),
+			                                             fused.location / "fused.frag",
+			                                             ShaderCompiler::Stage::fragment);
+			fused.layers[0].fragShaderModule = createShaderModule(fragShaderCode);
+		} catch (const std::exception& e) {
+			std::cerr << "failed to fuse modules, drawing them separately: " << e.what()
+			          << std::endl;
+			return;
+		}
 
-		VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
-		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-		inputAssembly.primitiveRestartEnable = VK_FALSE;
+		// every fused module uses the default vertex shader
+		std::swap(fused.layers[0].vertShaderModule, moduleSet.front().layers[0].vertShaderModule);
 
-		VkViewport viewport = {};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(swapChainExtent.width);
-		viewport.height = static_cast<float>(swapChainExtent.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
+		for (size_t i = 0; i < count; ++i) Module::destroy(device.device, moduleSet[i]);
+		moduleSet.erase(moduleSet.begin(), moduleSet.begin() + count);
+		moduleSet.insert(moduleSet.begin(), std::move(fused));
 
-		VkRect2D scissor = {};
-		scissor.offset = {0, 0};
-		scissor.extent = swapChainExtent;
+		std::clog << "Fused " << count << " modules into a single pass" << std::endl;
+	}
 
-		VkPipelineViewportStateCreateInfo viewportState = {};
-		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-		viewportState.viewportCount = 1;
-		viewportState.pViewports = &viewport;
-		viewportState.scissorCount = 1;
-		viewportState.pScissors = &scissor;
+	void loadModulesAsync(const std::vector<std::filesystem::path>& moduleNames,
+	                      float smoothingLevel) {
+		if (pendingModules.valid()) {
+			queuedModules = std::make_pair(moduleNames, smoothingLevel);
+			return;
+		}
 
-		VkPipelineRasterizationStateCreateInfo rasterizer = {};
-		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-		rasterizer.depthClampEnable = VK_FALSE;
-		rasterizer.rasterizerDiscardEnable = VK_FALSE;
-		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-		rasterizer.lineWidth = 1.0f;
-		rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-		rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-		rasterizer.depthBiasEnable = VK_FALSE;
+		pendingModuleNames = moduleNames;
+		pendingSmoothingLevel = smoothingLevel;
+		pendingExtent = swapChainExtent;
+		pendingModules = std::async(std::launch::async, &RendererImpl::loadModules, this,
+		                            moduleNames, smoothingLevel, swapChainExtent);
+	}
 
-		VkPipelineMultisampleStateCreateInfo multisampling = {};
-		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-		multisampling.sampleShadingEnable = VK_FALSE;
-		multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+	/**
+	 * Replaces the current modules with the ones prepared by loadModulesAsync without waiting
+	 * for the device. The frames in flight finish with the replaced modules, which are destroyed
+	 * once their fences have been waited for.
+	 */
+	void swapModules() {
+		std::vector<Module> newModules;
+		try {
+			newModules = pendingModules.get();
+		} catch (const std::exception& e) {
+			std::cerr << "failed to load modules: " << e.what() << std::endl;
+		}
 
-		VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
-		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+		// the new modules are prepared while the frames in flight keep drawing the current ones
+		if (!newModules.empty()) {
+			try {
+				// the window may have been resized while the pipelines were being created
+				if (pendingExtent.width != swapChainExtent.width ||
+				    pendingExtent.height != swapChainExtent.height) {
+					destroyPipelines(newModules);
+					createPipelines(newModules, swapChainExtent);
+				}
+				createModuleResources(newModules);
+			} catch (const std::exception& e) {
+				std::cerr << "failed to load modules: " << e.what() << std::endl;
+				destroyPipelines(newModules);
+				for (auto& module : newModules) Module::destroy(device.device, module);
+				newModules.clear();
+			}
+		}
+
+		if (!newModules.empty()) {
+			RetiredModules retired = {};
+			retired.modules = std::move(modules);
+			retired.descriptorPool = descriptorPool;
+			retired.commandBuffers = std::move(commandBuffers);
+			retiredModules.push_back(std::move(retired));
+
+			modules = std::move(newModules);
+			settings.modules = pendingModuleNames;
+			settings.smoothingLevel = pendingSmoothingLevel;
+
+			createDescriptorPool();
+			createDescriptorSets();
+			createCommandBuffers();
+
+			std::clog << "Switched to " << modules.size() << " module(s)" << std::endl;
+			logMemoryUsage();
+		}
+
+		if (queuedModules) {
+			auto [moduleNames, smoothingLevel] = std::move(queuedModules.value());
+			queuedModules.reset();
+			loadModulesAsync(moduleNames, smoothingLevel);
+		}
+	}
+
+	/**
+	 * Destroys the modules replaced by swapModules that no frame in flight uses any more, or
+	 * all of them once the device is idle
+	 */
+	void destroyRetiredModules(bool deviceIdle) {
+		auto retired = retiredModules.begin();
+		while (retired != retiredModules.end()) {
+			if (!deviceIdle && retired->pendingFrames > 0) {
+				++retired;
+				continue;
+			}
+
+			vkFreeCommandBuffers(device.device, commandPool,
+			                     static_cast<uint32_t>(retired->commandBuffers.size()),
+			                     retired->commandBuffers.data());
+			vkDestroyDescriptorPool(device.device, retired->descriptorPool, nullptr);
+			destroyPipelines(retired->modules);
+			for (auto& module : retired->modules) Module::destroy(device.device, module);
+
+			retired = retiredModules.erase(retired);
+		}
+	}
+
+	std::filesystem::path findModule(const std::string& moduleName) const {
+		if (std::filesystem::path(moduleName).is_absolute()) return moduleName;
+
+		for (auto& path : settings.moduleLocations)
+			if (std::filesystem::exists(path / "modules" / moduleName))
+				return path / "modules" / moduleName;
+
+		throw std::invalid_argument(LOCATION "Unable to locate module!");
+	}
+
+	void createGraphicsPipelineLayout(Module& module) {
+		std::array<VkDescriptorSetLayout, 2> moduleDescSetLayouts = {commonDescriptorSetLayout,
+		                                                            module.descriptorSetLayout};
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = moduleDescSetLayouts.size();
+		pipelineLayoutInfo.pSetLayouts = moduleDescSetLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = 0;
+		pipelineLayoutInfo.pPushConstantRanges = nullptr;
+
+		if (vkCreatePipelineLayout(device.device, &pipelineLayoutInfo, nullptr,
+		                           &module.pipelineLayout) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create pipeline layout!");
+	}
+
+	void createGraphicsPipelines(std::vector<Module>& moduleSet, VkExtent2D extent) {
+		TRACE_SCOPE("createGraphicsPipelines");
+		VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		vertexInputInfo.vertexBindingDescriptionCount = 0;
+		vertexInputInfo.vertexAttributeDescriptionCount = 0;
+
+		// layers drawing a mesh read its position and normal at locations 0 and 1
+		VkVertexInputBindingDescription meshBinding = {};
+		meshBinding.binding = 0;
+		meshBinding.stride = sizeof(Mesh::Vertex);
+		meshBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		std::array<VkVertexInputAttributeDescription, 2> meshAttributes = {};
+		for (uint32_t location = 0; location < meshAttributes.size(); ++location) {
+			meshAttributes[location].binding = 0;
+			meshAttributes[location].location = location;
+			meshAttributes[location].format = VK_FORMAT_R32G32B32_SFLOAT;
+		}
+		meshAttributes[0].offset = offsetof(Mesh::Vertex, position);
+		meshAttributes[1].offset = offsetof(Mesh::Vertex, normal);
+
+		VkPipelineVertexInputStateCreateInfo meshVertexInputInfo = vertexInputInfo;
+		meshVertexInputInfo.vertexBindingDescriptionCount = 1;
+		meshVertexInputInfo.pVertexBindingDescriptions = &meshBinding;
+		meshVertexInputInfo.vertexAttributeDescriptionCount = meshAttributes.size();
+		meshVertexInputInfo.pVertexAttributeDescriptions = meshAttributes.data();
+
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+		VkPipelineRasterizationStateCreateInfo rasterizer = {};
+		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterizer.depthClampEnable = VK_FALSE;
+		rasterizer.rasterizerDiscardEnable = VK_FALSE;
+		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+		rasterizer.lineWidth = 1.0f;
+		rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+		rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+		rasterizer.depthBiasEnable = VK_FALSE;
+
+		VkPipelineMultisampleStateCreateInfo multisampling = {};
+		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisampling.sampleShadingEnable = VK_FALSE;
+		multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
 		                                      VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
 		colorBlendAttachment.blendEnable = true;
 		colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
@@ -1035,44 +1920,120 @@ private:
 		colorBlending.attachmentCount = 1;
 		colorBlending.pAttachments = &colorBlendAttachment;
 
+		VkPipelineColorBlendAttachmentState opaqueColorBlendAttachment = colorBlendAttachment;
+		opaqueColorBlendAttachment.blendEnable = false;
+
+		VkPipelineColorBlendStateCreateInfo opaqueColorBlending = colorBlending;
+		opaqueColorBlending.pAttachments = &opaqueColorBlendAttachment;
+
 		size_t pipelineCount = 0;
-		for (const auto& module : modules) pipelineCount += module.layers.size();
+		for (const auto& module : moduleSet) pipelineCount += module.layers.size();
 
+		// elements are referenced by pointer, so none of these may reallocate
 		std::vector<VkSpecializationInfo> specializationInfos;
-		specializationInfos.reserve(modules.size());
+		specializationInfos.reserve(moduleSet.size() + pipelineCount);
+		std::vector<std::vector<SpecializationConstant>> targetConstants;
+		targetConstants.reserve(pipelineCount);
+		std::vector<VkViewport> viewports;
+		viewports.reserve(pipelineCount);
+		std::vector<VkRect2D> scissors;
+		scissors.reserve(pipelineCount);
+		std::vector<VkPipelineViewportStateCreateInfo> viewportStates;
+		viewportStates.reserve(pipelineCount);
 		std::vector<std::array<VkPipelineShaderStageCreateInfo, 2>> shaderStages;
 		shaderStages.reserve(pipelineCount);
 		std::vector<VkGraphicsPipelineCreateInfo> pipelineInfos;
 		pipelineInfos.reserve(pipelineCount);
 
-		for (uint32_t module = 0; module < modules.size(); ++module) {
+		for (auto& module : moduleSet) {
+			module.instances = 1;
+			if (module.instanceCount) {
+				std::unordered_map<std::string, float> variables = {
+				    {"width", static_cast<float>(extent.width)},
+				    {"height", static_cast<float>(extent.height)}};
+				// parameters don't shadow the window size
+				for (size_t i = 0; i < module.parameterNames.size(); ++i)
+					variables.emplace(
+					    module.parameterNames[i],
+					    std::visit([](auto v) { return static_cast<float>(v); },
+					               module.specializationConstants.data[builtinConstantCount + i]));
+
+				module.instances = static_cast<uint32_t>(
+				    std::max(calculate<float>(module.instanceCount.value(), variables), 0.f));
+			}
+
+			module.specializationConstants.data[2] = extent.width;
+			module.specializationConstants.data[3] = extent.height;
+			module.specializationConstants.data[5] = module.instances;
+		}
+
+		for (uint32_t module = 0; module < moduleSet.size(); ++module) {
 			VkSpecializationInfo specializationInfo = {};
 			specializationInfo.mapEntryCount =
-			    modules[module].specializationConstants.specializationInfo.size();
+			    moduleSet[module].specializationConstants.specializationInfo.size();
 			specializationInfo.pMapEntries =
-			    modules[module].specializationConstants.specializationInfo.data();
-			specializationInfo.dataSize = modules[module].specializationConstants.data.size() *
+			    moduleSet[module].specializationConstants.specializationInfo.data();
+			specializationInfo.dataSize = moduleSet[module].specializationConstants.data.size() *
 			                              sizeof(SpecializationConstant);
-			specializationInfo.pData = modules[module].specializationConstants.data.data();
+			specializationInfo.pData = moduleSet[module].specializationConstants.data.data();
 			specializationInfos.push_back(specializationInfo);
+			const VkSpecializationInfo* moduleSpecialization = &specializationInfos.back();
+
+			for (uint32_t layer = 0; layer < moduleSet[module].layers.size(); ++layer) {
+				const auto& target = moduleSet[module].layers[layer].target;
+
+				// the viewport always covers the window so that modules see the same coordinates,
+				// the scissor restricts rasterization to the bounds declared by the module
+				VkExtent2D layerExtent = extent;
+				VkRect2D scissor = moduleScissor(moduleSet[module], extent);
+				const VkSpecializationInfo* layerSpecialization = moduleSpecialization;
+
+				if (target) {
+					layerExtent =
+					    windowRelativeExtent(moduleSet[module].targets[*target].size, extent);
+					scissor = {{0, 0}, layerExtent};
+
+					// layers drawing to a target see its size as width and height
+					targetConstants.push_back(moduleSet[module].specializationConstants.data);
+					targetConstants.back()[2] = layerExtent.width;
+					targetConstants.back()[3] = layerExtent.height;
+
+					specializationInfos.push_back(*moduleSpecialization);
+					specializationInfos.back().pData = targetConstants.back().data();
+					layerSpecialization = &specializationInfos.back();
+				}
 
-			for (uint32_t layer = 0; layer < modules[module].layers.size(); ++layer) {
-				modules[module].specializationConstants.data[2] = swapChainExtent.width;
-				modules[module].specializationConstants.data[3] = swapChainExtent.height;
+				VkViewport viewport = {};
+				viewport.x = 0.0f;
+				viewport.y = 0.0f;
+				viewport.width = static_cast<float>(layerExtent.width);
+				viewport.height = static_cast<float>(layerExtent.height);
+				viewport.minDepth = 0.0f;
+				viewport.maxDepth = 1.0f;
+				viewports.push_back(viewport);
+				scissors.push_back(scissor);
+
+				VkPipelineViewportStateCreateInfo viewportState = {};
+				viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+				viewportState.viewportCount = 1;
+				viewportState.pViewports = &viewports.back();
+				viewportState.scissorCount = 1;
+				viewportState.pScissors = &scissors.back();
+				viewportStates.push_back(viewportState);
 
 				VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
 				vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 				vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-				vertShaderStageInfo.module = modules[module].layers[layer].vertShaderModule;
+				vertShaderStageInfo.module = moduleSet[module].layers[layer].vertShaderModule;
 				vertShaderStageInfo.pName = "main";
-				vertShaderStageInfo.pSpecializationInfo = &specializationInfos.back();
+				vertShaderStageInfo.pSpecializationInfo = layerSpecialization;
 
 				VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
 				fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 				fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-				fragShaderStageInfo.module = modules[module].layers[layer].fragShaderModule;
-				fragShaderStageInfo.pName = modules[module].moduleName.c_str();
-				fragShaderStageInfo.pSpecializationInfo = &specializationInfos[module];
+				fragShaderStageInfo.module = moduleSet[module].layers[layer].fragShaderModule;
+				fragShaderStageInfo.pName = moduleSet[module].moduleName.c_str();
+				fragShaderStageInfo.pSpecializationInfo = layerSpecialization;
 
 				shaderStages.push_back({vertShaderStageInfo, fragShaderStageInfo});
 
@@ -1080,16 +2041,19 @@ private:
 				pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 				pipelineInfo.stageCount = 2;
 				pipelineInfo.pStages = shaderStages.back().data();
-				pipelineInfo.pVertexInputState = &vertexInputInfo;
+				pipelineInfo.pVertexInputState =
+				    moduleSet[module].layers[layer].mesh ? &meshVertexInputInfo : &vertexInputInfo;
 				pipelineInfo.pInputAssemblyState = &inputAssembly;
-				pipelineInfo.pViewportState = &viewportState;
+				pipelineInfo.pViewportState = &viewportStates.back();
 				pipelineInfo.pRasterizationState = &rasterizer;
 				pipelineInfo.pMultisampleState = &multisampling;
 				pipelineInfo.pDepthStencilState = nullptr;
-				pipelineInfo.pColorBlendState = &colorBlending;
+				pipelineInfo.pColorBlendState =
+				    moduleSet[module].blend ? &colorBlending : &opaqueColorBlending;
 				pipelineInfo.pDynamicState = nullptr;
-				pipelineInfo.layout = pipelineLayouts[module];
-				pipelineInfo.renderPass = renderPass;
+				pipelineInfo.layout = moduleSet[module].pipelineLayout;
+				// the load variant of the target render pass is compatible with the clear variant
+				pipelineInfo.renderPass = target ? targetRenderPasses[0] : renderPass;
 				pipelineInfo.subpass = 0;
 				pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 				pipelineInfo.basePipelineIndex = 0;
@@ -1098,16 +2062,127 @@ private:
 			}
 		}
 
+		if (pipelineCount == 0) return;
+
 		std::vector<VkPipeline> pipelines(pipelineCount);
 		if (vkCreateGraphicsPipelines(device.device, VK_NULL_HANDLE, pipelines.size(),
 		                              pipelineInfos.data(), nullptr, pipelines.data()))
 			throw std::runtime_error(LOCATION "failed to create graphics pipeline!");
 
 		uint32_t i = 0;
-		for (auto& module : modules)
+		for (auto& module : moduleSet)
 			for (auto& layer : module.layers) layer.graphicsPipeline = pipelines[i++];
 	}
 
+	/**
+	 * Evaluates the size of a render target or storage image for a window of the given extent
+	 */
+	static VkExtent2D windowRelativeExtent(const std::array<std::string, 2>& size,
+	                                       VkExtent2D extent) {
+		const std::unordered_map<std::string, float> variables = {
+		    {"width", static_cast<float>(extent.width)},
+		    {"height", static_cast<float>(extent.height)}};
+
+		return {static_cast<uint32_t>(std::max(calculate<float>(size[0], variables), 1.f)),
+		        static_cast<uint32_t>(std::max(calculate<float>(size[1], variables), 1.f))};
+	}
+
+	static VkRect2D moduleScissor(const Module& module, VkExtent2D extent) {
+		VkRect2D scissor = {};
+		scissor.offset = {0, 0};
+		scissor.extent = extent;
+		if (!module.bounds) return scissor;
+
+		const std::unordered_map<std::string, float> variables = {
+		    {"width", static_cast<float>(extent.width)},
+		    {"height", static_cast<float>(extent.height)}};
+
+		std::array<float, 4> bounds;
+		for (size_t i = 0; i < bounds.size(); ++i)
+			bounds[i] = calculate<float>((*module.bounds)[i], variables);
+
+		const auto clamp = [](float value, uint32_t max) {
+			return static_cast<uint32_t>(std::clamp(value, 0.f, static_cast<float>(max)));
+		};
+		const uint32_t left = clamp(std::floor(bounds[0]), extent.width);
+		const uint32_t top = clamp(std::floor(bounds[1]), extent.height);
+		const uint32_t right = clamp(std::ceil(bounds[0] + bounds[2]), extent.width);
+		const uint32_t bottom = clamp(std::ceil(bounds[1] + bounds[3]), extent.height);
+
+		scissor.offset = {static_cast<int32_t>(left), static_cast<int32_t>(top)};
+		scissor.extent = {std::max(left, right) - left, std::max(top, bottom) - top};
+		return scissor;
+	}
+
+	void createComputePipelines(std::vector<Module>& moduleSet) {
+		std::vector<VkSpecializationInfo> specializationInfos;
+		specializationInfos.reserve(moduleSet.size());
+		std::vector<VkComputePipelineCreateInfo> pipelineInfos;
+
+		for (auto& module : moduleSet) {
+			VkSpecializationInfo specializationInfo = {};
+			specializationInfo.mapEntryCount = module.specializationConstants.specializationInfo.size();
+			specializationInfo.pMapEntries = module.specializationConstants.specializationInfo.data();
+			specializationInfo.dataSize =
+			    module.specializationConstants.data.size() * sizeof(SpecializationConstant);
+			specializationInfo.pData = module.specializationConstants.data.data();
+			specializationInfos.push_back(specializationInfo);
+
+			for (auto& layer : module.computeLayers) {
+				VkComputePipelineCreateInfo pipelineInfo = {};
+				pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+				pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+				pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+				pipelineInfo.stage.module = layer.shaderModule;
+				pipelineInfo.stage.pName = "main";
+				pipelineInfo.stage.pSpecializationInfo = &specializationInfos.back();
+				pipelineInfo.layout = module.pipelineLayout;
+				pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+				pipelineInfo.basePipelineIndex = 0;
+
+				pipelineInfos.push_back(pipelineInfo);
+			}
+		}
+
+		if (pipelineInfos.empty()) return;
+
+		std::vector<VkPipeline> pipelines(pipelineInfos.size());
+		if (vkCreateComputePipelines(device.device, VK_NULL_HANDLE, pipelines.size(),
+		                             pipelineInfos.data(), nullptr, pipelines.data()))
+			throw std::runtime_error(LOCATION "failed to create compute pipeline!");
+
+		uint32_t i = 0;
+		for (auto& module : moduleSet)
+			for (auto& layer : module.computeLayers) layer.computePipeline = pipelines[i++];
+	}
+
+	/**
+	 * Creates the graphics and compute pipelines of every module for the given extent
+	 */
+	void createPipelines(std::vector<Module>& moduleSet, VkExtent2D extent) {
+		createGraphicsPipelines(moduleSet, extent);
+		createComputePipelines(moduleSet);
+	}
+
+	void destroyPipelines(std::vector<Module>& moduleSet) {
+		destroyGraphicsPipelines(moduleSet);
+		for (auto& module : moduleSet) {
+			for (auto& layer : module.computeLayers) {
+				vkDestroyPipeline(device.device, layer.computePipeline, nullptr);
+				layer.computePipeline = VK_NULL_HANDLE;
+			}
+		}
+	}
+
+	void destroyGraphicsPipelines(std::vector<Module>& moduleSet) {
+		for (auto& module : moduleSet) {
+			for (auto& layer : module.layers) {
+				vkDestroyPipeline(device.device, layer.graphicsPipeline, nullptr);
+				layer.graphicsPipeline = VK_NULL_HANDLE;
+			}
+		}
+	}
+
 	VkShaderModule createShaderModule(const std::vector<char>& shaderCode) {
 		VkShaderModuleCreateInfo shaderModuleInfo = {};
 		shaderModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -1131,7 +2206,9 @@ private:
 		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		// offscreen images are left ready to be copied from
+		colorAttachment.finalLayout = settings.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+		                                                : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
 		VkAttachmentReference colorAttachmentRef = {};
 		colorAttachmentRef.attachment = 0;
@@ -1164,6 +2241,64 @@ private:
 			throw std::runtime_error(LOCATION "failed to create render pass!");
 	}
 
+	void createTargetRenderPasses() {
+		for (size_t i = 0; i < targetRenderPasses.size(); ++i) {
+			const bool clear = i == 0;
+
+			VkAttachmentDescription colorAttachment = {};
+			colorAttachment.format = renderTargetFormat;
+			colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+			colorAttachment.loadOp = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+			colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			colorAttachment.initialLayout =
+			    clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+			VkAttachmentReference colorAttachmentRef = {};
+			colorAttachmentRef.attachment = 0;
+			colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+			VkSubpassDescription subpass = {};
+			subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			subpass.colorAttachmentCount = 1;
+			subpass.pColorAttachments = &colorAttachmentRef;
+
+			// earlier reads of the target, or of a target sharing its memory, have to finish
+			// before it is drawn to, and later passes sample what was drawn
+			std::array<VkSubpassDependency, 2> dependencies = {};
+			dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+			dependencies[0].dstSubpass = 0;
+			dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+			                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			dependencies[0].dstAccessMask =
+			    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+			dependencies[1].srcSubpass = 0;
+			dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+			dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			VkRenderPassCreateInfo renderPassInfo = {};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+			renderPassInfo.attachmentCount = 1;
+			renderPassInfo.pAttachments = &colorAttachment;
+			renderPassInfo.subpassCount = 1;
+			renderPassInfo.pSubpasses = &subpass;
+			renderPassInfo.dependencyCount = dependencies.size();
+			renderPassInfo.pDependencies = dependencies.data();
+
+			if (vkCreateRenderPass(device.device, &renderPassInfo, nullptr,
+			                       &targetRenderPasses[i]) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to create render pass!");
+		}
+	}
+
 	void createFramebuffers() {
 		swapChainFramebuffers.resize(swapChainImageViews.size());
 
@@ -1196,6 +2331,112 @@ private:
 			throw std::runtime_error(LOCATION "failed to create command pool!");
 	}
 
+	/**
+	 * Dispatches the compute layers of every module, separated by barriers so that each
+	 * dispatch sees the writes of the previous ones and the graphics layers see all of them
+	 */
+	void recordComputeLayers(VkCommandBuffer commandBuffer, size_t swapChainImage) {
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+		const VkPipelineStageFlags shaderStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+		                                          VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+		                                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+		const std::unordered_map<std::string, float> variables = {
+		    {"width", static_cast<float>(swapChainExtent.width)},
+		    {"height", static_cast<float>(swapChainExtent.height)}};
+
+		bool firstDispatch = true;
+		for (size_t module = 0; module < modules.size(); ++module) {
+			if (modules[module].computeLayers.empty()) continue;
+
+			// storage resources are shared between frames, so wait for the previous frame to
+			// finish reading them before they are written again
+			if (firstDispatch)
+				vkCmdPipelineBarrier(commandBuffer, shaderStages,
+				                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0,
+				                     nullptr, 0, nullptr);
+			firstDispatch = false;
+
+			std::array<uint32_t, 3> workGroups;
+			for (size_t i = 0; i < workGroups.size(); ++i)
+				workGroups[i] = static_cast<uint32_t>(
+				    std::max(calculate<float>(modules[module].workGroups[i], variables), 0.f));
+
+			std::array<VkDescriptorSet, 2> sets = {commonDescriptorSets[swapChainImage],
+			                                       descriptorSets[swapChainImage][module]};
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+			                        modules[module].pipelineLayout, 0, sets.size(), sets.data(),
+			                        0, nullptr);
+
+			for (const auto& layer : modules[module].computeLayers) {
+				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+				                  layer.computePipeline);
+				vkCmdDispatch(commandBuffer, workGroups[0], workGroups[1], workGroups[2]);
+
+				vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				                     shaderStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+			}
+		}
+	}
+
+	/**
+	 * Draws a graphics layer of module, indexed from its mesh if it has one
+	 */
+	static void recordLayer(VkCommandBuffer commandBuffer, const Module& module, uint32_t layer) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+		                  module.layers[layer].graphicsPipeline);
+
+		if (!module.layers[layer].mesh) {
+			vkCmdDraw(commandBuffer, module.vertexCount, module.instances, 0, 0);
+			return;
+		}
+
+		const auto& mesh = module.meshes[*module.layers[layer].mesh];
+		VkDeviceSize offset = 0;
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mesh.vertexBuffer.buffer, &offset);
+		vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+		vkCmdDrawIndexed(commandBuffer, mesh.indexCount, module.instances, 0, 0, 0);
+	}
+
+	/**
+	 * Draws the layers of every module that render to offscreen targets, each in its own
+	 * render pass whose dependencies order it against the passes sampling the target
+	 */
+	void recordTargetPasses(VkCommandBuffer commandBuffer, size_t swapChainImage) {
+		VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 0.0f}}};
+
+		for (size_t module = 0; module < modules.size(); ++module) {
+			if (modules[module].renderGraph.passes.empty()) continue;
+
+			std::array<VkDescriptorSet, 2> sets = {commonDescriptorSets[swapChainImage],
+			                                       descriptorSets[swapChainImage][module]};
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+			                        modules[module].pipelineLayout, 0, sets.size(), sets.data(),
+			                        0, nullptr);
+
+			for (const auto& pass : modules[module].renderGraph.passes) {
+				const auto& target = modules[module].targets[pass.target];
+
+				VkRenderPassBeginInfo renderPassInfo = {};
+				renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+				renderPassInfo.renderPass = targetRenderPasses[pass.clear ? 0 : 1];
+				renderPassInfo.framebuffer = target.framebuffer;
+				renderPassInfo.renderArea.offset = {0, 0};
+				renderPassInfo.renderArea.extent = target.extent;
+				renderPassInfo.clearValueCount = pass.clear ? 1 : 0;
+				renderPassInfo.pClearValues = &clearColor;
+
+				vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+				recordLayer(commandBuffer, modules[module], pass.layer);
+				vkCmdEndRenderPass(commandBuffer);
+			}
+		}
+	}
+
 	void createCommandBuffers() {
 		commandBuffers.resize(swapChainFramebuffers.size());
 
@@ -1218,6 +2459,13 @@ private:
 			if (vkBeginCommandBuffer(commandBuffers[i], &beginInfo) != VK_SUCCESS)
 				throw std::runtime_error(LOCATION "failed to begin recording command buffer!");
 
+			const auto firstQuery = static_cast<uint32_t>(2 * i);
+			if (timestampPool) {
+				vkCmdResetQueryPool(commandBuffers[i], timestampPool, firstQuery, 2);
+				vkCmdWriteTimestamp(commandBuffers[i], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+				                    timestampPool, firstQuery);
+			}
+
 			VkRenderPassBeginInfo renderPassInfo = {};
 			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 			renderPassInfo.renderPass = renderPass;
@@ -1228,23 +2476,33 @@ private:
 			renderPassInfo.clearValueCount = 1;
 			renderPassInfo.pClearValues = &clearColor;
 
+			if (std::any_of(modules.begin(), modules.end(),
+			                [](const auto& module) { return module.spectrumImage; }))
+				recordSpectrumImageUpdate(commandBuffers[i], i);
+			recordComputeLayers(commandBuffers[i], i);
+			recordTargetPasses(commandBuffers[i], i);
+
 			vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-			vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
-			                        pipelineLayouts[0], 0, 1, &commonDescriptorSets[i], 0, nullptr);
 			for (size_t module = 0; module < modules.size(); ++module) {
+				// set 0 is identical across all modules so it only needs to be bound once
+				if (module == 0)
+					vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
+					                        modules[module].pipelineLayout, 0, 1,
+					                        &commonDescriptorSets[i], 0, nullptr);
 				vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
-				                        pipelineLayouts[module], 1, 1, &descriptorSets[i][module],
-				                        0, nullptr);
-				for (const auto& layer : modules[module].layers) {
-					vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
-					                  layer.graphicsPipeline);
-					vkCmdDraw(commandBuffers[i], modules[module].vertexCount, 1, 0, 0);
-				}
+				                        modules[module].pipelineLayout, 1, 1,
+				                        &descriptorSets[i][module], 0, nullptr);
+				for (auto layer : modules[module].renderGraph.windowLayers)
+					recordLayer(commandBuffers[i], modules[module], layer);
 			}
 
 			vkCmdEndRenderPass(commandBuffers[i]);
 
+			if (timestampPool)
+				vkCmdWriteTimestamp(commandBuffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				                    timestampPool, firstQuery + 1);
+
 			if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS)
 				throw std::runtime_error(LOCATION "failed to record command buffer!");
 		}
@@ -1275,14 +2533,17 @@ private:
 		vkFreeCommandBuffers(device.device, commandPool,
 		                     static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
 
-		for (size_t i = 0; i < modules.size(); ++i)
-			for (auto& graphicsPipeline : modules[i].layers)
-				vkDestroyPipeline(device.device, graphicsPipeline.graphicsPipeline, nullptr);
+		destroyPipelines(modules);
 
 		for (auto imageView : swapChainImageViews)
 			vkDestroyImageView(device.device, imageView, nullptr);
 
-		vkDestroySwapchainKHR(device.device, swapChain, nullptr);
+		if (settings.headless) {
+			for (auto& image : offscreenImages) Image::destroy(image);
+			offscreenImages.clear();
+		} else {
+			vkDestroySwapchainKHR(device.device, swapChain, nullptr);
+		}
 	}
 
 	void recreateSwapChain() {
@@ -1290,17 +2551,44 @@ private:
 
 		vkDeviceWaitIdle(device.device);
 
+		destroyRetiredModules(true);
 		cleanupSwapChain();
 
 		createSwapchain();
+		if (timestampsPending.size() != swapChainImages.size()) {
+			vkDestroyQueryPool(device.device, timestampPool, nullptr);
+			timestampPool = VK_NULL_HANDLE;
+			createTimestampQueries();
+		}
 		createImageViews();
-		createGraphicsPipelines();
+		createPipelines(modules, swapChainExtent);
 		createFramebuffers();
+
+		// render targets and storage images are sized relative to the window
+		bool resized = false;
+		for (auto& module : modules) {
+			if (!module.targets.empty()) {
+				Module::destroyTargets(device.device, module);
+				createRenderTargets(module);
+				resized = true;
+			}
+			resized |= resizeStorageImages(module);
+		}
+
+		if (resized) {
+			vkDestroyDescriptorPool(device.device, descriptorPool, nullptr);
+			createDescriptorPool();
+			createDescriptorSets();
+		}
+
 		createCommandBuffers();
 	}
 
-	void createModuleImages() {
-		for (auto& module : modules) {
+	/**
+	 * Creates the resources of the given modules which require the graphics queue
+	 */
+	void createModuleResources(std::vector<Module>& moduleSet) {
+		for (auto& module : moduleSet) {
 			for (auto& image : module.images) {
 				std::filesystem::path path = image.path;
 				if (!path.empty() && path.is_relative()) path = module.location / path;
@@ -1308,6 +2596,428 @@ private:
 				image.rsrc.view = createImageView(image.rsrc.image, VK_FORMAT_R8G8B8A8_UNORM);
 				image.rsrc.sampler = createImageSampler();
 			}
+
+			createStorageResources(module);
+			createRenderTargets(module);
+			createMeshBuffers(module);
+			createTables(module);
+
+			if (module.dynamicParameters.empty()) continue;
+
+			module.parameterBuffers.resize(swapChainImages.size());
+			for (auto& buffer : module.parameterBuffers)
+				buffer = Buffer(device, module.dynamicParameters.size() * sizeof(uint32_t),
+				                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+				                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+				                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+			// force an upload on first use
+			module.uploadedParameterRevisions.assign(swapChainImages.size(),
+			                                         module.parameterRevision - 1);
+		}
+	}
+
+	/**
+	 * Uploads the buffers and lookup tables of module to device local memory, loading the
+	 * values of those that refer to a file
+	 */
+	void createTables(Module& module) {
+		if (module.buffers.empty() && module.luts.empty()) return;
+
+		auto loadValues = [&](auto& table) {
+			if (table.path.empty()) return;
+
+			std::filesystem::path path = table.path;
+			if (path.is_relative()) path = module.location / path;
+			std::ifstream file(path);
+			if (!file.is_open())
+				throw std::runtime_error(LOCATION "failed to open '" + path.string() + "'!");
+
+			try {
+				table.values = parseValues(file);
+			} catch (const std::invalid_argument& e) {
+				throw std::runtime_error(LOCATION "failed to read '" + path.string() +
+				                         "': " + e.what());
+			}
+			if (table.values.empty())
+				throw std::runtime_error(LOCATION "'" + path.string() + "' has no values!");
+		};
+
+		VkDeviceSize stagingSize = 0;
+		for (auto& buffer : module.buffers) {
+			loadValues(buffer);
+			stagingSize += buffer.values.size() * sizeof(float);
+		}
+		for (auto& lut : module.luts) {
+			loadValues(lut);
+			if (lut.values.size() % 4 != 0)
+				throw std::runtime_error(LOCATION "lookup table '" + lut.path.string() +
+				                         "' does not have four values per texel!");
+			stagingSize += lut.values.size() * sizeof(float);
+		}
+
+		Buffer stagingBuffer(device, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+		                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		                     true);
+		auto* staging = static_cast<float*>(stagingBuffer.mapMemory());
+
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+		VkDeviceSize offset = 0;
+
+		for (auto& buffer : module.buffers) {
+			const VkDeviceSize size = buffer.values.size() * sizeof(float);
+			std::copy(buffer.values.begin(), buffer.values.end(), staging + offset / sizeof(float));
+
+			buffer.rsrc = Buffer(device, size,
+			                     VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT |
+			                         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			buffer.rsrc.createBufferView(VK_FORMAT_R32_SFLOAT);
+
+			VkBufferCopy copyRegion = {};
+			copyRegion.srcOffset = offset;
+			copyRegion.dstOffset = 0;
+			copyRegion.size = size;
+			vkCmdCopyBuffer(commandBuffer, stagingBuffer.buffer, buffer.rsrc.buffer, 1,
+			                &copyRegion);
+
+			offset += size;
+		}
+
+		// 32 bit float formats are not required to support linear filtering
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(device.physicalDevice, lutFormat, &formatProperties);
+		const VkFilter lutFilter = formatProperties.optimalTilingFeatures &
+		                                   VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT
+		                               ? VK_FILTER_LINEAR
+		                               : VK_FILTER_NEAREST;
+
+		VkImageSubresourceRange range = {};
+		range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		range.baseMipLevel = 0;
+		range.levelCount = 1;
+		range.baseArrayLayer = 0;
+		range.layerCount = 1;
+
+		for (auto& lut : module.luts) {
+			const auto texels = static_cast<uint32_t>(lut.values.size() / 4);
+			std::copy(lut.values.begin(), lut.values.end(), staging + offset / sizeof(float));
+
+			lut.rsrc = Image(device, texels, 1, VK_IMAGE_TYPE_1D, lutFormat, VK_IMAGE_TILING_OPTIMAL,
+			                 VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			lut.rsrc.view = createImageView(lut.rsrc.image, lutFormat, VK_IMAGE_VIEW_TYPE_1D);
+			lut.rsrc.sampler = createImageSampler(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, lutFilter);
+
+			VkImageMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = lut.rsrc.image;
+			barrier.subresourceRange = range;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			                     VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+			                     &barrier);
+
+			VkBufferImageCopy region = {};
+			region.bufferOffset = offset;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = 0;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = {0, 0, 0};
+			region.imageExtent = {texels, 1, 1};
+			vkCmdCopyBufferToImage(commandBuffer, stagingBuffer.buffer, lut.rsrc.image,
+			                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+			                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+			                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			                     0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			offset += lut.values.size() * sizeof(float);
+		}
+
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		                     0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		endSingleTimeCommands(commandBuffer);
+
+		stagingBuffer.unmapMemory();
+		Buffer::destroy(stagingBuffer);
+	}
+
+	/**
+	 * Loads the meshes of module and uploads them to device local vertex and index buffers
+	 * through a single staging buffer
+	 */
+	void createMeshBuffers(Module& module) {
+		if (module.meshes.empty()) return;
+		TRACE_SCOPE("loadMeshes");
+
+		std::vector<Mesh> meshData;
+		meshData.reserve(module.meshes.size());
+		VkDeviceSize stagingSize = 0;
+		for (auto& mesh : module.meshes) {
+			std::filesystem::path path = mesh.path;
+			if (path.is_relative()) path = module.location / path;
+			meshData.push_back(loadMesh(path));
+			if (meshData.back().indices.empty())
+				throw std::runtime_error(LOCATION "mesh '" + path.string() + "' is empty!");
+
+			stagingSize += meshData.back().vertices.size() * sizeof(Mesh::Vertex) +
+			               meshData.back().indices.size() * sizeof(uint32_t);
+		}
+
+		Buffer stagingBuffer(device, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+		                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		                     true);
+		auto* staging = static_cast<char*>(stagingBuffer.mapMemory());
+
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+
+		VkDeviceSize offset = 0;
+		auto upload = [&](const void* data, VkDeviceSize size, VkBufferUsageFlags usage) {
+			std::memcpy(staging + offset, data, size);
+
+			Buffer buffer(device, size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+			VkBufferCopy copyRegion = {};
+			copyRegion.srcOffset = offset;
+			copyRegion.dstOffset = 0;
+			copyRegion.size = size;
+			vkCmdCopyBuffer(commandBuffer, stagingBuffer.buffer, buffer.buffer, 1, &copyRegion);
+
+			offset += size;
+			return buffer;
+		};
+
+		for (size_t i = 0; i < module.meshes.size(); ++i) {
+			const auto& mesh = meshData[i];
+			module.meshes[i].indexCount = static_cast<uint32_t>(mesh.indices.size());
+			module.meshes[i].vertexBuffer =
+			    upload(mesh.vertices.data(), mesh.vertices.size() * sizeof(Mesh::Vertex),
+			           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+			module.meshes[i].indexBuffer =
+			    upload(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t),
+			           VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+		}
+
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                     VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0,
+		                     nullptr);
+
+		endSingleTimeCommands(commandBuffer);
+
+		stagingBuffer.unmapMemory();
+		Buffer::destroy(stagingBuffer);
+	}
+
+	/**
+	 * Creates the storage buffers and images of module, cleared to zero. They are shared
+	 * by all frames since their contents persist from one frame to the next.
+	 */
+	void createStorageResources(Module& module) {
+		if (module.storageBuffers.empty() && module.storageImages.empty()) return;
+
+		for (auto& buffer : module.storageBuffers)
+			buffer.rsrc = Buffer(device, buffer.size,
+			                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		std::vector<StorageImage*> images;
+		for (auto& image : module.storageImages) {
+			createStorageImage(image);
+			images.push_back(&image);
+		}
+
+		clearStorageResources(module.storageBuffers, images);
+	}
+
+	/**
+	 * Recreates the storage images of module whose size changed with the window, cleared to
+	 * zero. Returns true if any image was recreated.
+	 */
+	bool resizeStorageImages(Module& module) {
+		std::vector<StorageImage*> images;
+		for (auto& image : module.storageImages) {
+			const auto extent = windowRelativeExtent(image.size, swapChainExtent);
+			if (extent.width == image.extent.width && extent.height == image.extent.height)
+				continue;
+
+			Image::destroy(image.rsrc);
+			createStorageImage(image);
+			images.push_back(&image);
+		}
+		if (images.empty()) return false;
+
+		clearStorageResources({}, images);
+		return true;
+	}
+
+	void createStorageImage(StorageImage& image) {
+		image.extent = windowRelativeExtent(image.size, swapChainExtent);
+		image.rsrc = Image(device, image.extent.width, image.extent.height, VK_IMAGE_TYPE_2D,
+		                   storageImageFormat, VK_IMAGE_TILING_OPTIMAL,
+		                   VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+		                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		image.rsrc.view = createImageView(image.rsrc.image, storageImageFormat);
+		image.rsrc.sampler = VK_NULL_HANDLE;
+	}
+
+	/**
+	 * Clears the given storage buffers and images to zero before the shaders access them
+	 */
+	void clearStorageResources(const std::vector<StorageBuffer>& buffers,
+	                           const std::vector<StorageImage*>& images) {
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+
+		for (auto& buffer : buffers)
+			vkCmdFillBuffer(commandBuffer, buffer.rsrc.buffer, 0, VK_WHOLE_SIZE, 0);
+
+		VkImageSubresourceRange range = {};
+		range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		range.baseMipLevel = 0;
+		range.levelCount = 1;
+		range.baseArrayLayer = 0;
+		range.layerCount = 1;
+
+		for (auto image : images) {
+			VkImageMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image->rsrc.image;
+			barrier.subresourceRange = range;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			                     VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+			                     &barrier);
+
+			VkClearColorValue clearColor = {{0.0f, 0.0f, 0.0f, 0.0f}};
+			vkCmdClearColorImage(commandBuffer, image->rsrc.image, VK_IMAGE_LAYOUT_GENERAL,
+			                     &clearColor, 1, &range);
+		}
+
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		                     0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		endSingleTimeCommands(commandBuffer);
+	}
+
+	/**
+	 * Creates the render targets of module at their size for the current window size.
+	 * Targets assigned to the same memory block of the render graph are bound to the same
+	 * allocation.
+	 */
+	void createRenderTargets(Module& module) {
+		if (module.targets.empty()) return;
+
+		std::vector<VkMemoryRequirements> blockRequirements(module.renderGraph.memoryBlockCount);
+		for (auto& requirements : blockRequirements) {
+			requirements.size = 0;
+			requirements.alignment = 1;
+			requirements.memoryTypeBits = ~0u;
+		}
+
+		for (size_t i = 0; i < module.targets.size(); ++i) {
+			auto& target = module.targets[i];
+			target.extent = windowRelativeExtent(target.size, swapChainExtent);
+
+			VkImageCreateInfo imageInfo = {};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.extent.width = target.extent.width;
+			imageInfo.extent.height = target.extent.height;
+			imageInfo.extent.depth = 1;
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.format = renderTargetFormat;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			if (vkCreateImage(device.device, &imageInfo, nullptr, &target.image) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to create render target!");
+
+			VkMemoryRequirements memRequirements;
+			vkGetImageMemoryRequirements(device.device, target.image, &memRequirements);
+
+			auto& requirements = blockRequirements[module.renderGraph.memoryBlocks[i]];
+			requirements.size = std::max(requirements.size, memRequirements.size);
+			requirements.alignment = std::max(requirements.alignment, memRequirements.alignment);
+			requirements.memoryTypeBits &= memRequirements.memoryTypeBits;
+		}
+
+		module.targetMemory.resize(blockRequirements.size(), VK_NULL_HANDLE);
+		for (size_t block = 0; block < blockRequirements.size(); ++block) {
+			VkMemoryAllocateInfo allocInfo = {};
+			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocInfo.allocationSize = blockRequirements[block].size;
+			allocInfo.memoryTypeIndex = device.findMemoryType(
+			    blockRequirements[block].memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+			if (vkAllocateMemory(device.device, &allocInfo, nullptr,
+			                     &module.targetMemory[block]) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to allocate render target memory!");
+		}
+
+		for (size_t i = 0; i < module.targets.size(); ++i) {
+			auto& target = module.targets[i];
+			vkBindImageMemory(device.device, target.image,
+			                  module.targetMemory[module.renderGraph.memoryBlocks[i]], 0);
+
+			target.view = createImageView(target.image, renderTargetFormat);
+			target.sampler = createImageSampler();
+
+			VkFramebufferCreateInfo framebufferInfo = {};
+			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			framebufferInfo.renderPass = targetRenderPasses[0];
+			framebufferInfo.attachmentCount = 1;
+			framebufferInfo.pAttachments = &target.view;
+			framebufferInfo.width = target.extent.width;
+			framebufferInfo.height = target.extent.height;
+			framebufferInfo.layers = 1;
+
+			if (vkCreateFramebuffer(device.device, &framebufferInfo, nullptr,
+			                        &target.framebuffer) != VK_SUCCESS)
+				throw std::runtime_error(LOCATION "failed to create framebuffer!");
 		}
 	}
 
@@ -1318,12 +3028,13 @@ private:
 	}
 
 	void createTextureImage(const std::filesystem::path& imagePath, Image& image) {
+		TRACE_SCOPE("loadTexture");
 		ImageFile img;
 		if (!imagePath.empty()) img.open(imagePath);
 
 		Buffer stagingBuffer(
 		    device, img.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true);
 
 		void* data = stagingBuffer.mapMemory();
 		for (size_t y = 0; y < img.height(); ++y)
@@ -1373,9 +3084,18 @@ private:
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &commandBuffer;
 
-		vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(graphicsQueue);
+		VkFenceCreateInfo fenceInfo = {};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 
+		VkFence fence;
+		if (vkCreateFence(device.device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create fence!");
+
+		// wait for these commands only, not for the frames in flight
+		vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence);
+		vkWaitForFences(device.device, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+
+		vkDestroyFence(device.device, fence, nullptr);
 		vkFreeCommandBuffers(device.device, commandPool, 1, &commandBuffer);
 	}
 
@@ -1444,15 +3164,17 @@ private:
 		endSingleTimeCommands(commandBuffer);
 	}
 
-	VkImageView createImageView(VkImage image, VkFormat format) {
+	VkImageView createImageView(VkImage image, VkFormat format,
+	                            VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D,
+	                            uint32_t mipLevels = 1) {
 		VkImageViewCreateInfo viewInfo = {};
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		viewInfo.image = image;
-		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.viewType = viewType;
 		viewInfo.format = format;
 		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.levelCount = mipLevels;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 1;
 
@@ -1463,14 +3185,16 @@ private:
 		return imageView;
 	}
 
-	VkSampler createImageSampler() {
+	VkSampler createImageSampler(
+	    VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT,
+	    VkFilter filter = VK_FILTER_LINEAR, float maxLod = 0.f) {
 		VkSamplerCreateInfo samplerInfo = {};
 		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-		samplerInfo.magFilter = VK_FILTER_LINEAR;
-		samplerInfo.minFilter = VK_FILTER_LINEAR;
-		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
-		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
-		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+		samplerInfo.magFilter = filter;
+		samplerInfo.minFilter = filter;
+		samplerInfo.addressModeU = addressMode;
+		samplerInfo.addressModeV = addressMode;
+		samplerInfo.addressModeW = addressMode;
 		samplerInfo.anisotropyEnable = VK_FALSE;
 		samplerInfo.maxAnisotropy = 1;
 		samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
@@ -1480,7 +3204,7 @@ private:
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 		samplerInfo.mipLodBias = 0.0f;
 		samplerInfo.minLod = 0.0f;
-		samplerInfo.maxLod = 0.0f;
+		samplerInfo.maxLod = maxLod;
 
 		VkSampler sampler;
 		if (vkCreateSampler(device.device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
@@ -1490,75 +3214,154 @@ private:
 	}
 
 	void createDescriptorSetLayouts() {
-		{
-			VkDescriptorSetLayoutBinding dataLayoutBinding = {};
-			dataLayoutBinding.binding = 0;
-			dataLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			dataLayoutBinding.descriptorCount = 1;
-			dataLayoutBinding.pImmutableSamplers = nullptr;
-			dataLayoutBinding.stageFlags =
-			    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT;
-
-			VkDescriptorSetLayoutBinding lAudioBufferLayoutBinding = {};
-			lAudioBufferLayoutBinding.binding = 1;
-			lAudioBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-			lAudioBufferLayoutBinding.descriptorCount = 1;
-			lAudioBufferLayoutBinding.pImmutableSamplers = nullptr;
-			lAudioBufferLayoutBinding.stageFlags =
-			    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT;
-
-			VkDescriptorSetLayoutBinding rAudioBufferLayoutBinding = {};
-			rAudioBufferLayoutBinding.binding = 2;
-			rAudioBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-			rAudioBufferLayoutBinding.descriptorCount = 1;
-			rAudioBufferLayoutBinding.pImmutableSamplers = nullptr;
-			rAudioBufferLayoutBinding.stageFlags =
-			    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT;
-
-			VkDescriptorSetLayoutBinding backgroundSamplerLayoutBinding = {};
-			backgroundSamplerLayoutBinding.binding = 3;
-			backgroundSamplerLayoutBinding.descriptorCount = 1;
-			backgroundSamplerLayoutBinding.descriptorType =
-			    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			backgroundSamplerLayoutBinding.pImmutableSamplers = nullptr;
-			backgroundSamplerLayoutBinding.stageFlags =
-			    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-
-			std::array<VkDescriptorSetLayoutBinding, 4> bindings = {
-			    dataLayoutBinding, lAudioBufferLayoutBinding, rAudioBufferLayoutBinding,
-			    backgroundSamplerLayoutBinding};
-
-			VkDescriptorSetLayoutCreateInfo layoutInfo = {};
-			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-			layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-			layoutInfo.pBindings = bindings.data();
-
-			if (vkCreateDescriptorSetLayout(device.device, &layoutInfo, nullptr,
-			                                &commonDescriptorSetLayout) != VK_SUCCESS)
-				throw std::runtime_error(LOCATION "failed to create descriptor set layout!");
-		}
-
-		descriptorSetLayouts.resize(modules.size());
-		for (size_t module = 0; module < modules.size(); ++module) {
-			std::vector<VkDescriptorSetLayoutBinding> bindings(modules[module].images.size());
-
-			for (size_t image = 0; image < modules[module].images.size(); ++image) {
-				bindings[image].binding = modules[module].images[image].id;
-				bindings[image].descriptorCount = 1;
-				bindings[image].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-				bindings[image].pImmutableSamplers = nullptr;
-				bindings[image].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-			}
+		VkDescriptorSetLayoutBinding dataLayoutBinding = {};
+		dataLayoutBinding.binding = 0;
+		dataLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		dataLayoutBinding.descriptorCount = 1;
+		dataLayoutBinding.pImmutableSamplers = nullptr;
+		dataLayoutBinding.stageFlags =
+		    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutBinding lAudioBufferLayoutBinding = {};
+		lAudioBufferLayoutBinding.binding = 1;
+		lAudioBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+		lAudioBufferLayoutBinding.descriptorCount = 1;
+		lAudioBufferLayoutBinding.pImmutableSamplers = nullptr;
+		lAudioBufferLayoutBinding.stageFlags =
+		    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutBinding rAudioBufferLayoutBinding = {};
+		rAudioBufferLayoutBinding.binding = 2;
+		rAudioBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+		rAudioBufferLayoutBinding.descriptorCount = 1;
+		rAudioBufferLayoutBinding.pImmutableSamplers = nullptr;
+		rAudioBufferLayoutBinding.stageFlags =
+		    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutBinding backgroundSamplerLayoutBinding = {};
+		backgroundSamplerLayoutBinding.binding = 3;
+		backgroundSamplerLayoutBinding.descriptorCount = 1;
+		backgroundSamplerLayoutBinding.descriptorType =
+		    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		backgroundSamplerLayoutBinding.pImmutableSamplers = nullptr;
+		backgroundSamplerLayoutBinding.stageFlags =
+		    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutBinding stereoAudioBufferLayoutBinding = {};
+		stereoAudioBufferLayoutBinding.binding = 4;
+		stereoAudioBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+		stereoAudioBufferLayoutBinding.descriptorCount = 1;
+		stereoAudioBufferLayoutBinding.pImmutableSamplers = nullptr;
+		stereoAudioBufferLayoutBinding.stageFlags =
+		    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutBinding spectrumImageLayoutBinding = {};
+		spectrumImageLayoutBinding.binding = 5;
+		spectrumImageLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		spectrumImageLayoutBinding.descriptorCount = 1;
+		spectrumImageLayoutBinding.pImmutableSamplers = nullptr;
+		spectrumImageLayoutBinding.stageFlags =
+		    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		std::array<VkDescriptorSetLayoutBinding, 6> bindings = {
+		    dataLayoutBinding, lAudioBufferLayoutBinding, rAudioBufferLayoutBinding,
+		    backgroundSamplerLayoutBinding, stereoAudioBufferLayoutBinding,
+		    spectrumImageLayoutBinding};
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		if (vkCreateDescriptorSetLayout(device.device, &layoutInfo, nullptr,
+		                                &commonDescriptorSetLayout) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create descriptor set layout!");
+	}
+
+	void createModuleDescriptorSetLayout(Module& module) {
+		std::vector<VkDescriptorSetLayoutBinding> bindings(module.images.size());
+
+		for (size_t image = 0; image < module.images.size(); ++image) {
+			bindings[image].binding = module.images[image].id;
+			bindings[image].descriptorCount = 1;
+			bindings[image].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			bindings[image].pImmutableSamplers = nullptr;
+			bindings[image].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+
+		for (auto& target : module.targets) {
+			VkDescriptorSetLayoutBinding binding = {};
+			binding.binding = target.id;
+			binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			binding.descriptorCount = 1;
+			binding.pImmutableSamplers = nullptr;
+			binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			bindings.push_back(binding);
+		}
+
+		// storage resources are written by compute layers and read by graphics layers
+		const VkShaderStageFlags storageStages =
+		    VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		for (auto& buffer : module.buffers) {
+			VkDescriptorSetLayoutBinding binding = {};
+			binding.binding = buffer.id;
+			binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+			binding.descriptorCount = 1;
+			binding.pImmutableSamplers = nullptr;
+			binding.stageFlags = storageStages;
+			bindings.push_back(binding);
+		}
+
+		for (auto& lut : module.luts) {
+			VkDescriptorSetLayoutBinding binding = {};
+			binding.binding = lut.id;
+			binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			binding.descriptorCount = 1;
+			binding.pImmutableSamplers = nullptr;
+			binding.stageFlags = storageStages;
+			bindings.push_back(binding);
+		}
 
-			VkDescriptorSetLayoutCreateInfo layoutInfo = {};
-			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-			layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-			layoutInfo.pBindings = bindings.data();
+		for (auto& buffer : module.storageBuffers) {
+			VkDescriptorSetLayoutBinding binding = {};
+			binding.binding = buffer.id;
+			binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			binding.descriptorCount = 1;
+			binding.pImmutableSamplers = nullptr;
+			binding.stageFlags = storageStages;
+			bindings.push_back(binding);
+		}
+
+		for (auto& image : module.storageImages) {
+			VkDescriptorSetLayoutBinding binding = {};
+			binding.binding = image.id;
+			binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			binding.descriptorCount = 1;
+			binding.pImmutableSamplers = nullptr;
+			binding.stageFlags = storageStages;
+			bindings.push_back(binding);
+		}
 
-			if (vkCreateDescriptorSetLayout(device.device, &layoutInfo, nullptr,
-			                                &descriptorSetLayouts[module]) != VK_SUCCESS)
-				throw std::runtime_error(LOCATION "failed to create descriptor set layout!");
+		if (!module.dynamicParameters.empty()) {
+			VkDescriptorSetLayoutBinding parameterLayoutBinding = {};
+			parameterLayoutBinding.binding = module.parameterBinding;
+			parameterLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			parameterLayoutBinding.descriptorCount = 1;
+			parameterLayoutBinding.pImmutableSamplers = nullptr;
+			parameterLayoutBinding.stageFlags =
+			    VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings.push_back(parameterLayoutBinding);
 		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		if (vkCreateDescriptorSetLayout(device.device, &layoutInfo, nullptr,
+		                                &module.descriptorSetLayout) != VK_SUCCESS)
+			throw std::runtime_error(LOCATION "failed to create descriptor set layout!");
 	}
 
 	void createAudioBuffers() {
@@ -1568,6 +3371,18 @@ private:
 
 		lAudioBuffers.resize(swapChainImages.size());
 		rAudioBuffers.resize(swapChainImages.size());
+		stereoAudioBuffers.resize(swapChainImages.size());
+		spectrumImages.resize(swapChainImages.size());
+
+		// down to a single texel at most
+		uint32_t maxMipLevels = 1;
+		while (settings.audioSize >> maxMipLevels) ++maxMipLevels;
+		spectrumMipLevels = std::clamp(settings.spectrumMipLevels, 1u, maxMipLevels);
+
+		// blitting and linear filtering are mandatory for the format
+		VkImageUsageFlags spectrumImageUsage =
+		    VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		if (spectrumMipLevels > 1) spectrumImageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
 		for (size_t i = 0; i < dataBuffers.size(); ++i) {
 			dataBuffers[i] =
@@ -1585,10 +3400,117 @@ private:
 			           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
 			rAudioBuffers[i].createBufferView(VK_FORMAT_R32_SFLOAT);
+
+			// two halves take as much space as a float, support for the format is mandatory
+			stereoAudioBuffers[i] =
+			    Buffer(device, bufferSize,
+			           VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+			stereoAudioBuffers[i].createBufferView(VK_FORMAT_R16G16_SFLOAT);
+
+			spectrumImages[i] = Image(device, static_cast<uint32_t>(settings.audioSize), 1,
+			                          VK_IMAGE_TYPE_1D, VK_FORMAT_R16G16_SFLOAT,
+			                          VK_IMAGE_TILING_OPTIMAL, spectrumImageUsage,
+			                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, spectrumMipLevels);
+			spectrumImages[i].view =
+			    createImageView(spectrumImages[i].image, VK_FORMAT_R16G16_SFLOAT,
+			                    VK_IMAGE_VIEW_TYPE_1D, spectrumMipLevels);
+			spectrumImages[i].sampler =
+			    createImageSampler(VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT, VK_FILTER_LINEAR,
+			                       static_cast<float>(spectrumMipLevels - 1));
+		}
+	}
+
+	/**
+	 * Copies the stereoBuffer of the frame to its spectrumImage and generates the mip levels
+	 * by halving the previous level with a linear blit
+	 */
+	void recordSpectrumImageUpdate(VkCommandBuffer commandBuffer, size_t frame) {
+		const VkImage image = spectrumImages[frame].image;
+
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = spectrumMipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		// the previous contents are overwritten, only wait for the last frame's reads
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		vkCmdPipelineBarrier(commandBuffer,
+		                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		                     VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+		                     &barrier);
+
+		auto width = static_cast<int32_t>(settings.audioSize);
+
+		VkBufferImageCopy region = {};
+		region.bufferOffset = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = {0, 0, 0};
+		region.imageExtent = {static_cast<uint32_t>(width), 1, 1};
+		vkCmdCopyBufferToImage(commandBuffer, stereoAudioBuffers[frame].buffer, image,
+		                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		barrier.subresourceRange.levelCount = 1;
+		for (uint32_t level = 1; level < spectrumMipLevels; ++level) {
+			barrier.subresourceRange.baseMipLevel = level - 1;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			                     VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+			                     &barrier);
+
+			VkImageBlit blit = {};
+			blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1};
+			blit.srcOffsets[1] = {width, 1, 1};
+			width = std::max(width / 2, 1);
+			blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+			blit.dstOffsets[1] = {width, 1, 1};
+			vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image,
+			               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
 		}
+
+		// every level but the last was the source of a blit
+		std::array<VkImageMemoryBarrier, 2> barriers = {barrier, barrier};
+		barriers[0].subresourceRange.baseMipLevel = 0;
+		barriers[0].subresourceRange.levelCount = spectrumMipLevels - 1;
+		barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barriers[1].subresourceRange.baseMipLevel = spectrumMipLevels - 1;
+		barriers[1].subresourceRange.levelCount = 1;
+		barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		const uint32_t barrierCount = spectrumMipLevels > 1 ? 2 : 1;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+		                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		                     0, 0, nullptr, 0, nullptr, barrierCount,
+		                     barriers.data() + 2 - barrierCount);
 	}
 
 	void updateAudioBuffers(const AudioData& audioData, uint32_t currentFrame) {
+		TRACE_SCOPE("updateAudioBuffers");
 		static const auto startTime = std::chrono::high_resolution_clock::now();
 		const auto currentTime = std::chrono::high_resolution_clock::now();
 		void* data;
@@ -1600,33 +3522,137 @@ private:
 		    std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime).count();
 		dataBuffers[currentFrame].unmapMemory();
 
-		data = lAudioBuffers[currentFrame].mapMemory();
-		std::copy_n(audioData.lBuffer, settings.audioSize, reinterpret_cast<float*>(data));
-		lAudioBuffers[currentFrame].unmapMemory();
+		// only fill the buffers that the current modules read
+		bool separateSpectrum = false;
+		bool packedSpectrum = false;
+		for (const auto& module : modules) {
+			separateSpectrum |= module.separateSpectrum;
+			// the spectrumImage is copied from the stereoBuffer
+			packedSpectrum |= module.packedSpectrum || module.spectrumImage;
+		}
+
+		if (separateSpectrum) {
+			data = lAudioBuffers[currentFrame].mapMemory();
+			std::copy_n(audioData.lBuffer, settings.audioSize, reinterpret_cast<float*>(data));
+			lAudioBuffers[currentFrame].unmapMemory();
+
+			data = rAudioBuffers[currentFrame].mapMemory();
+			std::copy_n(audioData.rBuffer, settings.audioSize, reinterpret_cast<float*>(data));
+			rAudioBuffers[currentFrame].unmapMemory();
+		}
+
+		if (packedSpectrum) {
+			data = stereoAudioBuffers[currentFrame].mapMemory();
+			packHalf2(audioData.lBuffer, audioData.rBuffer, reinterpret_cast<uint32_t*>(data),
+			          settings.audioSize);
+			stereoAudioBuffers[currentFrame].unmapMemory();
+		}
+
+		bool frameVariablesUpdated = false;
+		for (auto& module : modules) {
+			for (auto& param : module.dynamicParameters) {
+				if (!param.expression) continue;
+
+				if (!frameVariablesUpdated) {
+					updateFrameVariables(audioData, currentTime - startTime);
+					frameVariablesUpdated = true;
+				}
+
+				const float value = param.expression->evaluate(frameVariables.data());
+				// e.g. 0/0 in the expression, keep the last valid value
+				if (std::isnan(value)) continue;
+
+				std::visit(
+				    [&](auto& v) {
+					    const auto newValue = convertParameter<std::decay_t<decltype(v)>>(value);
+					    if (v == newValue) return;
+					    v = newValue;
+					    ++module.parameterRevision;
+				    },
+				    param.value);
+			}
+
+			if (module.dynamicParameters.empty() ||
+			    module.uploadedParameterRevisions[currentFrame] == module.parameterRevision)
+				continue;
+
+			auto params =
+			    reinterpret_cast<char*>(module.parameterBuffers[currentFrame].mapMemory());
+			for (const auto& param : module.dynamicParameters) {
+				std::visit([params](auto v) { std::memcpy(params, &v, sizeof(uint32_t)); },
+				           param.value);
+				params += sizeof(uint32_t);
+			}
+			module.parameterBuffers[currentFrame].unmapMemory();
+
+			module.uploadedParameterRevisions[currentFrame] = module.parameterRevision;
+		}
+	}
 
-		data = rAudioBuffers[currentFrame].mapMemory();
-		std::copy_n(audioData.rBuffer, settings.audioSize, reinterpret_cast<float*>(data));
-		rAudioBuffers[currentFrame].unmapMemory();
+	/**
+	 * Sets the time in seconds, the volumes and the mean of the low, middle and high thirds of
+	 * the spectrum averaged over both channels
+	 */
+	void updateFrameVariables(const AudioData& audioData, std::chrono::duration<float> time) {
+		std::array<float, 3> bands = {};
+		const size_t bandSize = std::max<size_t>(settings.audioSize / bands.size(), 1);
+		for (size_t i = 0; i < settings.audioSize; ++i)
+			bands[std::min(i / bandSize, bands.size() - 1)] +=
+			    audioData.lBuffer[i] + audioData.rBuffer[i];
+
+		frameVariables[0] = time.count();
+		frameVariables[1] = 0.5f * (audioData.lVolume + audioData.rVolume);
+		frameVariables[2] = audioData.lVolume;
+		frameVariables[3] = audioData.rVolume;
+		for (size_t band = 0; band < bands.size(); ++band) {
+			const size_t first = band * bandSize;
+			const size_t last = band + 1 == bands.size() ? settings.audioSize : first + bandSize;
+			frameVariables[4 + band] =
+			    last > first ? bands[band] / (2.f * static_cast<float>(last - first)) : 0.f;
+		}
 	}
 
 	void createDescriptorPool() {
-		std::array<VkDescriptorPoolSize, 4> poolSizes = {};
+		size_t parameterBufferCount = 0;
+		size_t texelBufferCount = 0;
+		for (auto& module : modules) {
+			parameterBufferCount += !module.dynamicParameters.empty();
+			texelBufferCount += module.buffers.size();
+		}
+
+		std::array<VkDescriptorPoolSize, 6> poolSizes = {};
 		poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		poolSizes[0].descriptorCount =
-		    static_cast<uint32_t>(swapChainImages.size() * modules.size());
+		poolSizes[0].descriptorCount = static_cast<uint32_t>(
+		    swapChainImages.size() * (modules.size() + parameterBufferCount));
 		poolSizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
 		poolSizes[1].descriptorCount =
-		    static_cast<uint32_t>(swapChainImages.size() * modules.size());
+		    static_cast<uint32_t>(swapChainImages.size() * (modules.size() + 1));
 		poolSizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
 		poolSizes[2].descriptorCount =
-		    static_cast<uint32_t>(swapChainImages.size() * modules.size());
+		    static_cast<uint32_t>(swapChainImages.size() * (modules.size() + texelBufferCount));
 
 		size_t resourceCount = 0;
-		for (auto& module : modules) resourceCount += module.images.size();
+		for (auto& module : modules)
+			resourceCount += module.images.size() + module.targets.size() + module.luts.size();
 
 		poolSizes[3].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 		poolSizes[3].descriptorCount =
-		    static_cast<uint32_t>(swapChainImages.size() * (resourceCount + modules.size()));
+		    static_cast<uint32_t>(swapChainImages.size() * (resourceCount + modules.size() + 1));
+
+		size_t storageBufferCount = 0;
+		size_t storageImageCount = 0;
+		for (auto& module : modules) {
+			storageBufferCount += module.storageBuffers.size();
+			storageImageCount += module.storageImages.size();
+		}
+
+		// pool sizes must not be empty
+		poolSizes[4].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSizes[4].descriptorCount =
+		    static_cast<uint32_t>(swapChainImages.size() * std::max<size_t>(storageBufferCount, 1));
+		poolSizes[5].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		poolSizes[5].descriptorCount =
+		    static_cast<uint32_t>(swapChainImages.size() * std::max<size_t>(storageImageCount, 1));
 
 		VkDescriptorPoolCreateInfo poolInfo = {};
 		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -1640,6 +3666,10 @@ private:
 	}
 
 	void createDescriptorSets() {
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+		descriptorSetLayouts.reserve(modules.size());
+		for (auto& module : modules) descriptorSetLayouts.push_back(module.descriptorSetLayout);
+
 		VkDescriptorSetAllocateInfo allocInfo = {};
 		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		allocInfo.descriptorPool = descriptorPool;
@@ -1677,7 +3707,12 @@ private:
 				backgroundImageInfo.imageView = backgroundImage.view;
 				backgroundImageInfo.sampler = backgroundImage.sampler;
 
-				std::array<VkWriteDescriptorSet, 4> descriptorWrites = {};
+				VkDescriptorImageInfo spectrumImageInfo = {};
+				spectrumImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				spectrumImageInfo.imageView = spectrumImages[i].view;
+				spectrumImageInfo.sampler = spectrumImages[i].sampler;
+
+				std::array<VkWriteDescriptorSet, 6> descriptorWrites = {};
 				descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 				descriptorWrites[0].dstBinding = 0;
 				descriptorWrites[0].dstArrayElement = 0;
@@ -1706,10 +3741,26 @@ private:
 				descriptorWrites[3].descriptorCount = 1;
 				descriptorWrites[3].pImageInfo = &backgroundImageInfo;
 
+				descriptorWrites[4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				descriptorWrites[4].dstBinding = 4;
+				descriptorWrites[4].dstArrayElement = 0;
+				descriptorWrites[4].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+				descriptorWrites[4].descriptorCount = 1;
+				descriptorWrites[4].pTexelBufferView = &stereoAudioBuffers[i].view;
+
+				descriptorWrites[5].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				descriptorWrites[5].dstBinding = 5;
+				descriptorWrites[5].dstArrayElement = 0;
+				descriptorWrites[5].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				descriptorWrites[5].descriptorCount = 1;
+				descriptorWrites[5].pImageInfo = &spectrumImageInfo;
+
 				descriptorWrites[0].dstSet = commonDescriptorSets[i];
 				descriptorWrites[1].dstSet = commonDescriptorSets[i];
 				descriptorWrites[2].dstSet = commonDescriptorSets[i];
 				descriptorWrites[3].dstSet = commonDescriptorSets[i];
+				descriptorWrites[4].dstSet = commonDescriptorSets[i];
+				descriptorWrites[5].dstSet = commonDescriptorSets[i];
 
 				vkUpdateDescriptorSets(device.device,
 				                       static_cast<uint32_t>(descriptorWrites.size()),
@@ -1721,6 +3772,86 @@ private:
 
 				std::vector<VkDescriptorImageInfo> moduleImageInfos{resourceCount};
 				std::vector<VkWriteDescriptorSet> descriptorWrites{resourceCount};
+				VkDescriptorBufferInfo parameterBufferInfo = {};
+
+				std::vector<VkDescriptorBufferInfo> storageBufferInfos;
+				storageBufferInfos.reserve(modules[module].storageBuffers.size());
+				for (auto& buffer : modules[module].storageBuffers) {
+					storageBufferInfos.push_back({buffer.rsrc.buffer, 0, buffer.size});
+
+					VkWriteDescriptorSet storageWrite = {};
+					storageWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					storageWrite.dstBinding = buffer.id;
+					storageWrite.dstArrayElement = 0;
+					storageWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+					storageWrite.descriptorCount = 1;
+					storageWrite.pBufferInfo = &storageBufferInfos.back();
+					storageWrite.dstSet = descriptorSets[i][module];
+					descriptorWrites.push_back(storageWrite);
+				}
+
+				std::vector<VkDescriptorImageInfo> targetInfos;
+				targetInfos.reserve(modules[module].targets.size());
+				for (auto& target : modules[module].targets) {
+					targetInfos.push_back(
+					    {target.sampler, target.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+
+					VkWriteDescriptorSet targetWrite = {};
+					targetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					targetWrite.dstBinding = target.id;
+					targetWrite.dstArrayElement = 0;
+					targetWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+					targetWrite.descriptorCount = 1;
+					targetWrite.pImageInfo = &targetInfos.back();
+					targetWrite.dstSet = descriptorSets[i][module];
+					descriptorWrites.push_back(targetWrite);
+				}
+
+				std::vector<VkDescriptorImageInfo> lutInfos;
+				lutInfos.reserve(modules[module].luts.size());
+				for (auto& lut : modules[module].luts) {
+					lutInfos.push_back(
+					    {lut.rsrc.sampler, lut.rsrc.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+
+					VkWriteDescriptorSet lutWrite = {};
+					lutWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					lutWrite.dstBinding = lut.id;
+					lutWrite.dstArrayElement = 0;
+					lutWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+					lutWrite.descriptorCount = 1;
+					lutWrite.pImageInfo = &lutInfos.back();
+					lutWrite.dstSet = descriptorSets[i][module];
+					descriptorWrites.push_back(lutWrite);
+				}
+
+				for (auto& buffer : modules[module].buffers) {
+					VkWriteDescriptorSet bufferWrite = {};
+					bufferWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					bufferWrite.dstBinding = buffer.id;
+					bufferWrite.dstArrayElement = 0;
+					bufferWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+					bufferWrite.descriptorCount = 1;
+					bufferWrite.pTexelBufferView = &buffer.rsrc.view;
+					bufferWrite.dstSet = descriptorSets[i][module];
+					descriptorWrites.push_back(bufferWrite);
+				}
+
+				std::vector<VkDescriptorImageInfo> storageImageInfos;
+				storageImageInfos.reserve(modules[module].storageImages.size());
+				for (auto& image : modules[module].storageImages) {
+					storageImageInfos.push_back(
+					    {VK_NULL_HANDLE, image.rsrc.view, VK_IMAGE_LAYOUT_GENERAL});
+
+					VkWriteDescriptorSet storageWrite = {};
+					storageWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					storageWrite.dstBinding = image.id;
+					storageWrite.dstArrayElement = 0;
+					storageWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+					storageWrite.descriptorCount = 1;
+					storageWrite.pImageInfo = &storageImageInfos.back();
+					storageWrite.dstSet = descriptorSets[i][module];
+					descriptorWrites.push_back(storageWrite);
+				}
 
 				for (size_t image = 0; image < modules[module].images.size(); ++image) {
 					moduleImageInfos[image].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -1737,6 +3868,22 @@ private:
 					descriptorWrites[image].dstSet = descriptorSets[i][module];
 				}
 
+				if (!modules[module].dynamicParameters.empty()) {
+					parameterBufferInfo.buffer = modules[module].parameterBuffers[i].buffer;
+					parameterBufferInfo.offset = 0;
+					parameterBufferInfo.range = modules[module].parameterBuffers[i].size;
+
+					VkWriteDescriptorSet parameterWrite = {};
+					parameterWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					parameterWrite.dstBinding = modules[module].parameterBinding;
+					parameterWrite.dstArrayElement = 0;
+					parameterWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+					parameterWrite.descriptorCount = 1;
+					parameterWrite.pBufferInfo = &parameterBufferInfo;
+					parameterWrite.dstSet = descriptorSets[i][module];
+					descriptorWrites.push_back(parameterWrite);
+				}
+
 				vkUpdateDescriptorSets(device.device,
 				                       static_cast<uint32_t>(descriptorWrites.size()),
 				                       descriptorWrites.data(), 0, nullptr);
@@ -1753,22 +3900,6 @@ private:
 		return VK_FALSE;
 	}
 
-	static std::vector<char> readFile(const std::filesystem::path& filePath) {
-		std::ifstream file(filePath, std::ios::binary | std::ios::ate);
-
-		if (!file.is_open()) throw std::runtime_error(LOCATION "failed to open file!");
-
-		size_t fileSize = static_cast<size_t>(file.tellg());
-		std::vector<char> buffer(fileSize);
-
-		file.seekg(0);
-		file.read(buffer.data(), fileSize);
-
-		file.close();
-
-		return buffer;
-	}
-
 	static void readConfig(const std::filesystem::path& configFilePath, Module& module) {
 		std::ifstream file(configFilePath);
 		if (!file.is_open()) {
@@ -1790,11 +3921,18 @@ private:
 
 		if (config.moduleName) module.moduleName = config.moduleName.value();
 		if (config.vertexCount) module.vertexCount = config.vertexCount.value();
-
-		module.specializationConstants.data.reserve(5 + config.params.size());
-		module.specializationConstants.data.resize(5);
-		module.specializationConstants.specializationInfo.reserve(5 + config.params.size());
-		for (uint32_t offset = 0; offset < 5; ++offset) {
+		module.instanceCount = config.instanceCount;
+		module.fusable = config.fusable;
+		module.separateSpectrum = !config.packedSpectrum && !config.spectrumImage;
+		module.packedSpectrum = config.packedSpectrum;
+		module.spectrumImage = config.spectrumImage;
+		module.bounds = config.bounds;
+
+		module.specializationConstants.data.reserve(builtinConstantCount + config.params.size());
+		module.specializationConstants.data.resize(builtinConstantCount);
+		module.specializationConstants.specializationInfo.reserve(builtinConstantCount +
+		                                                          config.params.size());
+		for (uint32_t offset = 0; offset < builtinConstantCount; ++offset) {
 			VkSpecializationMapEntry mapEntry = {};
 			mapEntry.constantID = offset;
 			mapEntry.offset = offset * sizeof(SpecializationConstant);
@@ -1804,6 +3942,14 @@ private:
 		}
 
 		for (auto& param : config.params) {
+			if (param.dynamic) {
+				module.dynamicParameters.push_back({param.id, param.name, param.value, {}});
+				if (!param.expression.empty())
+					module.dynamicParameters.back().expression =
+					    Expression(param.expression, ModuleConfig::frameVariables);
+				continue;
+			}
+
 			VkSpecializationMapEntry mapEntry = {};
 			mapEntry.constantID = param.id;
 			mapEntry.offset =
@@ -1812,6 +3958,7 @@ private:
 
 			module.specializationConstants.data.push_back(param.value);
 			module.specializationConstants.specializationInfo.push_back(mapEntry);
+			module.parameterNames.push_back(param.name);
 		}
 
 		module.images.reserve(config.images.size());
@@ -1821,11 +3968,131 @@ private:
 			resource.path = image.path;
 			module.images.push_back(resource);
 		}
+
+		for (auto& buffer : config.storageBuffers)
+			module.storageBuffers.push_back({buffer.id, buffer.size});
+		for (auto& image : config.storageImages)
+			module.storageImages.push_back({image.id, image.size});
+		if (config.workGroups) module.workGroups = config.workGroups.value();
+
+		for (auto& target : config.targets) {
+			RenderTarget renderTarget = {};
+			renderTarget.id = target.id;
+			renderTarget.name = target.name;
+			renderTarget.size = target.size;
+			module.targets.push_back(renderTarget);
+		}
+
+		for (auto& buffer : config.buffers)
+			module.buffers.push_back({buffer.id, buffer.path, buffer.values});
+		for (auto& lut : config.luts) module.luts.push_back({lut.id, lut.path, lut.values});
+
+		for (auto& mesh : config.meshes) {
+			MeshBuffers buffers = {};
+			buffers.id = mesh.id;
+			buffers.name = mesh.name;
+			buffers.path = mesh.path;
+			module.meshes.push_back(buffers);
+		}
+
+		auto findTarget = [&](const std::string& name) {
+			for (uint32_t target = 0; target < module.targets.size(); ++target)
+				if (module.targets[target].name == name) return target;
+			throw std::runtime_error(LOCATION "unknown target '" + name + "' in module config '" +
+			                         configFilePath.string() + "'!");
+		};
+
+		for (auto& layerConfig : config.layers) {
+			auto layer = std::find_if(
+			    module.layers.begin(), module.layers.end(),
+			    [&](const auto& layer) { return layer.directory == layerConfig.layer; });
+			if (layer == module.layers.end())
+				throw std::runtime_error(LOCATION "layer " + std::to_string(layerConfig.layer) +
+				                         " of module config '" + configFilePath.string() +
+				                         "' is not a graphics layer!");
+
+			if (!layerConfig.output.empty()) layer->target = findTarget(layerConfig.output);
+			for (auto& input : layerConfig.inputs) {
+				auto mesh = std::find_if(module.meshes.begin(), module.meshes.end(),
+				                         [&](const auto& mesh) { return mesh.name == input; });
+				if (mesh == module.meshes.end()) {
+					layer->inputs.push_back(findTarget(input));
+					continue;
+				}
+
+				if (layer->mesh)
+					throw std::runtime_error(LOCATION "layer " +
+					                         std::to_string(layerConfig.layer) +
+					                         " of module config '" + configFilePath.string() +
+					                         "' draws more than one mesh!");
+				layer->mesh = std::distance(module.meshes.begin(), mesh);
+			}
+		}
+
+		std::sort(module.dynamicParameters.begin(), module.dynamicParameters.end(),
+		          [](const auto& a, const auto& b) { return a.id < b.id; });
+
+		auto bindingUsed = [&](uint32_t binding) {
+			auto hasBinding = [binding](const auto& resource) { return resource.id == binding; };
+			return std::any_of(module.images.begin(), module.images.end(), hasBinding) ||
+			       std::any_of(module.targets.begin(), module.targets.end(), hasBinding) ||
+			       std::any_of(module.buffers.begin(), module.buffers.end(), hasBinding) ||
+			       std::any_of(module.luts.begin(), module.luts.end(), hasBinding) ||
+			       std::any_of(module.storageBuffers.begin(), module.storageBuffers.end(),
+			                   hasBinding) ||
+			       std::any_of(module.storageImages.begin(), module.storageImages.end(),
+			                   hasBinding);
+		};
+
+		if (config.parameterBinding) {
+			module.parameterBinding = config.parameterBinding.value();
+			if (!module.dynamicParameters.empty() && bindingUsed(module.parameterBinding))
+				throw std::runtime_error(LOCATION "parameter binding " +
+				                         std::to_string(module.parameterBinding) +
+				                         " of module config '" + configFilePath.string() +
+				                         "' is already used by a resource!");
+		} else {
+			// default to the first binding not used by a resource
+			module.parameterBinding = 0;
+			while (bindingUsed(module.parameterBinding)) ++module.parameterBinding;
+		}
 	}
 };
 
 Renderer::Renderer(const Settings& settings) { rendererImpl = new RendererImpl(settings); }
 
+bool Renderer::deviceAvailable() {
+	VkApplicationInfo appInfo = {};
+	appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	appInfo.pApplicationName = "Vkav";
+	appInfo.apiVersion = VK_API_VERSION_1_0;
+
+	VkInstanceCreateInfo instanceInfo = {};
+	instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	instanceInfo.pApplicationInfo = &appInfo;
+
+	VkInstance instance;
+	if (vkCreateInstance(&instanceInfo, nullptr, &instance) != VK_SUCCESS) return false;
+
+	uint32_t deviceCount = 0;
+	vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+	std::vector<VkPhysicalDevice> devices(deviceCount);
+	vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+	bool available = false;
+	for (const auto& device : devices) {
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
+		for (const auto& queueFamily : queueFamilies)
+			available |= (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+	}
+
+	vkDestroyInstance(instance, nullptr);
+	return available;
+}
+
 Renderer& Renderer::operator=(Renderer&& other) noexcept {
 	std::swap(rendererImpl, other.rendererImpl);
 	return *this;
@@ -1833,4 +4100,27 @@ Renderer& Renderer::operator=(Renderer&& other) noexcept {
 
 bool Renderer::drawFrame(const AudioData& audioData) { return rendererImpl->drawFrame(audioData); }
 
+std::optional<double> Renderer::frameTime() { return rendererImpl->frameTime(); }
+
+void Renderer::setQuality(float quality) { rendererImpl->setQuality(quality); }
+
+std::optional<double> Renderer::presentLatency() const { return rendererImpl->presentLatency(); }
+
+std::string Renderer::deviceName() const { return rendererImpl->deviceName(); }
+
+double Renderer::uploadTime() { return rendererImpl->uploadTime(); }
+
+void Renderer::setModules(const std::vector<std::filesystem::path>& modules) {
+	rendererImpl->setModules(modules);
+}
+
+void Renderer::setSmoothingLevel(float smoothingLevel) {
+	rendererImpl->setSmoothingLevel(smoothingLevel);
+}
+
+bool Renderer::setParameter(const std::string& module, const std::string& parameter,
+                            float value) {
+	return rendererImpl->setParameter(module, parameter, value);
+}
+
 Renderer::~Renderer() { delete rendererImpl; }
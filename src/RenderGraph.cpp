@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "RenderGraph.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	struct Lifetime {
+		uint32_t first = std::numeric_limits<uint32_t>::max();
+		uint32_t last = 0;
+
+		bool used() const { return first != std::numeric_limits<uint32_t>::max(); }
+	};
+}  // namespace
+
+RenderGraph compileRenderGraph(const std::vector<RenderGraphLayer>& layers, uint32_t targetCount) {
+	RenderGraph graph;
+
+	std::vector<bool> written(targetCount, false);
+	for (uint32_t layer = 0; layer < layers.size(); ++layer) {
+		for (auto input : layers[layer].inputs) {
+			if (input >= targetCount || !written[input])
+				throw std::invalid_argument(LOCATION "layer " + std::to_string(layer + 1) +
+				                            " samples a target no earlier layer draws to!");
+			if (layers[layer].output == input)
+				throw std::invalid_argument(LOCATION "layer " + std::to_string(layer + 1) +
+				                            " samples the target it draws to!");
+		}
+
+		if (auto output = layers[layer].output) {
+			if (*output >= targetCount)
+				throw std::invalid_argument(LOCATION "layer " + std::to_string(layer + 1) +
+				                            " draws to an unknown target!");
+
+			graph.passes.push_back({layer, *output, !written[*output]});
+			written[*output] = true;
+		} else {
+			graph.windowLayers.push_back(layer);
+		}
+	}
+
+	// offscreen passes are numbered in order, the window pass comes after all of them
+	std::vector<Lifetime> lifetimes(targetCount);
+	auto use = [&](uint32_t target, uint32_t step) {
+		lifetimes[target].first = std::min(lifetimes[target].first, step);
+		lifetimes[target].last = std::max(lifetimes[target].last, step);
+	};
+
+	for (uint32_t pass = 0; pass < graph.passes.size(); ++pass) {
+		use(graph.passes[pass].target, pass);
+		for (auto input : layers[graph.passes[pass].layer].inputs) use(input, pass);
+	}
+	const uint32_t windowStep = graph.passes.size();
+	for (auto layer : graph.windowLayers)
+		for (auto input : layers[layer].inputs) use(input, windowStep);
+
+	std::vector<uint32_t> order(targetCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		return lifetimes[a].first < lifetimes[b].first;
+	});
+
+	// greedy interval colouring, blockEnds holds the last step each block is in use
+	std::vector<uint32_t> blockEnds;
+	graph.memoryBlocks.resize(targetCount);
+	for (auto target : order) {
+		const auto& lifetime = lifetimes[target];
+
+		uint32_t block = 0;
+		if (lifetime.used()) {
+			while (block < blockEnds.size() && blockEnds[block] >= lifetime.first) ++block;
+			if (block == blockEnds.size()) blockEnds.push_back(0);
+			blockEnds[block] = lifetime.last;
+		} else if (blockEnds.empty()) {
+			// unused targets are never accessed and may share any block
+			blockEnds.push_back(0);
+		}
+
+		graph.memoryBlocks[target] = block;
+	}
+	graph.memoryBlockCount = blockEnds.size();
+
+	return graph;
+}
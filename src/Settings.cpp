@@ -186,6 +186,32 @@ std::vector<std::filesystem::path> getConfigLocations() {
 	return configLocations;
 }
 
+std::filesystem::path getCacheLocation() {
+	std::filesystem::path cacheLocation;
+#ifdef LINUX
+	if (const char* xdgCacheHome = std::getenv("XDG_CACHE_HOME"); xdgCacheHome && *xdgCacheHome) {
+		cacheLocation = xdgCacheHome;
+	} else {
+		cacheLocation = std::getenv("HOME");
+		if (cacheLocation.empty()) cacheLocation = getpwuid(geteuid())->pw_dir;
+		cacheLocation /= ".cache";
+	}
+	cacheLocation /= "vkav";
+#elif defined(MACOS)
+	cacheLocation = std::getenv("HOME");
+	if (cacheLocation.empty()) cacheLocation = getpwuid(geteuid())->pw_dir;
+	cacheLocation /= "Library/Caches/vkav";
+#elif defined(WINDOWS)
+	PWSTR path;
+	SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_DEFAULT, NULL, &path);
+	cacheLocation = std::filesystem::path(std::wstring(path));
+	cacheLocation /= "vkav";
+	CoTaskMemFree(path);
+#else
+#endif
+	return cacheLocation;
+}
+
 std::unordered_map<std::string, std::vector<std::filesystem::path>> getModules() {
 	auto configLocations = getConfigLocations();
 	std::unordered_map<std::string, std::vector<std::filesystem::path>> modules;
@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef SHADERC_SUPPORTED
+	#include <shaderc/shaderc.hpp>
+#endif
+
+#include "ShaderCompiler.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	// bump whenever the compile options change in order to invalidate old cache entries
+	constexpr std::string_view cacheVersion = "vkav-spirv-1";
+
+	constexpr uint32_t spirvMagic = 0x07230203;
+	constexpr size_t spirvHeaderWords = 5;
+	constexpr uint32_t opDecorate = 71;
+	constexpr uint32_t decorationBinding = 33;
+	constexpr uint32_t decorationDescriptorSet = 34;
+
+	/**
+	 * Whether spirv starts with a SPIR-V header and consists of whole words
+	 */
+	bool isSpirv(const std::vector<char>& spirv) {
+		uint32_t magic;
+		if (spirv.size() % sizeof(uint32_t) != 0 ||
+		    spirv.size() < spirvHeaderWords * sizeof(uint32_t))
+			return false;
+		std::memcpy(&magic, spirv.data(), sizeof(magic));
+		return magic == spirvMagic;
+	}
+
+	std::string readTextFile(const std::filesystem::path& filePath) {
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file.is_open())
+			throw std::runtime_error(LOCATION "failed to open file '" + filePath.string() + "'!");
+
+		std::stringstream contents;
+		contents << file.rdbuf();
+		return contents.str();
+	}
+
+	std::vector<char> readBinaryFile(const std::filesystem::path& filePath) {
+		std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			throw std::runtime_error(LOCATION "failed to open file '" + filePath.string() + "'!");
+
+		std::vector<char> buffer(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(buffer.data(), buffer.size());
+		return buffer;
+	}
+
+	/**
+	 * 64 bit FNV-1a
+	 */
+	uint64_t hash(std::string_view data, uint64_t seed = 0xcbf29ce484222325) {
+		for (unsigned char c : data) {
+			seed ^= c;
+			seed *= 0x100000001b3;
+		}
+		return seed;
+	}
+
+	/**
+	 * Returns the paths of all the files directly included by source
+	 */
+	std::vector<std::filesystem::path> findIncludes(std::string_view source) {
+		std::vector<std::filesystem::path> includes;
+
+		std::stringstream stream{std::string(source)};
+		std::string line;
+		while (std::getline(stream, line)) {
+			std::string_view str = line;
+			while (!str.empty() && std::isspace(str.front())) str.remove_prefix(1);
+			if (str.substr(0, 1) != "#") continue;
+			str.remove_prefix(1);
+			while (!str.empty() && std::isspace(str.front())) str.remove_prefix(1);
+			if (str.substr(0, 7) != "include") continue;
+			str.remove_prefix(7);
+			while (!str.empty() && std::isspace(str.front())) str.remove_prefix(1);
+			if (str.empty()) continue;
+
+			const char close = str.front() == '<' ? '>' : '"';
+			if (str.front() != '"' && str.front() != '<') continue;
+			str.remove_prefix(1);
+
+			if (auto end = str.find(close); end != std::string_view::npos)
+				includes.emplace_back(std::string(str.substr(0, end)));
+		}
+
+		return includes;
+	}
+
+	uint64_t hashSourceTree(const std::filesystem::path& sourcePath, uint64_t seed,
+	                        std::set<std::filesystem::path>& visited);
+
+	uint64_t hashSource(std::string_view source, const std::filesystem::path& sourcePath,
+	                    uint64_t seed, std::set<std::filesystem::path>& visited) {
+		seed = hash(sourcePath.filename().string(), seed);
+		seed = hash(source, seed);
+
+		for (const auto& include : findIncludes(source))
+			seed = hashSourceTree(sourcePath.parent_path() / include, seed, visited);
+
+		return seed;
+	}
+
+	uint64_t hashSourceTree(const std::filesystem::path& sourcePath, uint64_t seed,
+	                        std::set<std::filesystem::path>& visited) {
+		auto path = std::filesystem::weakly_canonical(sourcePath);
+		if (!visited.insert(path).second) return seed;
+
+		return hashSource(readTextFile(path), path, seed, visited);
+	}
+
+	const char* sourceName(ShaderCompiler::Stage stage) {
+		switch (stage) {
+			case ShaderCompiler::Stage::vertex:
+				return "shader.vert";
+			case ShaderCompiler::Stage::fragment:
+				return "shader.frag";
+			case ShaderCompiler::Stage::compute:
+				return "shader.comp";
+		}
+		return "";
+	}
+
+	const char* binaryName(ShaderCompiler::Stage stage) {
+		switch (stage) {
+			case ShaderCompiler::Stage::vertex:
+				return "vert.spv";
+			case ShaderCompiler::Stage::fragment:
+				return "frag.spv";
+			case ShaderCompiler::Stage::compute:
+				return "comp.spv";
+		}
+		return "";
+	}
+
+#ifdef SHADERC_SUPPORTED
+	class Includer : public shaderc::CompileOptions::IncluderInterface {
+	public:
+		shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type,
+		                                   const char* requestingSource, size_t) override {
+			auto data = new IncludeData;
+			data->path = std::filesystem::path(requestingSource).parent_path() / requestedSource;
+			try {
+				data->content = readTextFile(data->path);
+				data->name = data->path.string();
+			} catch (const std::exception& e) {
+				// an empty source name signals failure, content holds the error message
+				data->content = e.what();
+			}
+
+			auto result = new shaderc_include_result;
+			result->source_name = data->name.c_str();
+			result->source_name_length = data->name.size();
+			result->content = data->content.c_str();
+			result->content_length = data->content.size();
+			result->user_data = data;
+			return result;
+		}
+
+		void ReleaseInclude(shaderc_include_result* result) override {
+			delete reinterpret_cast<IncludeData*>(result->user_data);
+			delete result;
+		}
+
+	private:
+		struct IncludeData {
+			std::filesystem::path path;
+			std::string name;
+			std::string content;
+		};
+	};
+#endif
+}  // namespace
+
+uint64_t hashShaderSource(const std::filesystem::path& sourcePath) {
+	std::set<std::filesystem::path> visited;
+	return hashSourceTree(sourcePath, hash(cacheVersion), visited);
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> descriptorBindings(const std::vector<char>& spirv) {
+	if (!isSpirv(spirv)) throw std::invalid_argument("not a SPIR-V module");
+	std::vector<uint32_t> words(spirv.size() / sizeof(uint32_t));
+	std::memcpy(words.data(), spirv.data(), spirv.size());
+
+	// decorations of every id, the set defaults to 0 if only the binding is given
+	std::map<uint32_t, std::pair<uint32_t, uint32_t>> bindings;
+	std::set<uint32_t> bound;
+	for (size_t i = spirvHeaderWords; i < words.size();) {
+		// the high half word is the length of the instruction, the low one the opcode
+		const uint32_t length = words[i] >> 16;
+		if (length == 0 || i + length > words.size())
+			throw std::invalid_argument("truncated SPIR-V instruction");
+
+		if ((words[i] & 0xffff) == opDecorate && length >= 4) {
+			const uint32_t target = words[i + 1];
+			if (words[i + 2] == decorationDescriptorSet) bindings[target].first = words[i + 3];
+			if (words[i + 2] == decorationBinding) {
+				bindings[target].second = words[i + 3];
+				bound.insert(target);
+			}
+		}
+		i += length;
+	}
+
+	std::vector<std::pair<uint32_t, uint32_t>> result;
+	for (auto target : bound) result.push_back(bindings[target]);
+	return result;
+}
+
+class ShaderCompiler::ShaderCompilerImpl {
+public:
+	ShaderCompilerImpl(const Settings& compilerSettings) { settings = compilerSettings; }
+
+	std::vector<char> load(const std::filesystem::path& directory, Stage stage) {
+		const auto sourcePath = directory / sourceName(stage);
+		const auto binaryPath = directory / binaryName(stage);
+
+		if (!std::filesystem::exists(sourcePath)) return readBinaryFile(binaryPath);
+
+		if (!supported()) {
+			if (!std::filesystem::exists(binaryPath))
+				throw std::runtime_error(LOCATION "no SPIR-V binary found for '" +
+				                         sourcePath.string() +
+				                         "' and runtime shader compilation is unavailable!");
+			if (std::filesystem::last_write_time(binaryPath) <
+			    std::filesystem::last_write_time(sourcePath))
+				std::cerr << LOCATION "warning: " << binaryPath << " is older than its source!"
+				          << std::endl;
+			return readBinaryFile(binaryPath);
+		}
+
+		return compile(readTextFile(sourcePath), sourcePath, stage);
+	}
+
+	std::vector<char> compile(const std::string& source, const std::filesystem::path& sourcePath,
+	                          Stage stage) {
+		std::set<std::filesystem::path> visited;
+		const uint64_t key = hash(sourceName(stage), hashSource(source, sourcePath,
+		                                                        hash(cacheVersion), visited));
+		std::stringstream cacheName;
+		cacheName << std::hex << std::setw(16) << std::setfill('0') << key << ".spv";
+		const auto cachePath = settings.cacheLocation / cacheName.str();
+
+		if (!settings.cacheLocation.empty() && std::filesystem::exists(cachePath)) {
+			auto spirv = readBinaryFile(cachePath);
+			if (isSpirv(spirv)) return spirv;
+			// e.g. written by an older version that could commit truncated entries
+			std::cerr << LOCATION "warning: discarding invalid shader cache entry " << cachePath
+			          << std::endl;
+		}
+
+		std::clog << "Compiling " << sourcePath << std::endl;
+		auto spirv = compileGlsl(source, sourcePath, stage);
+
+		if (!settings.cacheLocation.empty()) store(cachePath, spirv);
+
+		return spirv;
+	}
+
+private:
+	Settings settings;
+
+#ifdef SHADERC_SUPPORTED
+	shaderc::Compiler compiler;
+#endif
+
+	std::vector<char> compileGlsl([[maybe_unused]] const std::string& source,
+	                              [[maybe_unused]] const std::filesystem::path& sourcePath,
+	                              [[maybe_unused]] Stage stage) {
+#ifdef SHADERC_SUPPORTED
+		shaderc::CompileOptions options;
+		options.SetOptimizationLevel(shaderc_optimization_level_performance);
+		options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_0);
+		options.SetIncluder(std::make_unique<Includer>());
+
+		shaderc_shader_kind kind = shaderc_glsl_fragment_shader;
+		if (stage == Stage::vertex) kind = shaderc_glsl_vertex_shader;
+		if (stage == Stage::compute) kind = shaderc_glsl_compute_shader;
+
+		auto result = compiler.CompileGlslToSpv(source, kind, sourcePath.string().c_str(), options);
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+			throw std::runtime_error(LOCATION "failed to compile shader '" + sourcePath.string() +
+			                         "':\n" + result.GetErrorMessage());
+
+		std::vector<char> spirv(sizeof(uint32_t) * (result.cend() - result.cbegin()));
+		std::copy(result.cbegin(), result.cend(), reinterpret_cast<uint32_t*>(spirv.data()));
+		return spirv;
+#else
+		throw std::runtime_error(LOCATION "runtime shader compilation unsupported!");
+#endif
+	}
+
+	static void store(const std::filesystem::path& cachePath, const std::vector<char>& spirv) {
+		// unique per process and call
+		static const uint64_t processSuffix =
+		    static_cast<uint64_t>(std::random_device{}()) << 32 | std::random_device{}();
+		static std::atomic<uint64_t> counter = 0;
+
+		// write to a temporary file of our own first, so that concurrent instances never see
+		// partial entries and renaming a complete one replaces any existing entry atomically
+		std::error_code err;
+		std::filesystem::create_directories(cachePath.parent_path(), err);
+		std::stringstream suffix;
+		suffix << '.' << std::hex << processSuffix << '.' << counter++ << ".tmp";
+		auto tmpPath = cachePath;
+		tmpPath += suffix.str();
+
+		std::ofstream file(tmpPath, std::ios::binary);
+		file.write(spirv.data(), spirv.size());
+		file.close();
+		if (!file) {
+			std::cerr << LOCATION "failed to write shader cache entry " << cachePath << std::endl;
+			std::filesystem::remove(tmpPath, err);
+			return;
+		}
+
+		std::filesystem::rename(tmpPath, cachePath, err);
+		if (err) std::filesystem::remove(tmpPath, err);
+	}
+};
+
+ShaderCompiler::ShaderCompiler(const Settings& compilerSettings) {
+	impl = new ShaderCompilerImpl(compilerSettings);
+}
+
+ShaderCompiler::~ShaderCompiler() { delete impl; }
+
+ShaderCompiler& ShaderCompiler::operator=(ShaderCompiler&& other) noexcept {
+	std::swap(impl, other.impl);
+	return *this;
+}
+
+std::vector<char> ShaderCompiler::load(const std::filesystem::path& directory, Stage stage) {
+	return impl->load(directory, stage);
+}
+
+std::vector<char> ShaderCompiler::compile(const std::string& source,
+                                          const std::filesystem::path& sourcePath, Stage stage) {
+	return impl->compile(source, sourcePath, stage);
+}
+
+bool ShaderCompiler::hasShader(const std::filesystem::path& directory, Stage stage) {
+	return std::filesystem::exists(directory / sourceName(stage)) ||
+	       std::filesystem::exists(directory / binaryName(stage));
+}
+
+bool ShaderCompiler::supported() {
+#ifdef SHADERC_SUPPORTED
+	return true;
+#else
+	return false;
+#endif
+}
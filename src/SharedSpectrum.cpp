@@ -0,0 +1,258 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(LINUX) || defined(MACOS)
+	#define SHARED_SPECTRUM_SUPPORTED
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "Data.hpp"
+#include "SharedSpectrum.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	constexpr char sharedSpectrumMagic[8] = {'V', 'K', 'A', 'V', 'S', 'P', 'E', 'C'};
+	constexpr uint32_t sharedSpectrumVersion = 2;
+	// keeps slots on separate cache lines
+	constexpr size_t slotAlignment = 64;
+	// a reader gives up if the writer laps it this many times during a copy
+	constexpr int maxReadAttempts = 16;
+
+	size_t alignUp(size_t size) {
+		return (size + slotAlignment - 1) / slotAlignment * slotAlignment;
+	}
+
+	size_t headerSize() { return alignUp(sizeof(SharedSpectrumHeader)); }
+
+	// shm_open wants a single leading slash
+	std::string objectName(const std::string& name) {
+		return name.empty() || name.front() != '/' ? '/' + name : name;
+	}
+
+	size_t slotOffset(const SharedSpectrumHeader& header, uint64_t sequence) {
+		return headerSize() + (sequence % header.slotCount) * header.slotSize;
+	}
+
+#ifdef SHARED_SPECTRUM_SUPPORTED
+	/**
+	 * Whether the object name may be replaced by a new writer, because it does not exist or is a
+	 * shared spectrum whose writer has closed it or is no longer running
+	 */
+	bool stale(const std::string& name) {
+		const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd < 0) return errno == ENOENT;
+
+		void* mapping = MAP_FAILED;
+		struct stat status;
+		if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= headerSize())
+			mapping = mmap(nullptr, headerSize(), PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		// anything else using the name is left alone
+		if (mapping == MAP_FAILED) return false;
+
+		const auto header = static_cast<const SharedSpectrumHeader*>(mapping);
+		bool replaceable = false;
+		if (std::memcmp(header->magic, sharedSpectrumMagic, sizeof(sharedSpectrumMagic)) == 0) {
+			std::atomic_thread_fence(std::memory_order_acquire);
+			// signal 0 only checks whether the process exists, EPERM means it does
+			replaceable = header->closed.load(std::memory_order_acquire) ||
+			              (header->version == sharedSpectrumVersion &&
+			               kill(static_cast<pid_t>(header->owner), 0) < 0 && errno == ESRCH);
+		}
+		munmap(mapping, headerSize());
+		return replaceable;
+	}
+#endif
+}  // namespace
+
+SharedSpectrumWriter::SharedSpectrumWriter(const std::string& name, size_t audioSize)
+    : name(objectName(name)) {
+#ifdef SHARED_SPECTRUM_SUPPORTED
+	const size_t slotSize = alignUp(sizeof(SharedSpectrumSlot) + 2 * audioSize * sizeof(float));
+	mappingSize = headerSize() + slotCount * slotSize;
+
+	if (!stale(this->name))
+		throw std::runtime_error(LOCATION "shared memory '" + this->name + "' already in use!");
+	// readers still attached to a stale object keep their mapping of it
+	shm_unlink(this->name.c_str());
+	const int fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0)
+		throw std::runtime_error(LOCATION "failed to create shared memory '" + this->name +
+		                         "': " + std::strerror(errno));
+
+	void* mapping = MAP_FAILED;
+	if (ftruncate(fd, mappingSize) == 0)
+		mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		shm_unlink(this->name.c_str());
+		throw std::runtime_error(LOCATION "failed to map shared memory '" + this->name + "'!");
+	}
+
+	// the object is zero filled, so every slot starts out without an update
+	header = new (mapping) SharedSpectrumHeader;
+	header->version = sharedSpectrumVersion;
+	header->audioSize = static_cast<uint32_t>(audioSize);
+	header->slotCount = slotCount;
+	header->slotSize = static_cast<uint32_t>(slotSize);
+	header->latest.store(0, std::memory_order_relaxed);
+	header->closed.store(0, std::memory_order_relaxed);
+	header->owner = getpid();
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(header->magic, sharedSpectrumMagic, sizeof(sharedSpectrumMagic));
+#else
+	(void)audioSize;
+	throw std::runtime_error(LOCATION "shared memory is not supported on this platform!");
+#endif
+}
+
+SharedSpectrumWriter::~SharedSpectrumWriter() {
+#ifdef SHARED_SPECTRUM_SUPPORTED
+	if (!header) return;
+	header->closed.store(1, std::memory_order_release);
+	munmap(header, mappingSize);
+	shm_unlink(name.c_str());
+#endif
+}
+
+SharedSpectrumWriter::SharedSpectrumWriter(SharedSpectrumWriter&& other) noexcept {
+	*this = std::move(other);
+}
+
+SharedSpectrumWriter& SharedSpectrumWriter::operator=(SharedSpectrumWriter&& other) noexcept {
+	std::swap(name, other.name);
+	std::swap(header, other.header);
+	std::swap(mappingSize, other.mappingSize);
+	std::swap(published, other.published);
+	return *this;
+}
+
+void SharedSpectrumWriter::publish(const AudioData& audioData,
+                                   std::chrono::steady_clock::time_point timestamp) {
+	const uint64_t sequence = ++published;
+	auto target = reinterpret_cast<SharedSpectrumSlot*>(reinterpret_cast<std::byte*>(header) +
+	                                                     slotOffset(*header, sequence));
+
+	target->sequence.store(2 * sequence - 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	target->timestamp =
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+	target->lVolume = audioData.lVolume;
+	target->rVolume = audioData.rVolume;
+	float* values = reinterpret_cast<float*>(target + 1);
+	std::memcpy(values, audioData.lBuffer, header->audioSize * sizeof(float));
+	std::memcpy(values + header->audioSize, audioData.rBuffer, header->audioSize * sizeof(float));
+
+	target->sequence.store(2 * sequence, std::memory_order_release);
+	header->latest.store(sequence, std::memory_order_release);
+}
+
+SharedSpectrumReader::SharedSpectrumReader(const std::string& name) {
+#ifdef SHARED_SPECTRUM_SUPPORTED
+	const std::string object = objectName(name);
+	const int fd = shm_open(object.c_str(), O_RDONLY, 0);
+	if (fd < 0)
+		throw std::runtime_error(LOCATION "failed to open shared memory '" + object +
+		                         "': " + std::strerror(errno));
+
+	void* mapping = MAP_FAILED;
+	struct stat status;
+	if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= headerSize()) {
+		mappingSize = status.st_size;
+		mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (mapping == MAP_FAILED)
+		throw std::runtime_error(LOCATION "'" + object + "' is not a shared spectrum!");
+	header = static_cast<const SharedSpectrumHeader*>(mapping);
+
+	const bool valid =
+	    std::memcmp(header->magic, sharedSpectrumMagic, sizeof(sharedSpectrumMagic)) == 0 &&
+	    header->version == sharedSpectrumVersion && header->slotCount > 0 &&
+	    header->slotSize >= sizeof(SharedSpectrumSlot) + 2 * header->audioSize * sizeof(float) &&
+	    mappingSize >= headerSize() + static_cast<size_t>(header->slotCount) * header->slotSize;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (!valid) {
+		munmap(const_cast<SharedSpectrumHeader*>(header), mappingSize);
+		header = nullptr;
+		throw std::runtime_error(LOCATION "'" + object + "' is not a shared spectrum!");
+	}
+#else
+	(void)name;
+	throw std::runtime_error(LOCATION "shared memory is not supported on this platform!");
+#endif
+}
+
+SharedSpectrumReader::~SharedSpectrumReader() {
+#ifdef SHARED_SPECTRUM_SUPPORTED
+	if (header) munmap(const_cast<SharedSpectrumHeader*>(header), mappingSize);
+#endif
+}
+
+SharedSpectrumReader::SharedSpectrumReader(SharedSpectrumReader&& other) noexcept {
+	*this = std::move(other);
+}
+
+SharedSpectrumReader& SharedSpectrumReader::operator=(SharedSpectrumReader&& other) noexcept {
+	std::swap(header, other.header);
+	std::swap(mappingSize, other.mappingSize);
+	std::swap(lastRead, other.lastRead);
+	std::swap(lastTimestamp, other.lastTimestamp);
+	return *this;
+}
+
+size_t SharedSpectrumReader::audioSize() const { return header->audioSize; }
+
+bool SharedSpectrumReader::closed() const {
+	return header->closed.load(std::memory_order_acquire);
+}
+
+bool SharedSpectrumReader::read(AudioData& audioData) {
+	for (int attempt = 0; attempt < maxReadAttempts; ++attempt) {
+		const uint64_t sequence = header->latest.load(std::memory_order_acquire);
+		if (sequence == 0 || sequence == lastRead) return false;
+
+		auto source = reinterpret_cast<const SharedSpectrumSlot*>(
+		    reinterpret_cast<const std::byte*>(header) + slotOffset(*header, sequence));
+		if (source->sequence.load(std::memory_order_acquire) != 2 * sequence) continue;
+
+		const int64_t timestamp = source->timestamp;
+		audioData.lVolume = source->lVolume;
+		audioData.rVolume = source->rVolume;
+		const float* values = reinterpret_cast<const float*>(source + 1);
+		std::memcpy(audioData.lBuffer, values, header->audioSize * sizeof(float));
+		std::memcpy(audioData.rBuffer, values + header->audioSize,
+		            header->audioSize * sizeof(float));
+
+		// the writer may have reused the slot while it was copied
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (source->sequence.load(std::memory_order_relaxed) != 2 * sequence) continue;
+
+		lastRead = sequence;
+		lastTimestamp = std::chrono::steady_clock::time_point(
+		    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		        std::chrono::nanoseconds(timestamp)));
+		return true;
+	}
+	return false;
+}
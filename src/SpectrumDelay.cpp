@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "Data.hpp"
+#include "SpectrumDelay.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+SpectrumDelay::SpectrumDelay(size_t audioSize, size_t capacity)
+    : audioSize(audioSize),
+      spectra(2 * audioSize * capacity),
+      volumes(2 * capacity),
+      timestamps(capacity) {
+	if (capacity == 0)
+		throw std::invalid_argument(LOCATION "a spectrum delay must hold at least one spectrum!");
+}
+
+void SpectrumDelay::push(const AudioData& audioData,
+                         std::chrono::steady_clock::time_point timestamp) {
+	size_t slot;
+	if (count == capacity()) {
+		// overwrite the oldest spectrum
+		slot = first;
+		first = (first + 1) % capacity();
+	} else {
+		slot = (first + count++) % capacity();
+	}
+
+	float* spectrum = spectra.data() + 2 * audioSize * slot;
+	std::copy_n(audioData.lBuffer, audioSize, spectrum);
+	std::copy_n(audioData.rBuffer, audioSize, spectrum + audioSize);
+	volumes[2 * slot] = audioData.lVolume;
+	volumes[2 * slot + 1] = audioData.rVolume;
+	timestamps[slot] = timestamp;
+}
+
+bool SpectrumDelay::pop(AudioData& audioData, std::chrono::steady_clock::time_point time) {
+	// timestamps only increase, so the due spectra are the oldest ones
+	size_t due = 0;
+	while (due < count && timestamps[(first + due) % capacity()] <= time) ++due;
+	if (due == 0) return false;
+
+	const size_t slot = (first + due - 1) % capacity();
+	const float* spectrum = spectra.data() + 2 * audioSize * slot;
+	std::copy_n(spectrum, audioSize, audioData.lBuffer);
+	std::copy_n(spectrum + audioSize, audioSize, audioData.rBuffer);
+	audioData.lVolume = volumes[2 * slot];
+	audioData.rVolume = volumes[2 * slot + 1];
+
+	first = (first + due) % capacity();
+	count -= due;
+	return true;
+}
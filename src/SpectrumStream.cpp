@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(LINUX) || defined(MACOS)
+	#define SPECTRUM_STREAM_SUPPORTED
+	#include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <netdb.h>
+	#include <netinet/in.h>
+	#include <sys/socket.h>
+	#include <sys/types.h>
+	#include <unistd.h>
+#endif
+
+#include "Data.hpp"
+#include "Half.hpp"
+#include "SpectrumStream.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+namespace {
+	constexpr char packetMagic[4] = {'V', 'K', 'S', 'S'};
+	constexpr uint8_t packetVersion = 1;
+	// older sequence numbers than this are taken as a restarted sender rather than reordering
+	constexpr int32_t maxReordering = 64;
+
+	const float logRange = std::log(SpectrumPacket::logCeiling / SpectrumPacket::logFloor);
+
+	uint8_t encodeLog8(float value) {
+		if (!(value > SpectrumPacket::logFloor)) return 0;
+		const float level = std::log(value / SpectrumPacket::logFloor) / logRange;
+		return static_cast<uint8_t>(1.f + std::min(std::round(254.f * level), 254.f));
+	}
+
+	const std::array<float, 256> log8Values = [] {
+		std::array<float, 256> values = {0.f};
+		for (int i = 1; i < 256; ++i)
+			values[i] = SpectrumPacket::logFloor * std::exp(logRange * (i - 1) / 254.f);
+		return values;
+	}();
+
+	template <class Int>
+	void write(std::vector<uint8_t>& datagram, Int value) {
+		for (size_t byte = 0; byte < sizeof(Int); ++byte)
+			datagram.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * byte)));
+	}
+
+	void write(std::vector<uint8_t>& datagram, float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		write(datagram, bits);
+	}
+
+	template <class Int>
+	Int read(const uint8_t*& data) {
+		uint64_t value = 0;
+		for (size_t byte = 0; byte < sizeof(Int); ++byte)
+			value |= static_cast<uint64_t>(data[byte]) << (8 * byte);
+		data += sizeof(Int);
+		return static_cast<Int>(value);
+	}
+
+	float readFloat(const uint8_t*& data) {
+		const uint32_t bits = read<uint32_t>(data);
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	/**
+	 * Averages values into bands.size() bands of (almost) equal width
+	 */
+	void reduce(const float* values, size_t count, std::vector<float>& bands) {
+		for (size_t band = 0; band < bands.size(); ++band) {
+			const size_t first = band * count / bands.size();
+			const size_t last = std::max((band + 1) * count / bands.size(), first + 1);
+			float sum = 0.f;
+			for (size_t i = first; i < last; ++i) sum += values[i];
+			bands[band] = sum / (last - first);
+		}
+	}
+
+	/**
+	 * Linearly interpolates between the centres of bands to fill count values
+	 */
+	void expand(const std::vector<float>& bands, float* values, size_t count) {
+		const float scale = static_cast<float>(bands.size()) / count;
+		for (size_t i = 0; i < count; ++i) {
+			const float position =
+			    std::clamp((i + 0.5f) * scale - 0.5f, 0.f, static_cast<float>(bands.size() - 1));
+			const size_t band = static_cast<size_t>(position);
+			const size_t next = std::min(band + 1, bands.size() - 1);
+			const float weight = position - band;
+			values[i] = bands[band] + weight * (bands[next] - bands[band]);
+		}
+	}
+
+#ifdef SPECTRUM_STREAM_SUPPORTED
+	/**
+	 * Resolves HOST:PORT, or PORT alone to the wildcard address if allowed
+	 */
+	sockaddr_in resolve(const std::string& endpoint, bool allowPortOnly) {
+		const size_t colon = endpoint.rfind(':');
+		if (colon == std::string::npos && !allowPortOnly)
+			throw std::invalid_argument(LOCATION "expected HOST:PORT instead of '" + endpoint +
+			                            "'!");
+		const std::string host = colon == std::string::npos ? "" : endpoint.substr(0, colon);
+		const std::string port = colon == std::string::npos ? endpoint : endpoint.substr(colon + 1);
+
+		addrinfo hints = {};
+		hints.ai_family = AF_INET;
+		hints.ai_socktype = SOCK_DGRAM;
+		hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+		addrinfo* result = nullptr;
+		if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0)
+			throw std::invalid_argument(LOCATION "failed to resolve '" + endpoint + "'!");
+
+		sockaddr_in address;
+		std::memcpy(&address, result->ai_addr, sizeof(address));
+		freeaddrinfo(result);
+		return address;
+	}
+
+	bool isMulticast(const sockaddr_in& address) {
+		return (ntohl(address.sin_addr.s_addr) & 0xf0000000) == 0xe0000000;
+	}
+#endif
+}  // namespace
+
+size_t SpectrumPacket::maxBands(SpectrumEncoding encoding) {
+	const size_t valueSize = encoding == SpectrumEncoding::fp16 ? sizeof(uint16_t) : 1;
+	return (maxDatagramSize - headerSize) / (2 * valueSize);
+}
+
+void encodeSpectrumPacket(const SpectrumPacket& packet, SpectrumEncoding encoding,
+                          std::vector<uint8_t>& datagram) {
+	datagram.clear();
+	for (char c : packetMagic) datagram.push_back(static_cast<uint8_t>(c));
+	write(datagram, packetVersion);
+	write(datagram, static_cast<uint8_t>(encoding));
+	write(datagram, static_cast<uint16_t>(packet.left.size()));
+	write(datagram, packet.sequence);
+	write(datagram, packet.timestamp);
+	write(datagram, packet.lVolume);
+	write(datagram, packet.rVolume);
+
+	for (const auto* values : {&packet.left, &packet.right}) {
+		for (float value : *values) {
+			switch (encoding) {
+				case SpectrumEncoding::fp16:
+					write(datagram, floatToHalf(value));
+					break;
+				case SpectrumEncoding::log8:
+					datagram.push_back(encodeLog8(value));
+					break;
+			}
+		}
+	}
+}
+
+void decodeSpectrumPacket(const uint8_t* datagram, size_t size, SpectrumPacket& packet) {
+	if (size < SpectrumPacket::headerSize ||
+	    std::memcmp(datagram, packetMagic, sizeof(packetMagic)) != 0)
+		throw std::invalid_argument(LOCATION "not a spectrum packet!");
+
+	const uint8_t* data = datagram + sizeof(packetMagic);
+	const auto version = read<uint8_t>(data);
+	if (version != packetVersion)
+		throw std::invalid_argument(LOCATION "unsupported spectrum packet version " +
+		                            std::to_string(version) + "!");
+
+	const auto encoding = static_cast<SpectrumEncoding>(read<uint8_t>(data));
+	if (encoding != SpectrumEncoding::fp16 && encoding != SpectrumEncoding::log8)
+		throw std::invalid_argument(LOCATION "unknown spectrum encoding!");
+	const size_t bands = read<uint16_t>(data);
+	const size_t valueSize = encoding == SpectrumEncoding::fp16 ? sizeof(uint16_t) : 1;
+	if (bands == 0 || size != SpectrumPacket::headerSize + 2 * bands * valueSize)
+		throw std::invalid_argument(LOCATION "spectrum packet has the wrong size!");
+
+	packet.sequence = read<uint32_t>(data);
+	packet.timestamp = read<int64_t>(data);
+	packet.lVolume = readFloat(data);
+	packet.rVolume = readFloat(data);
+
+	for (auto* values : {&packet.left, &packet.right}) {
+		values->resize(bands);
+		for (float& value : *values)
+			value = encoding == SpectrumEncoding::fp16 ? halfToFloat(read<uint16_t>(data))
+			                                           : log8Values[*data++];
+	}
+}
+
+class SpectrumSender::SpectrumSenderImpl {
+public:
+	SpectrumSenderImpl(const Settings& senderSettings) {
+		settings = senderSettings;
+		if (settings.bands == 0 ||
+		    settings.bands > SpectrumPacket::maxBands(settings.encoding))
+			throw std::invalid_argument(
+			    LOCATION "stream bands must be between 1 and " +
+			    std::to_string(SpectrumPacket::maxBands(settings.encoding)) + "!");
+		settings.bands = std::min(settings.bands, settings.audioSize);
+		packet.left.resize(settings.bands);
+		packet.right.resize(settings.bands);
+
+#ifdef SPECTRUM_STREAM_SUPPORTED
+		destination = resolve(settings.destination, false);
+
+		sendSocket = socket(AF_INET, SOCK_DGRAM, 0);
+		if (sendSocket < 0)
+			throw std::runtime_error(LOCATION "failed to create socket: " +
+			                         std::string(std::strerror(errno)));
+		// a full send buffer drops updates rather than stalling the frame loop
+		fcntl(sendSocket, F_SETFL, fcntl(sendSocket, F_GETFL) | O_NONBLOCK);
+
+		if (isMulticast(destination)) {
+			const unsigned char ttl = static_cast<unsigned char>(settings.multicastTtl);
+			setsockopt(sendSocket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+		}
+#else
+		throw std::runtime_error(LOCATION "spectrum streaming unsupported on this platform!");
+#endif
+	}
+
+	~SpectrumSenderImpl() {
+#ifdef SPECTRUM_STREAM_SUPPORTED
+		close(sendSocket);
+#endif
+	}
+
+	void send(const AudioData& audioData, std::chrono::steady_clock::time_point timestamp) {
+		++packet.sequence;
+		packet.timestamp =
+		    std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch())
+		        .count();
+		packet.lVolume = audioData.lVolume;
+		packet.rVolume = audioData.rVolume;
+		reduce(audioData.lBuffer, settings.audioSize, packet.left);
+		reduce(audioData.rBuffer, settings.audioSize, packet.right);
+		encodeSpectrumPacket(packet, settings.encoding, datagram);
+
+#ifdef SPECTRUM_STREAM_SUPPORTED
+		// receivers cope with lost datagrams, so errors are not fatal
+		sendto(sendSocket, datagram.data(), datagram.size(), 0,
+		       reinterpret_cast<const sockaddr*>(&destination), sizeof(destination));
+#endif
+	}
+
+private:
+	Settings settings;
+	SpectrumPacket packet;
+	std::vector<uint8_t> datagram;
+
+#ifdef SPECTRUM_STREAM_SUPPORTED
+	int sendSocket = -1;
+	sockaddr_in destination;
+#endif
+};
+
+SpectrumSender::SpectrumSender(const Settings& senderSettings) {
+	impl = new SpectrumSenderImpl(senderSettings);
+}
+
+SpectrumSender::~SpectrumSender() { delete impl; }
+
+SpectrumSender& SpectrumSender::operator=(SpectrumSender&& other) noexcept {
+	std::swap(impl, other.impl);
+	return *this;
+}
+
+void SpectrumSender::send(const AudioData& audioData,
+                          std::chrono::steady_clock::time_point timestamp) {
+	impl->send(audioData, timestamp);
+}
+
+class SpectrumReceiver::SpectrumReceiverImpl {
+public:
+	SpectrumReceiverImpl(const Settings& receiverSettings) {
+		settings = receiverSettings;
+
+#ifdef SPECTRUM_STREAM_SUPPORTED
+		sockaddr_in address = resolve(settings.source, true);
+		const bool multicast = isMulticast(address);
+		ip_mreq membership = {};
+		if (multicast) {
+			membership.imr_multiaddr = address.sin_addr;
+			membership.imr_interface.s_addr = htonl(INADDR_ANY);
+			address.sin_addr.s_addr = htonl(INADDR_ANY);
+		}
+
+		receiveSocket = socket(AF_INET, SOCK_DGRAM, 0);
+		if (receiveSocket < 0)
+			throw std::runtime_error(LOCATION "failed to create socket: " +
+			                         std::string(std::strerror(errno)));
+		fcntl(receiveSocket, F_SETFL, fcntl(receiveSocket, F_GETFL) | O_NONBLOCK);
+
+		// several receivers on one machine can listen to the same group
+		const int reuse = 1;
+		if (multicast)
+			setsockopt(receiveSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		if (bind(receiveSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) <
+		        0 ||
+		    (multicast && setsockopt(receiveSocket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership,
+		                             sizeof(membership)) < 0)) {
+			const std::string error = std::strerror(errno);
+			close(receiveSocket);
+			throw std::runtime_error(LOCATION "failed to listen on '" + settings.source +
+			                         "': " + error);
+		}
+#else
+		throw std::runtime_error(LOCATION "spectrum streaming unsupported on this platform!");
+#endif
+	}
+
+	~SpectrumReceiverImpl() {
+#ifdef SPECTRUM_STREAM_SUPPORTED
+		close(receiveSocket);
+#endif
+	}
+
+	bool receive(AudioData& audioData) {
+		bool updated = false;
+
+#ifdef SPECTRUM_STREAM_SUPPORTED
+		while (true) {
+			const ssize_t size = recv(receiveSocket, datagram.data(), datagram.size(), 0);
+			if (size < 0) break;
+
+			try {
+				decodeSpectrumPacket(datagram.data(), size, received);
+			} catch (const std::invalid_argument&) {
+				++stats.invalid;
+				continue;
+			}
+			++stats.received;
+
+			const int32_t difference = static_cast<int32_t>(received.sequence - latest.sequence);
+			if (hasPacket && difference <= 0 && difference > -maxReordering) {
+				++stats.late;
+				continue;
+			}
+			if (hasPacket && difference > 1) stats.lost += difference - 1;
+
+			std::swap(latest, received);
+			hasPacket = true;
+			updated = true;
+		}
+#endif
+
+		if (updated) {
+			audioData.lVolume = latest.lVolume;
+			audioData.rVolume = latest.rVolume;
+			expand(latest.left, audioData.lBuffer, settings.audioSize);
+			expand(latest.right, audioData.rBuffer, settings.audioSize);
+		}
+		return updated;
+	}
+
+	uint16_t port() const {
+#ifdef SPECTRUM_STREAM_SUPPORTED
+		sockaddr_in address = {};
+		socklen_t size = sizeof(address);
+		getsockname(receiveSocket, reinterpret_cast<sockaddr*>(&address), &size);
+		return ntohs(address.sin_port);
+#else
+		return 0;
+#endif
+	}
+
+	Stats stats;
+	SpectrumPacket latest;
+
+private:
+	Settings settings;
+	SpectrumPacket received;
+	bool hasPacket = false;
+	std::vector<uint8_t> datagram = std::vector<uint8_t>(65536);
+
+#ifdef SPECTRUM_STREAM_SUPPORTED
+	int receiveSocket = -1;
+#endif
+};
+
+SpectrumReceiver::SpectrumReceiver(const Settings& receiverSettings) {
+	impl = new SpectrumReceiverImpl(receiverSettings);
+}
+
+SpectrumReceiver::~SpectrumReceiver() { delete impl; }
+
+SpectrumReceiver& SpectrumReceiver::operator=(SpectrumReceiver&& other) noexcept {
+	std::swap(impl, other.impl);
+	return *this;
+}
+
+bool SpectrumReceiver::receive(AudioData& audioData) { return impl->receive(audioData); }
+
+uint16_t SpectrumReceiver::port() const { return impl->port(); }
+
+SpectrumReceiver::Stats SpectrumReceiver::stats() const { return impl->stats; }
+
+const SpectrumPacket& SpectrumReceiver::packet() const { return impl->latest; }
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include "Data.hpp"
+#include "SyntheticAudio.hpp"
+
+SyntheticAudio::SyntheticAudio(const AudioSampler::Settings& audioSettings)
+    : settings(audioSettings),
+      start(std::chrono::steady_clock::now()),
+      ring(audioSettings.bufferSize * audioSettings.channels, 0.f),
+      updatesPerSecond(audioSettings.sampleRate / audioSettings.sampleSize),
+      lastUpdate(start) {}
+
+uint64_t SyntheticAudio::dueFrames() const {
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	const uint64_t frames =
+	    std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() *
+	    settings.sampleRate / 1000000;
+	// only whole blocks arrive
+	return frames - frames % settings.sampleSize;
+}
+
+bool SyntheticAudio::modified() const { return dueFrames() > nextFrame; }
+
+void SyntheticAudio::copyData(AudioData& audioData) {
+	const uint64_t due = dueFrames();
+	updates += static_cast<int>((due - nextFrame) / settings.sampleSize);
+
+	// blocks older than the buffer would be overwritten straight away
+	if (due - nextFrame > settings.bufferSize) nextFrame = due - settings.bufferSize;
+
+	for (; nextFrame < due; ++nextFrame) {
+		for (size_t channel = 0; channel < settings.channels; ++channel)
+			ring[ringPosition * settings.channels + channel] = sample(nextFrame, channel);
+		ringPosition = (ringPosition + 1) % settings.bufferSize;
+	}
+
+	// oldest frame first, as AudioSampler
+	const auto split = ring.begin() + ringPosition * settings.channels;
+	std::copy(split, ring.end(), audioData.buffer);
+	std::copy(ring.begin(), split, audioData.buffer + (ring.end() - split));
+
+	const auto now = std::chrono::steady_clock::now();
+	if (now - lastUpdate >= std::chrono::seconds(1)) {
+		updatesPerSecond = updates;
+		updates = 0;
+		lastUpdate = now;
+	}
+}
+
+float SyntheticAudio::sample(uint64_t frame, size_t channel) {
+	const double t = static_cast<double>(frame) / settings.sampleRate;
+	// sweeps between 55 and 440 Hz every 8 seconds
+	const double fundamental = 55.0 * std::pow(8.0, 0.5 - 0.5 * std::cos(2.0 * M_PI * t / 8.0));
+
+	double value = 0.0;
+	for (int harmonic = 1; harmonic <= 4; ++harmonic)
+		value += std::sin(2.0 * M_PI * fundamental * harmonic * (channel + 1) * t) / harmonic;
+
+	// xorshift noise
+	noiseState ^= noiseState << 13;
+	noiseState ^= noiseState >> 17;
+	noiseState ^= noiseState << 5;
+	const float noise = static_cast<float>(noiseState) / UINT32_MAX - 0.5f;
+
+	return 0.4f * static_cast<float>(value) + 0.05f * noise;
+}
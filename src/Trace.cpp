@@ -0,0 +1,110 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "Trace.hpp"
+
+#ifdef NDEBUG
+	#define LOCATION
+#else
+	#define STR_HELPER(x) #x
+	#define STR(x) STR_HELPER(x)
+	#define LOCATION __FILE__ ":" STR(__LINE__) ": "
+#endif
+
+std::atomic<bool> tracing = false;
+
+namespace {
+	// bounds the memory used by long traces, roughly 40 bytes per span
+	constexpr size_t maxSpans = 1 << 22;
+
+	struct Span {
+		const char* name;
+		uint32_t thread;
+		std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::duration duration;
+	};
+
+	std::mutex traceMutex;
+	std::ofstream traceFile;
+	std::chrono::steady_clock::time_point traceStart;
+	std::vector<Span> spans;
+	bool spansDropped = false;
+
+	uint32_t threadNumber() {
+		static std::atomic<uint32_t> threadCount = 0;
+		thread_local const uint32_t number = threadCount++;
+		return number;
+	}
+
+	void writeString(std::ostream& stream, const char* str) {
+		stream << '"';
+		for (; *str; ++str) {
+			if (*str == '"' || *str == '\\') stream << '\\';
+			stream << *str;
+		}
+		stream << '"';
+	}
+
+	double microseconds(std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+}  // namespace
+
+void startTrace(const std::filesystem::path& path) {
+	std::lock_guard<std::mutex> lock(traceMutex);
+
+	traceFile.open(path);
+	if (!traceFile.is_open())
+		throw std::runtime_error(LOCATION "failed to open trace file '" + path.string() + "'!");
+
+	spans.clear();
+	spansDropped = false;
+	traceStart = std::chrono::steady_clock::now();
+	tracing = true;
+}
+
+void stopTrace() {
+	tracing = false;
+
+	std::lock_guard<std::mutex> lock(traceMutex);
+	if (!traceFile.is_open()) return;
+
+	traceFile << std::fixed << std::setprecision(3);
+	traceFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (size_t i = 0; i < spans.size(); ++i) {
+		const auto& span = spans[i];
+		traceFile << (i ? ",\n" : "\n") << "{\"name\":";
+		writeString(traceFile, span.name);
+		traceFile << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.thread
+		          << ",\"ts\":" << microseconds(span.start - traceStart)
+		          << ",\"dur\":" << microseconds(span.duration) << '}';
+	}
+	traceFile << "\n]}\n";
+	traceFile.close();
+
+	if (spansDropped)
+		std::cerr << LOCATION "trace exceeded " << maxSpans << " spans, later spans were dropped"
+		          << std::endl;
+	spans.clear();
+	spans.shrink_to_fit();
+}
+
+void TraceScope::record(const char* name, std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end) {
+	const auto thread = threadNumber();
+
+	std::lock_guard<std::mutex> lock(traceMutex);
+	if (!tracing) return;
+	if (spans.size() == maxSpans) {
+		spansDropped = true;
+		return;
+	}
+	spans.push_back({name, thread, start, end - start});
+}
@@ -7,24 +7,36 @@
 // C++ standard libraries
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Audio.hpp"
 #include "Calculate.hpp"
+#include "Control.hpp"
 #include "Data.hpp"
+#include "Governor.hpp"
 #include "Process.hpp"
+#include "Recording.hpp"
 #include "Render.hpp"
 #include "Settings.hpp"
+#include "SharedSpectrum.hpp"
+#include "SpectrumDelay.hpp"
+#include "SpectrumStream.hpp"
+#include "SyntheticAudio.hpp"
+#include "Trace.hpp"
 #include "Version.hpp"
 
 #define STR_HELPER(x) #x
@@ -39,6 +51,9 @@ namespace {
 
 	enum class Device { cpu, gpu };
 
+	// where the spectra that are rendered come from
+	enum class AudioSource { capture, synthetic, recording, sharedSpectrum, stream };
+
 	static constexpr const char* versionStr =
 	    "Vkav v" STR(VERSION_MAJOR) "." STR(VERSION_MINOR) "." STR(VERSION_PATCH) " "
 #ifdef NDEBUG
@@ -62,6 +77,21 @@ namespace {
 	    "-a, --amplitude=AMPLITUDE             Multiplies audio with AMPLITUDE.\n"
 	    "    --install-config                  Installs config files to a user\n"
 	    "    --list-modules                    Output the list of available modules and exit\n"
+	    "    --trace=FILE                      Writes timings of startup and every frame\n"
+	    "                                        to FILE as Chrome trace events.\n"
+	    "    --benchmark=SECONDS               Renders synthetic audio, or the replayed\n"
+	    "                                        recording, as fast as possible for\n"
+	    "                                        SECONDS, prints timing statistics and\n"
+	    "                                        exits.\n"
+	    "    --record=FILE                     Records every processed spectrum to FILE.\n"
+	    "    --replay=FILE                     Renders a recording instead of capturing\n"
+	    "                                        and processing audio.\n"
+	    "    --attach=NAME                     Renders the spectra another instance\n"
+	    "                                        publishes as sharedSpectrum NAME instead\n"
+	    "                                        of capturing and processing audio.\n"
+	    "    --receive=[GROUP:]PORT            Renders the spectra another instance\n"
+	    "                                        streams to PORT, joining the multicast\n"
+	    "                                        GROUP if given.\n"
 	    "-h, --help                            Display this help and exit.\n"
 	    "-V, --version                         Output version information and exit.\n"
 	    "                                        specific config directory.\n"
@@ -72,6 +102,35 @@ namespace {
 
 #define WARN_UNDEFINED(name) std::clog << #name << " not defined!" << std::endl;
 
+	struct Summary {
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+
+	Summary summarise(std::vector<double> values) {
+		Summary summary;
+		if (values.empty()) return summary;
+
+		std::sort(values.begin(), values.end());
+		// nearest rank
+		auto percentile = [&](double p) {
+			return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+		};
+		for (double value : values) summary.mean += value;
+		summary.mean /= values.size();
+		summary.p50 = percentile(0.5);
+		summary.p99 = percentile(0.99);
+		summary.max = values.back();
+		return summary;
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const Summary& summary) {
+		return stream << "mean " << summary.mean << " | p50 " << summary.p50 << " | p99 "
+		              << summary.p99 << " | max " << summary.max;
+	}
+
 	class Vkav {
 	public:
 		Vkav(int argc, const char* argv[]) {
@@ -108,6 +167,10 @@ namespace {
 			if (cmdLineArgs.find("verbose") == cmdLineArgs.end())
 				std::clog.setstate(std::ios::failbit);
 
+			if (auto it = cmdLineArgs.find("trace"); it != cmdLineArgs.end())
+				startTrace(it->second);
+			TRACE_SCOPE("initialise");
+
 			std::filesystem::path configFilePath;
 
 #ifdef NDEBUG
@@ -138,9 +201,12 @@ namespace {
 			AudioSampler::Settings audioSettings = {};
 			Renderer::Settings renderSettings = {};
 			renderSettings.moduleLocations = configLocations;
-			Process::Settings processSettings = {};
+			renderSettings.shaderCacheLocation = getCacheLocation() / "shaders";
+			processSettings = {};
 
-			fillStructs(cmdLineArgs, audioSettings, renderSettings, processSettings);
+			fillStructs(cmdLineArgs, audioSettings, renderSettings, processSettings,
+			            smoothingDevice);
+			gpuSmoothingLevel = renderSettings.smoothingLevel;
 
 			fpsLimit = 0;
 			if (auto it = cmdLineArgs.find("fpsLimit"); it != cmdLineArgs.end())
@@ -149,15 +215,141 @@ namespace {
 				WARN_UNDEFINED(fpsLimit);
 			renderSettings.vsync = (fpsLimit == 0);
 
+			if (auto it = cmdLineArgs.find("benchmark"); it != cmdLineArgs.end()) {
+				benchmarkDuration = std::chrono::duration<double>(calculate<float>(it->second));
+				// at least one frame must be measured for the statistics
+				if (!(benchmarkDuration->count() > 0.0))
+					throw std::runtime_error(LOCATION "benchmark duration '" + it->second +
+					                         "' is not greater than zero!");
+				// measure how fast frames can be drawn rather than the refresh rate
+				fpsLimit = 0;
+				renderSettings.vsync = false;
+				audioSource = AudioSource::synthetic;
+			}
+
+			// the renderer reads as many values as the source provides
+			if (auto it = cmdLineArgs.find("replay"); it != cmdLineArgs.end()) {
+				recording = Recording(it->second);
+				if (recording.size() == 0)
+					throw std::runtime_error(LOCATION "recording '" + it->second + "' is empty!");
+				audioSource = AudioSource::recording;
+				renderSettings.audioSize = recording.audioSize();
+			} else if (auto it = cmdLineArgs.find("attach"); it != cmdLineArgs.end()) {
+				sharedSpectrumReader = SharedSpectrumReader(it->second);
+				audioSource = AudioSource::sharedSpectrum;
+				renderSettings.audioSize = sharedSpectrumReader.audioSize();
+			} else if (auto it = cmdLineArgs.find("receive"); it != cmdLineArgs.end()) {
+				SpectrumReceiver::Settings receiverSettings = {};
+				receiverSettings.source = it->second;
+				receiverSettings.audioSize = renderSettings.audioSize;
+				spectrumReceiver = SpectrumReceiver(receiverSettings);
+				audioSource = AudioSource::stream;
+			}
+
 			std::clog << "Initialising renderer" << std::endl;
 			renderer = Renderer(renderSettings);
 			process = Process(processSettings);
 			// construct AudioSampler after the Renderer in order to avoid
 			// PortAudio/ASIO throwing a bunch of CoInit warnings:
 			std::clog << "Initialising audio" << std::endl;
-			audioSampler = AudioSampler(audioSettings);
+			switch (audioSource) {
+				case AudioSource::capture: {
+					TRACE_SCOPE("connectAudio");
+					audioSampler = AudioSampler(audioSettings);
+					break;
+				}
+				case AudioSource::synthetic:
+					syntheticAudio = SyntheticAudio(audioSettings);
+					break;
+				case AudioSource::recording:
+					std::clog << "Replaying " << recording.size() << " recorded updates"
+					          << std::endl;
+					break;
+				case AudioSource::sharedSpectrum:
+					std::clog << "Attached to a shared spectrum" << std::endl;
+					break;
+				case AudioSource::stream:
+					std::clog << "Receiving spectra on port " << spectrumReceiver.port()
+					          << std::endl;
+					break;
+			}
+
+			audioData.allocate(audioSettings.channels,
+			                   std::max(audioSettings.bufferSize, 2 * renderSettings.audioSize));
+
+			if (auto it = cmdLineArgs.find("record"); it != cmdLineArgs.end())
+				recordingWriter = RecordingWriter(it->second, renderSettings.audioSize);
+
+			if (auto it = cmdLineArgs.find("controlSocket"); it != cmdLineArgs.end()) {
+				if (it->second != "none") {
+					ControlServer::Settings controlSettings = {};
+					controlSettings.socketPath = it->second == "auto"
+					                                 ? ControlServer::defaultSocketPath()
+					                                 : parseAsString(it->second);
+					std::clog << "Listening on " << controlSettings.socketPath << std::endl;
+					controlServer = ControlServer(controlSettings);
+				}
+			} else {
+				WARN_UNDEFINED(controlSocket);
+			}
+
+			if (auto it = cmdLineArgs.find("sharedSpectrum"); it != cmdLineArgs.end()) {
+				if (it->second != "none" && audioSource != AudioSource::sharedSpectrum)
+					sharedSpectrumWriter = SharedSpectrumWriter(
+					    std::string(parseAsString(it->second)), renderSettings.audioSize);
+			} else {
+				WARN_UNDEFINED(sharedSpectrum);
+			}
 
-			audioData.allocate(audioSettings.channels, audioSettings.bufferSize);
+			if (auto it = cmdLineArgs.find("streamDestination"); it != cmdLineArgs.end()) {
+				if (it->second != "none" && audioSource != AudioSource::stream)
+					spectrumSender = SpectrumSender(
+					    readSenderSettings(cmdLineArgs, it->second, renderSettings.audioSize));
+			} else {
+				WARN_UNDEFINED(streamDestination);
+			}
+
+			if (auto it = cmdLineArgs.find("statsFile"); it != cmdLineArgs.end()) {
+				if (it->second != "none") statsFilePath = parseAsString(it->second);
+			} else {
+				WARN_UNDEFINED(statsFile);
+			}
+
+			if (auto it = cmdLineArgs.find("frameBudgetMs"); it != cmdLineArgs.end()) {
+				// benchmarks measure the configured quality
+				if (it->second != "none" && !benchmarkDuration) {
+					Governor::Settings governorSettings = {};
+					governorSettings.frameBudget = calculate<float>(it->second);
+					governor = Governor(governorSettings);
+				}
+			} else {
+				WARN_UNDEFINED(frameBudgetMs);
+			}
+
+			// only captured audio is heard after it is analysed
+			if (auto it = cmdLineArgs.find("avSync"); it != cmdLineArgs.end())
+				avSync = (it->second == "true") && audioSource == AudioSource::capture;
+			else
+				WARN_UNDEFINED(avSync);
+
+			if (auto it = cmdLineArgs.find("avSyncOffsetMs"); it != cmdLineArgs.end())
+				avSyncOffset = calculate<float>(it->second);
+			else
+				WARN_UNDEFINED(avSyncOffsetMs);
+
+			if (avSync) {
+				const double updatesPerSecond =
+				    static_cast<double>(audioSettings.sampleRate) / audioSettings.sampleSize;
+				spectrumDelay = SpectrumDelay(
+				    renderSettings.audioSize,
+				    static_cast<size_t>(std::ceil(maxAvSyncDelay / 1e3 * updatesPerSecond)) + 1);
+				delayedAudioData.allocate(audioSettings.channels,
+				                          std::max(audioSettings.bufferSize,
+				                                   2 * renderSettings.audioSize));
+				// drawn until the first spectrum is due
+				std::fill_n(delayedAudioData.lBuffer, renderSettings.audioSize, 0.f);
+				std::fill_n(delayedAudioData.rBuffer, renderSettings.audioSize, 0.f);
+			}
 
 			auto initEnd = std::chrono::high_resolution_clock::now();
 			std::clog << "Initialisation took: "
@@ -166,20 +358,36 @@ namespace {
 			          << " milliseconds" << std::endl;
 		}
 
+		~Vkav() { stopTrace(); }
+
 		void run() {
+			if (benchmarkDuration) {
+				runBenchmark();
+				return;
+			}
+
 			int numFrames = 0;
 			const std::chrono::microseconds targetFrameTime{(fpsLimit ? 1000000 / fpsLimit : 0)};
 			auto lastFrame = std::chrono::steady_clock::now();
 			auto lastUpdate = std::chrono::steady_clock::now();
+			audioStart = std::chrono::steady_clock::now();
 
-			while (audioSampler.running()) {
-				if (audioSampler.modified()) {
-					audioSampler.copyData(audioData);
-					process.processSignal(audioData);
-				}
+			while (audioRunning()) {
+				TRACE_SCOPE("frame");
+				controlServer.poll(
+				    [this](const ControlCommand& command) { return handleCommand(command); });
+
+				const auto updateStart = std::chrono::steady_clock::now();
+				if (!updateAudioData()) ++staleFrames;
+				const auto updateTime = std::chrono::steady_clock::now() - updateStart;
 
 				if (fpsLimit) std::this_thread::sleep_until(lastFrame + targetFrameTime);
-				if (!renderer.drawFrame(audioData)) break;
+				{
+					TRACE_SCOPE("drawFrame");
+					if (!renderer.drawFrame(avSync ? delayedAudioData : audioData)) break;
+				}
+
+				if (governor) governQuality(updateTime);
 
 				lastFrame = std::chrono::steady_clock::now();
 				++numFrames;
@@ -187,16 +395,28 @@ namespace {
 				auto currentTime = std::chrono::steady_clock::now();
 				if (std::chrono::duration_cast<std::chrono::seconds>(currentTime - lastUpdate)
 				        .count() >= 1) {
+					const auto audioStats = this->audioStats();
 					std::clog << "FPS: " << std::setw(3) << std::right << numFrames
-					          << " | UPS: " << std::setw(3) << std::right << audioSampler.ups()
-					          << std::endl;
+					          << " | UPS: " << std::setw(3) << std::right << ups()
+					          << " | overruns: " << audioStats.overruns
+					          << " | holes: " << audioStats.holes
+					          << " | dropped blocks: " << audioStats.droppedBlocks
+					          << " | stale frames: " << staleFrames;
+					if (avSync)
+						std::clog << " | A/V delay: " << static_cast<int>(avSyncDelay) << " ms";
+					std::clog << std::endl;
+					fps = numFrames;
 					numFrames = 0;
+					sourceUps = sourceUpdates;
+					sourceUpdates = 0;
 					lastUpdate = currentTime;
+
+					if (!statsFilePath.empty()) writeStatsFile();
 				}
 			}
 
 			// rethrow any exceptions the audio thread may have thrown
-			audioSampler.rethrowExceptions();
+			if (audioSource == AudioSource::capture) audioSampler.rethrowExceptions();
 		}
 
 	private:
@@ -205,20 +425,323 @@ namespace {
 		AudioSampler audioSampler;
 		Renderer renderer;
 		Process process;
+		ControlServer controlServer;
+
+		Process::Settings processSettings;
+		Device smoothingDevice;
+		// smoothing level of the shaders at the highest quality
+		float gpuSmoothingLevel = 0.f;
+		// lowers the quality while frames exceed frameBudgetMs
+		std::optional<Governor> governor;
+
+		// longest delay in milliseconds the captured spectra can be held back
+		static constexpr double maxAvSyncDelay = 2000.0;
+		// with avSync, spectra are drawn from delayedAudioData once the audio is heard
+		bool avSync = false;
+		SpectrumDelay spectrumDelay;
+		AudioData delayedAudioData;
+		// milliseconds added to the measured delay, and the delay applied last
+		double avSyncOffset = 0.0;
+		double avSyncDelay = 0.0;
 
 		size_t fpsLimit;
+		int fps = 0;
+
+		AudioSource audioSource = AudioSource::capture;
+		SyntheticAudio syntheticAudio;
+		std::optional<std::chrono::duration<double>> benchmarkDuration;
+		// the recording and shared spectrum sources replace audioSampler and process
+		Recording recording;
+		size_t nextRecord = 0;
+		SharedSpectrumReader sharedSpectrumReader;
+		SpectrumReceiver spectrumReceiver;
+		// updates and updates per second of those sources
+		int sourceUpdates = 0;
+		int sourceUps = 0;
+
+		RecordingWriter recordingWriter;
+		SharedSpectrumWriter sharedSpectrumWriter;
+		SpectrumSender spectrumSender;
+		// timestamps of recorded and replayed updates are relative to this
+		std::chrono::steady_clock::time_point audioStart;
+		// frames drawn without new audio data
+		uint64_t staleFrames = 0;
+		std::filesystem::path statsFilePath;
+
+		bool audioRunning() const {
+			switch (audioSource) {
+				case AudioSource::recording:
+					return nextRecord < recording.size();
+				case AudioSource::sharedSpectrum:
+					return !sharedSpectrumReader.closed();
+				case AudioSource::stream:
+					return true;
+				default:
+					return audioSampler.running();
+			}
+		}
+
+		int ups() const {
+			return audioSource == AudioSource::capture ? audioSampler.ups() : sourceUps;
+		}
+
+		AudioSampler::Stats audioStats() const {
+			AudioSampler::Stats stats = {};
+			if (audioSource == AudioSource::capture) stats = audioSampler.stats();
+			// lost datagrams are the holes of a stream
+			if (audioSource == AudioSource::stream) stats.holes = spectrumReceiver.stats().lost;
+			return stats;
+		}
+
+		/**
+		 * Copies and processes new audio into audioData, or copies the latest recorded or
+		 * published update. Returns false if there was nothing new.
+		 */
+		bool updateAudioData() {
+			const auto now = std::chrono::steady_clock::now();
+			const auto timestamp = now - audioStart;
+
+			if (audioSource == AudioSource::recording) {
+				if (recording.timestamp(nextRecord) > timestamp) return false;
+				TRACE_SCOPE("copyData");
+				const size_t record = recording.find(timestamp);
+				recording.copyRecord(record, audioData);
+				sourceUpdates += record + 1 - nextRecord;
+				nextRecord = record + 1;
+				return true;
+			}
+
+			if (audioSource == AudioSource::sharedSpectrum) {
+				TRACE_SCOPE("copyData");
+				const uint64_t lastSequence = sharedSpectrumReader.sequence();
+				if (!sharedSpectrumReader.read(audioData)) return false;
+				sourceUpdates += sharedSpectrumReader.sequence() - lastSequence;
+				return true;
+			}
+
+			if (audioSource == AudioSource::stream) {
+				TRACE_SCOPE("copyData");
+				if (!spectrumReceiver.receive(audioData)) return false;
+				++sourceUpdates;
+				return true;
+			}
+
+			const bool modified = audioSampler.modified();
+			if (modified) {
+				{
+					TRACE_SCOPE("copyData");
+					audioSampler.copyData(audioData);
+				}
+				{
+					TRACE_SCOPE("processSignal");
+					process.processSignal(audioData);
+				}
+				if (recordingWriter.isOpen()) recordingWriter.write(audioData, timestamp);
+				if (sharedSpectrumWriter.isOpen()) sharedSpectrumWriter.publish(audioData, now);
+				if (spectrumSender.isOpen()) spectrumSender.send(audioData, now);
+			}
+			return avSync ? delaySpectrum(modified, now) : modified;
+		}
+
+		/**
+		 * Holds spectra back by the playback latency of the sink, less the time frames take to
+		 * be shown, plus avSyncOffset. Copies the newest spectrum that is due into
+		 * delayedAudioData, returns false if there is none.
+		 */
+		bool delaySpectrum(bool modified, std::chrono::steady_clock::time_point now) {
+			avSyncDelay = std::clamp(audioSampler.playbackLatency().value_or(0.0) -
+			                             renderer.presentLatency().value_or(0.0) + avSyncOffset,
+			                         0.0, maxAvSyncDelay);
+
+			if (modified) spectrumDelay.push(audioData, now);
+			const auto delay = std::chrono::duration<double, std::milli>(avSyncDelay);
+			return spectrumDelay.pop(
+			    delayedAudioData,
+			    now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay));
+		}
+
+		float quality() const { return governor ? governor->quality() : 1.f; }
+
+		/**
+		 * Gives the governor the GPU or processing time of the last frame, whichever is longer,
+		 * and applies the quality it picks: the quality frame variable of the modules and the
+		 * width of the shaders' smoothing kernel both scale with it.
+		 */
+		void governQuality(std::chrono::steady_clock::duration processingTime) {
+			using milliseconds = std::chrono::duration<double, std::milli>;
+			const double frameTime = std::max(renderer.frameTime().value_or(0.0),
+			                                  milliseconds(processingTime).count());
+			if (!governor->addFrame(frameTime)) return;
+
+			renderer.setQuality(quality());
+			if (smoothingDevice == Device::gpu && gpuSmoothingLevel > 0.f)
+				renderer.setSmoothingLevel(gpuSmoothingLevel * quality());
+			std::clog << "Quality level " << governor->level() << ": frames took "
+			          << governor->average() << " ms on average" << std::endl;
+		}
+
+		/**
+		 * Returns the frame rate and capture counters as name value pairs separated by separator
+		 */
+		std::string formatStats(char separator) const {
+			const auto audioStats = this->audioStats();
+			std::stringstream stats;
+			stats << "fps " << fps << separator << "ups " << ups() << separator
+			      << "overruns " << audioStats.overruns << separator << "holes "
+			      << audioStats.holes << separator << "droppedBlocks " << audioStats.droppedBlocks
+			      << separator << "staleFrames " << staleFrames << "\n";
+			return stats.str();
+		}
+
+		/**
+		 * Replaces the stats file so that readers never see it partially written
+		 */
+		void writeStatsFile() {
+			auto tempPath = statsFilePath;
+			tempPath += ".tmp";
+			{
+				std::ofstream file(tempPath);
+				file << formatStats('\n');
+				if (!file) {
+					std::cerr << LOCATION "failed to write stats file " << statsFilePath << "!"
+					          << std::endl;
+					statsFilePath.clear();
+					return;
+				}
+			}
+
+			std::error_code error;
+			std::filesystem::rename(tempPath, statsFilePath, error);
+			if (error) {
+				std::cerr << LOCATION "failed to write stats file " << statsFilePath << ": "
+				          << error.message() << std::endl;
+				statsFilePath.clear();
+			}
+		}
+
+		/**
+		 * Processes synthetic audio and draws frames as fast as possible for benchmarkDuration,
+		 * then prints statistics of the frame, processing and upload times. When replaying,
+		 * every frame draws the next recorded update instead, so the renderer gets the same
+		 * work in every run. When attached or receiving, the latest update is drawn.
+		 */
+		void runBenchmark() {
+			using milliseconds = std::chrono::duration<double, std::milli>;
+
+			std::vector<double> frameTimes;
+			std::vector<double> processTimes;
+			renderer.uploadTime();
+
+			const auto start = std::chrono::steady_clock::now();
+			auto lastFrame = start;
+			while (lastFrame - start < *benchmarkDuration) {
+				if (audioSource == AudioSource::recording) {
+					recording.copyRecord(frameTimes.size() % recording.size(), audioData);
+				} else if (audioSource == AudioSource::sharedSpectrum) {
+					sharedSpectrumReader.read(audioData);
+				} else if (audioSource == AudioSource::stream) {
+					spectrumReceiver.receive(audioData);
+				} else if (syntheticAudio.modified()) {
+					syntheticAudio.copyData(audioData);
+					const auto processStart = std::chrono::steady_clock::now();
+					process.processSignal(audioData);
+					processTimes.push_back(
+					    milliseconds(std::chrono::steady_clock::now() - processStart).count());
+				}
+
+				if (!renderer.drawFrame(audioData)) break;
+
+				const auto currentTime = std::chrono::steady_clock::now();
+				frameTimes.push_back(milliseconds(currentTime - lastFrame).count());
+				lastFrame = currentTime;
+			}
+
+			const double seconds = std::chrono::duration<double>(lastFrame - start).count();
+			// the window may have been closed before the first frame
+			auto rate = [seconds](size_t count) { return seconds > 0.0 ? count / seconds : 0.0; };
+			std::cout << std::fixed << std::setprecision(3) << "Benchmark of " << seconds
+			          << " seconds\n"
+			          << "FPS: " << rate(frameTimes.size())
+			          << " | UPS: " << rate(processTimes.size()) << "\n"
+			          << "Frame time (ms): " << summarise(frameTimes) << "\n"
+			          << "Processing time per update (ms): " << summarise(processTimes) << "\n"
+			          << "Upload time per frame (ms): mean " << renderer.uploadTime()
+			          << std::endl;
+		}
+
+		std::string handleCommand(const ControlCommand& command) {
+			switch (command.type) {
+				case ControlCommand::Type::modules: {
+					if (command.modules.empty())
+						throw std::invalid_argument("at least one module is required!");
+					renderer.setModules({command.modules.begin(), command.modules.end()});
+					break;
+				}
+				case ControlCommand::Type::set:
+					if (!renderer.setParameter(command.module, command.parameter, command.value))
+						throw std::invalid_argument("no dynamic parameter named '" +
+						                            command.parameter + "' in module '" +
+						                            command.module + "'!");
+					break;
+				case ControlCommand::Type::amplitude:
+					processSettings.amplitude = command.value;
+					process = Process(processSettings);
+					break;
+				case ControlCommand::Type::smoothingLevel:
+					switch (smoothingDevice) {
+						case Device::gpu:
+							gpuSmoothingLevel = command.value;
+							renderer.setSmoothingLevel(gpuSmoothingLevel * quality());
+							break;
+						case Device::cpu:
+							processSettings.smoothingLevel = command.value;
+							process = Process(processSettings);
+							break;
+					}
+					break;
+				case ControlCommand::Type::stats:
+					return formatStats(' ');
+			}
+			return "ok\n";
+		}
+
+		static SpectrumSender::Settings readSenderSettings(
+		    const std::unordered_map<std::string, std::string>& settings,
+		    std::string_view destination, size_t audioSize) {
+			SpectrumSender::Settings senderSettings = {};
+			senderSettings.destination = parseAsString(destination);
+			senderSettings.audioSize = audioSize;
+
+			if (const auto setting = settings.find("streamEncoding"); setting != settings.end()) {
+				if (setting->second == "fp16")
+					senderSettings.encoding = SpectrumEncoding::fp16;
+				else if (setting->second == "log8")
+					senderSettings.encoding = SpectrumEncoding::log8;
+				else
+					std::cerr << LOCATION "Stream encoding set to an invalid value!\n";
+			} else {
+				WARN_UNDEFINED(streamEncoding);
+			}
+
+			if (const auto setting = settings.find("streamBands"); setting != settings.end())
+				senderSettings.bands = calculate<size_t>(setting->second);
+			else
+				WARN_UNDEFINED(streamBands);
+
+			return senderSettings;
+		}
 
 		static void fillStructs(const std::unordered_map<std::string, std::string>& settings,
 		                        AudioSampler::Settings& audioSettings,
 		                        Renderer::Settings& renderSettings,
-		                        Process::Settings& processSettings) {
+		                        Process::Settings& processSettings, Device& smoothingDevice) {
 			float trebleCut = 0.09f;
 			if (const auto setting = settings.find("trebleCut"); setting != settings.end())
 				trebleCut = calculate<float>(setting->second);
 			else
 				WARN_UNDEFINED(trebleCut);
 
-			Device smoothingDevice = Device::gpu;
+			smoothingDevice = Device::gpu;
 			if (const auto setting = settings.find("smoothingDevice"); setting != settings.end()) {
 				if (setting->second == "CPU")
 					smoothingDevice = Device::cpu;
@@ -276,6 +799,16 @@ namespace {
 				WARN_UNDEFINED(backgroundImage)
 			}
 
+			if (const auto setting = settings.find("fuseModules"); setting != settings.end())
+				renderSettings.fuseModules = (setting->second == "true");
+			else
+				WARN_UNDEFINED(fuseModules);
+
+			if (const auto setting = settings.find("spectrumMipLevels"); setting != settings.end())
+				renderSettings.spectrumMipLevels = calculate<size_t>(setting->second);
+			else
+				WARN_UNDEFINED(spectrumMipLevels);
+
 			if (const auto setting = settings.find("width"); setting != settings.end())
 				renderSettings.window.width = calculate<int>(setting->second);
 			else
@@ -372,6 +905,12 @@ namespace {
 				processSettings.amplitude = calculate<float>(setting->second);
 			else
 				WARN_UNDEFINED(amplitude);
+
+			processSettings.sampleRate = audioSettings.sampleRate;
+			if (const auto setting = settings.find("equaliser"); setting != settings.end())
+				processSettings.equaliser = setting->second;
+			else
+				WARN_UNDEFINED(equaliser);
 		}
 	};
 }  // namespace
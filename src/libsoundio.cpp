@@ -28,6 +28,10 @@ public:
 	std::atomic<bool> running;
 	std::atomic<bool> modified;
 	std::atomic<int> ups;
+	std::atomic<uint64_t> overruns{0};
+	// libsoundio does not report holes
+	std::atomic<uint64_t> holes{0};
+	std::atomic<uint64_t> droppedBlocks{0};
 
 	AudioSamplerImpl(const Settings& audioSettings) {
 		settings.channels = audioSettings.channels;
@@ -166,6 +170,7 @@ private:
 		stream->format = SoundIoFormatFloat32LE;
 		stream->sample_rate = sampleRate;
 		stream->read_callback = readCallback;
+		stream->overflow_callback = overflowCallback;
 		stream->userdata = this;
 		stream->software_latency =
 		    sizeof(float) * settings.sampleSize * sampleRate / settings.sampleRate;
@@ -221,6 +226,10 @@ private:
 		}
 	}
 
+	static void overflowCallback(SoundIoInStream* instream) {
+		++reinterpret_cast<AudioSamplerImpl*>(instream->userdata)->overruns;
+	}
+
 	static void updateBuffers(AudioSamplerImpl* audio) {
 		static std::chrono::steady_clock::time_point lastFrame = std::chrono::steady_clock::now();
 		static int numUpdates = 0;
@@ -229,7 +238,7 @@ private:
 		for (size_t i = 1; i * audio->settings.sampleSize < audio->settings.bufferSize; ++i)
 			std::swap(audio->ppAudioBuffer[i - 1], audio->ppAudioBuffer[i]);
 		audio->audioMutexLock.unlock();
-		audio->modified = true;
+		if (audio->modified.exchange(true)) ++audio->droppedBlocks;
 
 		++numUpdates;
 		std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
@@ -260,6 +269,17 @@ bool AudioSampler::modified() const { return audioSamplerImpl->modified; }
 
 int AudioSampler::ups() const { return audioSamplerImpl->ups; }
 
+AudioSampler::Stats AudioSampler::stats() const {
+	Stats stats;
+	stats.overruns = audioSamplerImpl->overruns.load(std::memory_order_relaxed);
+	stats.holes = audioSamplerImpl->holes.load(std::memory_order_relaxed);
+	stats.droppedBlocks = audioSamplerImpl->droppedBlocks.load(std::memory_order_relaxed);
+	return stats;
+}
+
+// the latency of the output whose audio is captured is not known
+std::optional<double> AudioSampler::playbackLatency() const { return std::nullopt; }
+
 void AudioSampler::copyData(AudioData& audioData) { audioSamplerImpl->copyData(audioData); }
 
 void AudioSampler::rethrowExceptions() { return audioSamplerImpl->rethrowExceptions(); }
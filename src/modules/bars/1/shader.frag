@@ -22,8 +22,7 @@ layout(set = 0, binding = 0) uniform data {
 	float rVolume;
 };
 
-layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
-layout(set = 0, binding = 2) uniform samplerBuffer rBuffer;
+layout(set = 0, binding = 4) uniform samplerBuffer stereoBuffer;
 
 layout(location = 0) in vec2 position;
 layout(location = 1) in vec2 screen;
@@ -47,16 +46,13 @@ void main() {
 
 		float texCoord = 2.0*barCenter/screen.x;
 
+		const vec2 channels = kernelSmoothTextureStereo(stereoBuffer, smoothingLevel, texCoord);
 		if (abs(texCoord) < mixThreshold)
-			v = mix(
-					kernelSmoothTexture(lBuffer, smoothingLevel, texCoord),
-					kernelSmoothTexture(rBuffer, smoothingLevel, texCoord),
-					0.5*(texCoord+mixThreshold)/mixThreshold
-				);
+			v = mix(channels.x, channels.y, 0.5*(texCoord+mixThreshold)/mixThreshold);
 		else if (position.x < 0.0)
-			v = kernelSmoothTexture(lBuffer, smoothingLevel, texCoord);
+			v = channels.x;
 		else
-			v = kernelSmoothTexture(rBuffer, smoothingLevel, texCoord);
+			v = channels.y;
 
 		if (position.y < amplitude*v) {
 			outColor = vec4(color * brightness * (screen.y*position.y/40 + 1), 1.f);
@@ -0,0 +1,30 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(constant_id = 2) const int width            = 1;
+layout(constant_id = 3) const int height           = 1;
+
+layout(constant_id = 11) const float radius = 150;
+layout(constant_id = 12) const float thickness = 3;
+layout(constant_id = 13) const float radiusSensitivity = 200;
+
+layout(constant_id = 14) const float red = 0.314;
+layout(constant_id = 15) const float green = 0.314;
+layout(constant_id = 16) const float blue = 0.792;
+
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+};
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+	vec2 position = gl_FragCoord.xy - 0.5*vec2(width, height);
+	float ringRadius = radius + radiusSensitivity*(lVolume + rVolume);
+
+	float distance = abs(length(position) - ringRadius);
+	float alpha = clamp(thickness - distance, 0.0, 1.0);
+
+	outColor = vec4(red, green, blue, alpha);
+}
@@ -0,0 +1,42 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// size of the target drawn to
+layout(constant_id = 2) const int width            = 1;
+layout(constant_id = 3) const int height           = 1;
+
+layout(constant_id = 17) const float blurRadius = 4;
+
+// dynamic parameters, bound after the targets
+layout(set = 1, binding = 3) uniform Parameters {
+	int blurSamples;
+};
+
+layout(set = 1, binding = 1) uniform sampler2D blurX;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+	vec2 size = vec2(width, height);
+	vec2 texCoord = gl_FragCoord.xy/size;
+	vec2 direction = vec2(0, 1)/size;
+
+	// gaussian weights with a standard deviation of blurRadius/2
+	float coef = -2.0/(blurRadius*blurRadius);
+
+	// the taps are linearly filtered, so they can lie between texels
+	int samples = max(blurSamples, 1);
+	float stride = blurRadius/float(samples);
+
+	vec4 color = texture(blurX, texCoord);
+	float totalWeight = 1.0;
+	for (int i = 1; i <= samples; ++i) {
+		float offset = stride*float(i);
+		float weight = exp(coef*offset*offset);
+		color += weight*(texture(blurX, texCoord + offset*direction) +
+		                 texture(blurX, texCoord - offset*direction));
+		totalWeight += 2.0*weight;
+	}
+
+	outColor = color/totalWeight;
+}
@@ -0,0 +1,19 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(constant_id = 2) const int width            = 1;
+layout(constant_id = 3) const int height           = 1;
+
+layout(constant_id = 18) const float glowStrength = 2;
+
+layout(set = 1, binding = 0) uniform sampler2D scene;
+layout(set = 1, binding = 2) uniform sampler2D blurY;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+	vec2 texCoord = gl_FragCoord.xy/vec2(width, height);
+
+	vec4 color = texture(scene, texCoord) + glowStrength*texture(blurY, texCoord);
+	outColor = vec4(color.rgb, clamp(color.a, 0.0, 1.0));
+}
@@ -0,0 +1,20 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(constant_id = 16) const float red = 0.6;
+layout(constant_id = 17) const float green = 0.0;
+layout(constant_id = 18) const float blue = 0.204;
+layout(constant_id = 19) const float alpha = 0.9;
+layout(constant_id = 20) const float ambient = 0.3;
+
+layout(location = 0) in vec3 normal;
+
+layout(location = 0) out vec4 outColor;
+
+// directional light from the side of the camera
+const vec3 lightDirection = normalize(vec3(-1, -1, 1));
+
+void main() {
+	float diffuse = max(dot(normalize(normal), lightDirection), 0.0);
+	outColor = vec4((ambient + (1 - ambient)*diffuse)*vec3(red, green, blue), alpha);
+}
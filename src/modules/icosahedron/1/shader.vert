@@ -0,0 +1,51 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(constant_id = 2) const int width            = 1;
+layout(constant_id = 3) const int height           = 1;
+
+layout(constant_id = 11) const float size = 1;
+layout(constant_id = 12) const float distance = 6;
+layout(constant_id = 13) const float fov = 0.6;
+layout(constant_id = 14) const float rpm = 6;
+layout(constant_id = 15) const float reactivity = 4;
+
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+	uint time;
+};
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+
+layout(location = 0) out vec3 normal;
+
+const float PI = 3.14159265359;
+
+void main() {
+	float scale = size + reactivity*(lVolume + rVolume);
+	float rotation = 2*PI*time*rpm/(1000*60);
+
+	// about the vertical axis and tilted towards the camera
+	mat3 spin = mat3(
+		cos(rotation), 0, -sin(rotation),
+		0            , 1, 0             ,
+		sin(rotation), 0, cos(rotation)
+	);
+	mat3 tilt = mat3(
+		1, 0        , 0         ,
+		0, cos(0.4), -sin(0.4),
+		0, sin(0.4), cos(0.4)
+	);
+	mat3 model = tilt*spin;
+
+	normal = model*inNormal;
+	vec3 position = model*inPosition*scale - vec3(0, 0, distance);
+
+	// the depth is unused since there is no depth buffer
+	float focalLength = 1/tan(fov/2);
+	float ratio = float(width)/float(height);
+	gl_Position = vec4(position.x*focalLength/ratio, position.y*focalLength, -0.5*position.z,
+	                   -position.z);
+}
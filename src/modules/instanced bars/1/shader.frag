@@ -0,0 +1,10 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) flat in vec3 barColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+	outColor = vec4(barColor, 1.f);
+}
@@ -0,0 +1,77 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : enable
+
+layout(constant_id = 0) const int audioSize        = 1;
+layout(constant_id = 1) const float smoothingLevel = 0.f;
+layout(constant_id = 2) const int width            = 1;
+layout(constant_id = 3) const int height           = 1;
+layout(constant_id = 5) const int instanceCount    = 1;
+
+layout(constant_id = 11) const int barWidth = 4;
+layout(constant_id = 12) const int barGap = 2;
+layout(constant_id = 13) const float amplitude = 1.f;
+
+layout(constant_id = 14) const float brightnessSensitivity = 1.f;
+
+layout(constant_id = 18) const float limit = 0.4;
+
+layout(set = 0, binding = 0) uniform data {
+	float lVolume;
+	float rVolume;
+};
+
+layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
+layout(set = 0, binding = 2) uniform samplerBuffer rBuffer;
+
+layout(set = 1, binding = 0) uniform sampler1D gradient;
+
+#include "../../smoothing/smoothing.glsl"
+
+// corners of a bar, y = 0 at the top of the bar
+vec2 positions[6] = vec2[](
+	vec2(0.0f, 0.0f), // top left
+	vec2(1.0f, 0.0f), // top right
+	vec2(0.0f, 1.0f), // bottom left
+
+	vec2(1.0f, 1.0f), // bottom right
+	vec2(0.0f, 1.0f), // bottom left
+	vec2(1.0f, 0.0f)  // top right
+);
+
+layout(location = 0) flat out vec3 barColor;
+
+void main() {
+	float totalBarSize = barWidth + barGap;
+	float margin = 0.5*(width - instanceCount*totalBarSize + barGap);
+	float barLeft = margin + gl_InstanceIndex*totalBarSize;
+
+	// left channel on the left half, right channel on the right half, mirrored at the center
+	const float mixThreshold = 0.03;
+	float texCoord = 2.0*(barLeft + 0.5*barWidth)/width - 1.0;
+
+	float v = 0.f;
+	if (abs(texCoord) < mixThreshold)
+		v = mix(
+				kernelSmoothTexture(lBuffer, smoothingLevel, texCoord),
+				kernelSmoothTexture(rBuffer, smoothingLevel, texCoord),
+				0.5*(texCoord+mixThreshold)/mixThreshold
+			);
+	else if (texCoord < 0.0)
+		v = kernelSmoothTexture(lBuffer, smoothingLevel, texCoord);
+	else
+		v = kernelSmoothTexture(rBuffer, smoothingLevel, texCoord);
+
+	float level = clamp(amplitude*v, 0.0, 1.0);
+	float barHeight = level*limit*height;
+
+	vec2 corner = positions[gl_VertexIndex];
+	vec2 pixel = vec2(barLeft + corner.x*barWidth, height - (1.0-corner.y)*barHeight);
+
+	gl_Position = vec4(2.0*pixel/vec2(width, height) - 1.0, 0.0, 1.0);
+
+	float brightness = exp2(10.f*brightnessSensitivity*(lVolume+rVolume));
+	// from the center of the first texel to the center of the last one
+	float texels = textureSize(gradient, 0);
+	barColor = texture(gradient, (0.5 + level*(texels - 1.0))/texels).rgb * brightness;
+}
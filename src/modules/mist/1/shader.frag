@@ -23,8 +23,7 @@ layout(set = 0, binding = 0) uniform data {
 	float rVolume;
 };
 
-layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
-layout(set = 0, binding = 2) uniform samplerBuffer rBuffer;
+layout(set = 0, binding = 5) uniform sampler1D spectrumImage;
 
 layout(location = 0) in vec2 position;
 
@@ -35,9 +34,9 @@ layout(location = 0) out vec4 outColor;
 void main() {
 	float v;
 	if (position.x < 0.0)
-		v = kernelSmoothTexture(lBuffer, smoothingLevel, -2*position.x/width);
+		v = blurSpectrum(spectrumImage, smoothingLevel, -2*position.x/width).x;
 	else
-		v = kernelSmoothTexture(rBuffer, smoothingLevel, 2*position.x/width);
+		v = blurSpectrum(spectrumImage, smoothingLevel, 2*position.x/width).y;
 
 	float delta = fwidth(v);
 	float alpha = 1-smoothstep(amplitude*v-bottom, amplitude*v+top, position.y);
@@ -0,0 +1,19 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(constant_id = 11) const float speed = 0.004;
+
+layout(constant_id = 15) const float red = 0.314;
+layout(constant_id = 16) const float green = 0.314;
+layout(constant_id = 17) const float blue = 0.792;
+
+layout(location = 0) in vec2 offset;
+layout(location = 1) flat in float particleSpeed;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+	float alpha = clamp(1.0 - length(offset), 0.0, 1.0);
+	float brightness = 1.0 + particleSpeed/speed;
+	outColor = vec4(vec3(red, green, blue)*brightness, alpha);
+}
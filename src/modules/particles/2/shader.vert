@@ -0,0 +1,40 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(constant_id = 2) const int width  = 1;
+layout(constant_id = 3) const int height = 1;
+
+layout(constant_id = 14) const float particleSize = 3;
+
+struct Particle {
+	vec2 position;
+	vec2 velocity;
+};
+
+layout(set = 1, binding = 0) readonly buffer particleBuffer {
+	Particle particles[];
+};
+
+vec2 positions[6] = vec2[](
+	vec2(-1.0f, -1.0f), // top left
+	vec2( 1.0f, -1.0f), // top right
+	vec2(-1.0f,  1.0f), // bottom left
+
+	vec2( 1.0f,  1.0f), // bottom right
+	vec2(-1.0f,  1.0f), // bottom left
+	vec2( 1.0f, -1.0f)  // top right
+);
+
+layout(location = 0) out vec2 offset;
+layout(location = 1) flat out float speed;
+
+void main() {
+	Particle particle = particles[gl_InstanceIndex];
+
+	offset = positions[gl_VertexIndex];
+	speed = length(particle.velocity);
+
+	vec2 screen = vec2(width, height);
+	gl_Position = vec4(particle.position*vec2(height/screen.x, 1.0)
+	                   + offset*particleSize/screen, 0.0, 1.0);
+}
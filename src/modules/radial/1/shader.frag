@@ -2,10 +2,12 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_GOOGLE_include_directive : enable
 
+#ifndef VKAV_FUSED
 layout(constant_id = 0) const int audioSize        = 1;
 layout(constant_id = 1) const float smoothingLevel = 0.0;
 layout(constant_id = 2) const int width            = 1;
 layout(constant_id = 3) const int height           = 1;
+#endif
 
 layout(constant_id = 11) const int originalRadius = 128;
 layout(constant_id = 12) const int centerLineWidth = 2;
@@ -22,23 +24,23 @@ layout(constant_id = 20) const float blue = 0.204;
 
 layout(constant_id = 21) const float limit = 0.5;
 
-vec3 color = vec3(red, green, blue);
-
+#ifndef VKAV_FUSED
 layout(set = 0, binding = 0) uniform data {
 	float lVolume;
 	float rVolume;
 };
 
-layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
-layout(set = 0, binding = 2) uniform samplerBuffer rBuffer;
+layout(set = 0, binding = 4) uniform samplerBuffer stereoBuffer;
 
 layout(location = 0) out vec4 outColor;
+#endif
 
 #include "../../smoothing/smoothing.glsl"
 
-const float PI = 3.14159265359;
-
 void main() {
+	const float PI = 3.14159265359;
+	vec3 color = vec3(red, green, blue);
+
 	const float brightness = exp2(20.f*brightnessSensitivity*(lVolume+rVolume));
 	const float radius = min(exp2(radiusSensitivity*(lVolume+rVolume)), 2.0)*originalRadius;
 	const vec2 xy = vec2(gl_FragCoord.x - (0.5*width), (0.5*height) - gl_FragCoord.y);
@@ -74,23 +76,25 @@ void main() {
 			const float trebleMixPoint = 0.95;
 			const float bassMixPoint = 0.05;
 
+			const vec2 channels =
+				kernelSmoothTextureStereo(stereoBuffer, smoothingLevel, texCoord);
 			float v = 0;
 			if (abs(texCoord) > trebleMixPoint)
 				v = mix(
-						kernelSmoothTexture(lBuffer, smoothingLevel, texCoord),
-						kernelSmoothTexture(rBuffer, smoothingLevel, texCoord),
+						channels.x,
+						channels.y,
 						0.5+sign(texCoord)*0.5f/(1-trebleMixPoint)*(1.f-abs(texCoord))
 					);
 			else if (abs(texCoord) < bassMixPoint)
 				v = mix(
-						kernelSmoothTexture(lBuffer, smoothingLevel, texCoord),
-						kernelSmoothTexture(rBuffer, smoothingLevel, texCoord),
+						channels.x,
+						channels.y,
 						0.5+sign(texCoord)*0.5f/bassMixPoint*abs(texCoord)
 					);
 			else if (texCoord < 0)
-				v = kernelSmoothTexture(lBuffer, smoothingLevel, texCoord);
+				v = channels.x;
 			else
-				v = kernelSmoothTexture(rBuffer, smoothingLevel, texCoord);
+				v = channels.y;
 
 			distance -= radius;
 
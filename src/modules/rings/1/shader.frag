@@ -2,10 +2,12 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_GOOGLE_include_directive : enable
 
+#ifndef VKAV_FUSED
 layout(constant_id = 0) const int audioSize        = 1;
 layout(constant_id = 1) const float smoothingLevel = 0.0;
 layout(constant_id = 2) const int width            = 1;
 layout(constant_id = 3) const int height           = 1;
+#endif
 
 layout(constant_id = 11) const int ringCount        = 10;
 layout(constant_id = 12) const float ringWidth      = 20;
@@ -30,25 +32,25 @@ layout(constant_id = 26) const float red2 = 0.294;
 layout(constant_id = 27) const float green2 = 0.294;
 layout(constant_id = 28) const float blue2 = 0.306;
 
-vec3 color1 = vec3(red1, green1, blue1);
-vec3 color2 = vec3(red2, green2, blue2);
-
+#ifndef VKAV_FUSED
 layout(set = 0, binding = 0) uniform data {
 	float lVolume;
 	float rVolume;
 	uint time;
 };
 
-layout(set = 0, binding = 1) uniform samplerBuffer lBuffer;
-layout(set = 0, binding = 2) uniform samplerBuffer rBuffer;
+layout(set = 0, binding = 4) uniform samplerBuffer stereoBuffer;
 
 layout(location = 0) out vec4 outColor;
+#endif
 
 #include "../../smoothing/smoothing.glsl"
 
-const float PI = 3.14159265359;
-
 void main() {
+	const float PI = 3.14159265359;
+	vec3 color1 = vec3(red1, green1, blue1);
+	vec3 color2 = vec3(red2, green2, blue2);
+
 	const float radius = min(exp2(amplitude*(lVolume+rVolume))-1, 1.0)*radiusSensitivity+originalRadius;
 	const vec2 xy = vec2(gl_FragCoord.x - (0.5*width), (0.5*height) - gl_FragCoord.y);
 
@@ -80,10 +82,8 @@ void main() {
 	else
 		ringFrequency = float(ring-1)/ringCount;
 
-	float offset = frequencySensitivity*(
-		kernelSmoothTexture(lBuffer, smoothingLevel, ringFrequency) +
-		kernelSmoothTexture(rBuffer, smoothingLevel, ringFrequency)
-	);
+	const vec2 channels = kernelSmoothTextureStereo(stereoBuffer, smoothingLevel, ringFrequency);
+	float offset = frequencySensitivity*(channels.x + channels.y);
 
 	float ringAngle;
 	if (scaleWithRotationRatio == 1)
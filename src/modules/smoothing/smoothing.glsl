@@ -1,3 +1,6 @@
+#ifndef SMOOTHING_GLSL
+#define SMOOTHING_GLSL
+
 // simulates address mode VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT
 float wrapIndex(float index) {
 	return 1.f - abs(mod(index, 2.f)-1.f);
@@ -7,6 +10,11 @@ float texture(in samplerBuffer s, in float index) {
 	return texelFetch(s, int(wrapIndex(index)*textureSize(s))).r;
 }
 
+// the left channel in x and the right channel in y of the packed stereoBuffer
+vec2 textureStereo(in samplerBuffer s, in float index) {
+	return texelFetch(s, int(wrapIndex(index)*textureSize(s))).rg;
+}
+
 float kernelSmoothTexture(in samplerBuffer s, in float stdDeviation, in float index) {
 	if (stdDeviation == 0.f)
 		return texture(s, index);
@@ -23,6 +31,35 @@ float kernelSmoothTexture(in samplerBuffer s, in float stdDeviation, in float in
 	return stepSize*val / (stdDeviation*sqrt(2*3.14159265359));
 }
 
+// kernelSmoothTexture of both channels of the packed stereoBuffer with a single fetch per tap
+vec2 kernelSmoothTextureStereo(in samplerBuffer s, in float stdDeviation, in float index) {
+	if (stdDeviation == 0.f)
+		return textureStereo(s, index);
+
+	const float coef = 0.5f/(stdDeviation*stdDeviation);
+	const float stepSize = 1.f/textureSize(s);
+
+	vec2 val = textureStereo(s, index);
+	for (float i = stepSize; i < 3*stdDeviation; i += stepSize) {
+		const float weight = exp(-coef*i*i);
+		val += weight*(textureStereo(s, index+i)+textureStereo(s, index-i));
+	}
+
+	return stepSize*val / (stdDeviation*sqrt(2*3.14159265359));
+}
+
+// the left channel in x and the right channel in y of the spectrumImage, linearly interpolated
+vec2 textureSpectrum(in sampler1D s, in float index) {
+	return textureLod(s, index, 0.f).rg;
+}
+
+// approximates kernelSmoothTexture with the mip levels of the spectrumImage, sampling the level
+// whose texels span about 2.5 standard deviations
+vec2 blurSpectrum(in sampler1D s, in float stdDeviation, in float index) {
+	const float lod = log2(max(2.5f*stdDeviation*textureSize(s, 0), 1.f));
+	return textureLod(s, index, lod).rg;
+}
+
 float mcatSmoothTexture(in samplerBuffer s, in float smoothingAmount, in float index) {
 	if (smoothingAmount == 0.f)
 		return texture(s, index);
@@ -44,3 +81,5 @@ float mcatSmoothTexture(in samplerBuffer s, in float smoothingAmount, in float i
 
 	return val;
 }
+
+#endif
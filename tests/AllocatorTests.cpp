@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "Allocator.hpp"
+
+TEST(testAllocator, alignment) {
+	BlockAllocator allocator(1024);
+
+	EXPECT_EQ(allocator.allocate(10, 1, true), 0);
+	EXPECT_EQ(allocator.allocate(10, 16, true), 16);
+	EXPECT_EQ(allocator.allocate(100, 256, true), 256);
+	EXPECT_EQ(allocator.used(), 120);
+	EXPECT_EQ(allocator.count(), 3);
+
+	// does not fit after the last allocation, and the gaps before it are too small
+	EXPECT_FALSE(allocator.allocate(700, 1, true));
+	EXPECT_EQ(allocator.allocate(668, 1, true), 356);
+}
+
+TEST(testAllocator, freeList) {
+	BlockAllocator allocator(1024);
+	ASSERT_EQ(allocator.allocate(256, 1, true), 0);
+	ASSERT_EQ(allocator.allocate(256, 1, true), 256);
+	ASSERT_EQ(allocator.allocate(512, 1, true), 512);
+	EXPECT_FALSE(allocator.allocate(1, 1, true));
+
+	// freed gaps are reused first fit, and neighbouring gaps merge
+	allocator.free(256);
+	EXPECT_EQ(allocator.allocate(128, 1, true), 256);
+	allocator.free(0);
+	allocator.free(256);
+	EXPECT_EQ(allocator.allocate(512, 1, true), 0);
+
+	allocator.free(0);
+	allocator.free(512);
+	EXPECT_TRUE(allocator.empty());
+	EXPECT_EQ(allocator.used(), 0);
+	EXPECT_EQ(allocator.allocate(1024, 1024, false), 0);
+}
+
+TEST(testAllocator, linear) {
+	BlockAllocator allocator(1024, 1, BlockAllocator::Strategy::linear);
+	ASSERT_EQ(allocator.allocate(256, 1, true), 0);
+	ASSERT_EQ(allocator.allocate(256, 1, true), 256);
+
+	// the gap left by the first allocation is not reused
+	allocator.free(0);
+	EXPECT_EQ(allocator.allocate(256, 1, true), 512);
+	EXPECT_FALSE(allocator.allocate(512, 1, true));
+
+	// the block is reused from the start once every allocation is freed
+	allocator.free(256);
+	allocator.free(512);
+	EXPECT_EQ(allocator.allocate(1024, 1, true), 0);
+}
+
+TEST(testAllocator, granularity) {
+	BlockAllocator allocator(4096, 1024);
+
+	// a buffer followed by an image starts the image on the next page
+	ASSERT_EQ(allocator.allocate(100, 4, true), 0);
+	EXPECT_EQ(allocator.allocate(100, 4, false), 1024);
+	// resources of the same kind may share a page
+	EXPECT_EQ(allocator.allocate(100, 4, false), 1124);
+
+	// a buffer may not end on the page of the image that follows it
+	allocator.free(0);
+	allocator.free(1024);
+	EXPECT_EQ(allocator.allocate(1100, 4, true), 2048);
+	EXPECT_EQ(allocator.allocate(1100, 4, false), 0);
+}
+
+TEST(testAllocator, invalid) {
+	EXPECT_THROW(BlockAllocator(1024, 3), std::invalid_argument);
+
+	BlockAllocator allocator(1024);
+	EXPECT_THROW(allocator.allocate(0, 1, true), std::invalid_argument);
+	EXPECT_THROW(allocator.allocate(16, 24, true), std::invalid_argument);
+	EXPECT_FALSE(allocator.allocate(2048, 1, true));
+
+	ASSERT_EQ(allocator.allocate(16, 1, true), 0);
+	EXPECT_THROW(allocator.free(8), std::invalid_argument);
+}
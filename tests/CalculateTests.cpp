@@ -75,3 +75,93 @@ TEST(testCalculate, errors) {
 	EXPECT_ANY_THROW(calculate<float>("4^"));
 	EXPECT_ANY_THROW(calculate<float>("sin()"));
 }
+
+TEST(testCalculate, variables) {
+	const std::unordered_map<std::string, float> variables = {{"width", 800},
+	                                                          {"height", 600},
+	                                                          {"bar_width", 4}};
+	EXPECT_FLOAT_EQ(calculate<float>("width/2", variables), 400);
+	EXPECT_FLOAT_EQ(calculate<float>("max(width, height) - bar_width", variables), 796);
+	EXPECT_FLOAT_EQ(calculate<float>("height*pi", variables), 600 * M_PI);
+	EXPECT_THROW(calculate<float>("depth", variables), std::invalid_argument);
+}
+
+TEST(testCalculate, negation) {
+	const std::unordered_map<std::string, float> variables = {{"width", 800}};
+	EXPECT_FLOAT_EQ(calculate<float>("-width", variables), -800);
+	EXPECT_FLOAT_EQ(calculate<float>("2*-width", variables), -1600);
+	EXPECT_FLOAT_EQ(calculate<float>("-(1+2)*3"), -9);
+	EXPECT_FLOAT_EQ(calculate<float>("(1+2)-1"), 2);
+	EXPECT_FLOAT_EQ(calculate<float>("width-1", variables), 799);
+}
+
+TEST(testExpression, variables) {
+	Expression expression("time*0.1 + volume", {"time", "volume"});
+	EXPECT_FALSE(expression.constant());
+
+	float values[] = {10, 0.5};
+	EXPECT_FLOAT_EQ(expression.evaluate(values), 1.5);
+	values[0] = 20;
+	EXPECT_FLOAT_EQ(expression.evaluate(values), 2.5);
+
+	Expression functions("max(sin(a), cos(b)) ^ 2", {"a", "b"});
+	float angles[] = {0, 0};
+	EXPECT_FLOAT_EQ(functions.evaluate(angles), 1);
+}
+
+TEST(testExpression, constantFolding) {
+	Expression constant("2*pi*(3 + 1)");
+	EXPECT_TRUE(constant.constant());
+	EXPECT_EQ(constant.size(), 1);
+	EXPECT_FLOAT_EQ(constant.evaluate(), 8 * M_PI);
+
+	// x*(2*pi) keeps only the variable, the folded constant and the multiplication
+	Expression partial("x*(2*pi)", {"x"});
+	EXPECT_EQ(partial.size(), 3);
+	float x = 1;
+	EXPECT_FLOAT_EQ(partial.evaluate(&x), 2 * M_PI);
+}
+
+TEST(testExpression, errors) {
+	EXPECT_THROW(Expression("time*2"), std::invalid_argument);
+	EXPECT_THROW(Expression("time*", {"time"}), std::invalid_argument);
+	EXPECT_THROW(Expression(""), std::invalid_argument);
+	EXPECT_THROW(Expression("min(1, 2, 3)"), std::invalid_argument);
+	EXPECT_THROW(Expression("(1"), std::invalid_argument);
+}
+
+TEST(testCalculate, moreFunctions) {
+	EXPECT_FLOAT_EQ(calculate<float>("log(e)"), 1);
+	EXPECT_FLOAT_EQ(calculate<float>("log10(1000)"), 3);
+	EXPECT_FLOAT_EQ(calculate<float>("exp(2)"), std::exp(2));
+	EXPECT_FLOAT_EQ(calculate<float>("sqrt(16)"), 4);
+	EXPECT_FLOAT_EQ(calculate<float>("abs(-3)"), 3);
+}
+
+TEST(testExpression, batch) {
+	Expression expression("1 + 0.5*log10(1 + f/100) - n%3 + max(n, 2)^2", {"n", "f"});
+
+	// not a multiple of the lane count so that the last block is partial
+	constexpr size_t count = 2 * Expression::laneCount + 3;
+	std::vector<float> n(count);
+	std::vector<float> f(count);
+	for (size_t i = 0; i < count; ++i) {
+		n[i] = static_cast<float>(i);
+		f[i] = 43.f * i;
+	}
+
+	const float* variables[] = {n.data(), f.data()};
+	std::vector<float> results(count + 1, -1.f);
+	expression.evaluate(variables, results.data(), count);
+
+	for (size_t i = 0; i < count; ++i) {
+		const float values[] = {n[i], f[i]};
+		EXPECT_FLOAT_EQ(results[i], expression.evaluate(values));
+	}
+	// nothing is written past the end
+	EXPECT_FLOAT_EQ(results[count], -1.f);
+
+	Expression constant("2*3");
+	constant.evaluate(nullptr, results.data(), count);
+	EXPECT_FLOAT_EQ(results[count - 1], 6);
+}
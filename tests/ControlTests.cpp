@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "Control.hpp"
+
+TEST(testControl, parseModules) {
+	auto command = parseControlCommand("modules {\"bars\", \"octahedron 2\"}");
+	EXPECT_EQ(command.type, ControlCommand::Type::modules);
+	ASSERT_EQ(command.modules.size(), 2);
+	EXPECT_EQ(command.modules[0], "bars");
+	EXPECT_EQ(command.modules[1], "octahedron 2");
+
+	command = parseControlCommand("modules radial");
+	ASSERT_EQ(command.modules.size(), 1);
+	EXPECT_EQ(command.modules[0], "radial");
+}
+
+TEST(testControl, parseSet) {
+	auto command = parseControlCommand("set \"octahedron 2\" amplitude 2*0.5");
+	EXPECT_EQ(command.type, ControlCommand::Type::set);
+	EXPECT_EQ(command.module, "octahedron 2");
+	EXPECT_EQ(command.parameter, "amplitude");
+	EXPECT_FLOAT_EQ(command.value, 1.f);
+
+	command = parseControlCommand("  set bars red 0.25  ");
+	EXPECT_EQ(command.module, "bars");
+	EXPECT_EQ(command.parameter, "red");
+	EXPECT_FLOAT_EQ(command.value, 0.25f);
+}
+
+TEST(testControl, parseSettings) {
+	auto command = parseControlCommand("amplitude 0.4");
+	EXPECT_EQ(command.type, ControlCommand::Type::amplitude);
+	EXPECT_FLOAT_EQ(command.value, 0.4f);
+
+	command = parseControlCommand("smoothingLevel 16");
+	EXPECT_EQ(command.type, ControlCommand::Type::smoothingLevel);
+	EXPECT_FLOAT_EQ(command.value, 16.f);
+
+	EXPECT_EQ(parseControlCommand("stats").type, ControlCommand::Type::stats);
+}
+
+TEST(testControl, parseInvalid) {
+	EXPECT_THROW(parseControlCommand("restart"), std::invalid_argument);
+	EXPECT_THROW(parseControlCommand("set bars"), std::invalid_argument);
+	EXPECT_THROW(parseControlCommand("modules"), std::invalid_argument);
+	EXPECT_THROW(parseControlCommand("set \"bars red 1"), std::invalid_argument);
+}
+
+TEST(testControl, socketInUse) {
+	if (!ControlServer::supported()) GTEST_SKIP() << "control sockets are unsupported";
+
+	const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+	ControlServer::Settings settings = {};
+	settings.socketPath =
+	    std::filesystem::temp_directory_path() / ("vkavTestControl" + std::to_string(now));
+
+	{
+		ControlServer server(settings);
+		// a second instance must not take the socket away from a running one
+		EXPECT_THROW(ControlServer{settings}, std::runtime_error);
+		EXPECT_TRUE(std::filesystem::exists(settings.socketPath));
+	}
+	EXPECT_FALSE(std::filesystem::exists(settings.socketPath));
+
+	ControlServer server(settings);
+	EXPECT_TRUE(std::filesystem::exists(settings.socketPath));
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Fusion.hpp"
+
+class testFusion : public ::testing::Test {
+protected:
+	std::filesystem::path dir;
+
+	void SetUp() override {
+		dir = std::filesystem::temp_directory_path() / "vkav-fusion-test";
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directories(dir / "a");
+		std::filesystem::create_directories(dir / "b");
+
+		std::ofstream(dir / "a" / "shader.frag") << "#version 450\n"
+		                                            "#include \"../common.glsl\"\n"
+		                                            "layout(constant_id = 0) const int audioSize = 1;\n"
+		                                            "layout(constant_id = 11) const float red = 1;\n"
+		                                            "void main() { outColor = vec4(red); }\n";
+		std::ofstream(dir / "b" / "shader.frag") << "#version 450\n"
+		                                            "layout(constant_id=11) const float red = 1;\n"
+		                                            "void draw() { outColor = vec4(red); }\n";
+	}
+
+	void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+TEST_F(testFusion, generate) {
+	FusedModule a;
+	a.fragmentShader = dir / "a" / "shader.frag";
+	a.parameterNames = {"red"};
+
+	FusedModule b;
+	b.fragmentShader = dir / "b" / "shader.frag";
+	b.entryPoint = "draw";
+	b.parameterNames = {"red"};
+	b.constantIdOffset = 1;
+
+	const auto shader = generateFusedShader({a, b});
+
+	// a single version directive at the top
+	EXPECT_EQ(shader.find("#version 450"), 0);
+	EXPECT_EQ(shader.find("#version", 1), std::string::npos);
+
+	// entry points and parameters are renamed
+	EXPECT_NE(shader.find("#define main vkav_module0_entry"), std::string::npos);
+	EXPECT_NE(shader.find("#define draw vkav_module1_entry"), std::string::npos);
+	EXPECT_NE(shader.find("#define red vkav_module0_red"), std::string::npos);
+	EXPECT_NE(shader.find("#define red vkav_module1_red"), std::string::npos);
+
+	// module constant ids are offset while the shared ones are kept
+	EXPECT_NE(shader.find("layout(constant_id = 0) const int audioSize = 1;"), std::string::npos);
+	EXPECT_NE(shader.find("layout(constant_id = 11) const float red"), std::string::npos);
+	EXPECT_NE(shader.find("layout(constant_id = 12) const float red"), std::string::npos);
+
+	// includes are made absolute
+	const auto include = (std::filesystem::absolute(dir / "a") / "../common.glsl").generic_string();
+	const auto includeLine = shader.find("#include \"" + include + "\"");
+	ASSERT_NE(includeLine, std::string::npos);
+
+	// without the renames of the including module
+	const auto undefine = shader.rfind("#undef red\n", includeLine);
+	ASSERT_NE(undefine, std::string::npos);
+	EXPECT_GT(undefine, shader.find("#define red vkav_module0_red"));
+	EXPECT_NE(shader.find("#define red vkav_module0_red\n#line 3\n", includeLine),
+	          std::string::npos);
+
+	EXPECT_NE(shader.find("vkav_module0_entry();"), std::string::npos);
+	EXPECT_NE(shader.find("vkav_module1_entry();"), std::string::npos);
+	EXPECT_LT(shader.find("vkav_module0_entry();"), shader.find("vkav_module1_entry();"));
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "Governor.hpp"
+
+namespace {
+	Governor::Settings settings() {
+		Governor::Settings governorSettings;
+		governorSettings.frameBudget = 10.0;
+		governorSettings.levels = 3;
+		governorSettings.window = 4;
+		governorSettings.headroom = 0.5;
+		governorSettings.stepUpWindows = 2;
+		governorSettings.maxStepUpWindows = 8;
+		return governorSettings;
+	}
+
+	/**
+	 * Adds windows of frames taking frameTime, returns the number of level changes
+	 */
+	int addWindows(Governor& governor, int windows, double frameTime) {
+		int changes = 0;
+		for (int frame = 0; frame < 4 * windows; ++frame) changes += governor.addFrame(frameTime);
+		return changes;
+	}
+}  // namespace
+
+TEST(testGovernor, withinBudget) {
+	Governor governor(settings());
+	EXPECT_EQ(addWindows(governor, 10, 7.0), 0);
+	EXPECT_EQ(governor.level(), 0);
+	EXPECT_FLOAT_EQ(governor.quality(), 1.f);
+	EXPECT_DOUBLE_EQ(governor.average(), 7.0);
+}
+
+TEST(testGovernor, stepsDown) {
+	Governor governor(settings());
+
+	// a single slow frame does not exceed the average
+	for (int frame = 0; frame < 3; ++frame) EXPECT_FALSE(governor.addFrame(5.0));
+	EXPECT_FALSE(governor.addFrame(20.0));
+	EXPECT_EQ(governor.level(), 0);
+
+	EXPECT_EQ(addWindows(governor, 1, 20.0), 1);
+	EXPECT_EQ(governor.level(), 1);
+	EXPECT_FLOAT_EQ(governor.quality(), 0.5f);
+
+	// the window after a change is skipped, then every slow window steps down until the lowest
+	EXPECT_EQ(addWindows(governor, 1, 20.0), 0);
+	EXPECT_EQ(addWindows(governor, 10, 20.0), 2);
+	EXPECT_EQ(governor.level(), 3);
+	EXPECT_FLOAT_EQ(governor.quality(), 0.125f);
+}
+
+TEST(testGovernor, hysteresis) {
+	Governor governor(settings());
+	addWindows(governor, 1, 20.0);
+	ASSERT_EQ(governor.level(), 1);
+	addWindows(governor, 1, 20.0);
+
+	// between the headroom and the budget nothing changes
+	EXPECT_EQ(addWindows(governor, 10, 8.0), 0);
+
+	// two windows with headroom in a row step up
+	EXPECT_EQ(addWindows(governor, 1, 2.0), 0);
+	EXPECT_EQ(addWindows(governor, 1, 8.0), 0);
+	EXPECT_EQ(addWindows(governor, 1, 2.0), 0);
+	EXPECT_EQ(addWindows(governor, 1, 2.0), 1);
+	EXPECT_EQ(governor.level(), 0);
+}
+
+TEST(testGovernor, backoff) {
+	Governor governor(settings());
+	addWindows(governor, 2, 20.0);
+	ASSERT_EQ(governor.level(), 1);
+
+	// stepping up is undone straight away, so the next step up waits twice as long
+	addWindows(governor, 2, 2.0);
+	ASSERT_EQ(governor.level(), 0);
+	addWindows(governor, 1, 2.0);
+	EXPECT_EQ(addWindows(governor, 1, 20.0), 1);
+	addWindows(governor, 1, 20.0);
+
+	EXPECT_EQ(addWindows(governor, 3, 2.0), 0);
+	EXPECT_EQ(addWindows(governor, 1, 2.0), 1);
+	EXPECT_EQ(governor.level(), 0);
+}
+
+TEST(testGovernor, invalidSettings) {
+	auto governorSettings = settings();
+	governorSettings.frameBudget = 0.0;
+	EXPECT_THROW(Governor{governorSettings}, std::invalid_argument);
+
+	governorSettings = settings();
+	governorSettings.window = 0;
+	EXPECT_THROW(Governor{governorSettings}, std::invalid_argument);
+
+	governorSettings = settings();
+	governorSettings.headroom = 1.0;
+	EXPECT_THROW(Governor{governorSettings}, std::invalid_argument);
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Half.hpp"
+
+TEST(testHalf, packHalf2) {
+	// odd count so that both the vector loop and the remainder are used
+	constexpr size_t count = 1003;
+	std::vector<float> first(count), second(count);
+	for (size_t i = 0; i < count; ++i) {
+		// spans subnormals, ties and values too large for a half
+		first[i] = std::ldexp(1.f + i / 2048.f, static_cast<int>(i % 48) - 30);
+		second[i] = -first[i] / 3.f;
+	}
+	first[1] = 0.f;
+	second[2] = INFINITY;
+
+	std::vector<uint32_t> packed(count);
+	packHalf2(first.data(), second.data(), packed.data(), count);
+
+	for (size_t i = 0; i < count; ++i) {
+		ASSERT_EQ(packed[i] & 0xffff, floatToHalf(first[i])) << i;
+		ASSERT_EQ(packed[i] >> 16, floatToHalf(second[i])) << i;
+	}
+}
+
+TEST(testHalf, packHalf2Empty) {
+	uint32_t packed = 0xdeadbeef;
+	packHalf2(nullptr, nullptr, &packed, 0);
+	EXPECT_EQ(packed, 0xdeadbeef);
+}
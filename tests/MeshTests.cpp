@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+#include "Mesh.hpp"
+
+TEST(testMesh, triangle) {
+	std::stringstream obj(
+	    "# comment\n"
+	    "v 0 0 0\n"
+	    "v 1 0 0\n"
+	    "v 0 1 0\n"
+	    "f 1 2 3\n");
+	auto mesh = parseObj(obj);
+
+	ASSERT_EQ(mesh.vertices.size(), 3);
+	ASSERT_EQ(mesh.indices.size(), 3);
+	EXPECT_EQ(mesh.indices[0], 0);
+	EXPECT_EQ(mesh.indices[1], 1);
+	EXPECT_EQ(mesh.indices[2], 2);
+	EXPECT_FLOAT_EQ(mesh.vertices[1].position[0], 1.f);
+
+	// generated from the counter clockwise winding
+	for (const auto& vertex : mesh.vertices) {
+		EXPECT_FLOAT_EQ(vertex.normal[0], 0.f);
+		EXPECT_FLOAT_EQ(vertex.normal[1], 0.f);
+		EXPECT_FLOAT_EQ(vertex.normal[2], 1.f);
+	}
+}
+
+TEST(testMesh, quad) {
+	std::stringstream obj(
+	    "v 0 0 0\n"
+	    "v 1 0 0\n"
+	    "v 1 1 0\n"
+	    "v 0 1 0\n"
+	    "vt 0 0\n"
+	    "vn 0 0 -1\n"
+	    "o quad\n"
+	    "f 1/1/1 2/1/1 3/1/1 -1//1\n");
+	auto mesh = parseObj(obj);
+
+	// split into a fan of two triangles sharing vertices
+	ASSERT_EQ(mesh.vertices.size(), 4);
+	ASSERT_EQ(mesh.indices.size(), 6);
+	EXPECT_EQ(mesh.indices[3], 0);
+	EXPECT_EQ(mesh.indices[4], 2);
+	EXPECT_EQ(mesh.indices[5], 3);
+	EXPECT_FLOAT_EQ(mesh.vertices[3].position[1], 1.f);
+	EXPECT_FLOAT_EQ(mesh.vertices[3].normal[2], -1.f);
+}
+
+TEST(testMesh, sharedPositions) {
+	// the same position with different normals needs separate vertices
+	std::stringstream obj(
+	    "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 0 1\n"
+	    "vn 0 0 1\nvn 0 1 0\n"
+	    "f 1//1 2//1 3//1\n"
+	    "f 1//2 4//2 2//2\n");
+	auto mesh = parseObj(obj);
+
+	EXPECT_EQ(mesh.vertices.size(), 6);
+	EXPECT_EQ(mesh.indices.size(), 6);
+}
+
+TEST(testMesh, invalidObj) {
+	std::stringstream outOfRange("v 0 0 0\nv 1 0 0\nf 1 2 3\n");
+	EXPECT_THROW(parseObj(outOfRange), std::invalid_argument);
+
+	std::stringstream line("v 0 0 0\nv 1 0 0\nf 1 2\n");
+	EXPECT_THROW(parseObj(line), std::invalid_argument);
+
+	std::stringstream coordinates("v 0 0\n");
+	EXPECT_THROW(parseObj(coordinates), std::invalid_argument);
+
+	std::stringstream normal("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1//1 2//1 3//1\n");
+	EXPECT_THROW(parseObj(normal), std::invalid_argument);
+}
+
+TEST(testMesh, binary) {
+	std::stringstream obj("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3 4\n");
+	auto mesh = parseObj(obj);
+
+	std::stringstream binary;
+	writeMesh(binary, mesh);
+	auto loaded = readMesh(binary);
+
+	ASSERT_EQ(loaded.vertices.size(), mesh.vertices.size());
+	ASSERT_EQ(loaded.indices, mesh.indices);
+	for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+		EXPECT_EQ(loaded.vertices[i].position, mesh.vertices[i].position);
+		EXPECT_EQ(loaded.vertices[i].normal, mesh.vertices[i].normal);
+	}
+}
+
+TEST(testMesh, invalidBinary) {
+	std::stringstream garbage("not a mesh at all");
+	EXPECT_THROW(readMesh(garbage), std::invalid_argument);
+
+	Mesh mesh;
+	mesh.vertices.resize(2);
+	mesh.indices = {0, 1, 2};
+	std::stringstream outOfRange;
+	writeMesh(outOfRange, mesh);
+	EXPECT_THROW(readMesh(outOfRange), std::invalid_argument);
+
+	mesh.vertices.resize(3);
+	std::stringstream truncated;
+	writeMesh(truncated, mesh);
+	auto data = truncated.str();
+	std::stringstream cut(data.substr(0, data.size() - 4));
+	EXPECT_THROW(readMesh(cut), std::invalid_argument);
+
+	// a vertex count far beyond the data is rejected before anything is allocated
+	data.replace(12, sizeof(uint32_t), "\xff\xff\xff\xff");
+	std::stringstream huge(data);
+	EXPECT_THROW(readMesh(huge), std::invalid_argument);
+}
@@ -1,3 +1,6 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <sstream>
 
 #include <gtest/gtest.h>
@@ -42,3 +45,270 @@ TEST(testParse, basic) {
 	ASSERT_EQ(config.params[1].value.index(), 2);
 	EXPECT_EQ(std::get<2>(config.params[1].value), 3.f);
 }
+
+TEST(testParse, dynamicParameters) {
+	std::stringstream stream{
+		"parameterBinding = 2\n"
+		"[parameters]\n"
+		"(id=11) dynamic float amplitude = 2\n"
+		"(id=12) int barWidth = 4\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.parameterBinding);
+	EXPECT_EQ(config.parameterBinding.value(), 2);
+
+	ASSERT_EQ(config.params.size(), 2);
+
+	EXPECT_EQ(config.params[0].name, "amplitude");
+	EXPECT_TRUE(config.params[0].dynamic);
+	ASSERT_EQ(config.params[0].value.index(), 2);
+	EXPECT_EQ(std::get<2>(config.params[0].value), 2.f);
+
+	EXPECT_EQ(config.params[1].name, "barWidth");
+	EXPECT_FALSE(config.params[1].dynamic);
+}
+
+TEST(testParse, dynamicResource) {
+	std::stringstream stream{
+		"[resources]\n"
+		"(id=0) dynamic image logo = \"logo.png\"\n"
+	};
+
+	EXPECT_THROW(parseConfig(stream), ParseException);
+}
+
+TEST(testParse, globalSettings) {
+	std::stringstream stream{
+		"module = draw\n"
+		"fusable = true\n"
+		"packedSpectrum = true\n"
+		"spectrumImage = true\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.moduleName);
+	EXPECT_EQ(config.moduleName.value(), "draw");
+	EXPECT_TRUE(config.fusable);
+	EXPECT_TRUE(config.packedSpectrum);
+	EXPECT_TRUE(config.spectrumImage);
+}
+
+TEST(testParse, bounds) {
+	std::stringstream stream{
+		"bounds = {0, height - height/4, width, max(height/4, 16)}\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.bounds);
+	EXPECT_EQ((*config.bounds)[0], "0");
+	EXPECT_EQ((*config.bounds)[1], "height - height/4");
+	EXPECT_EQ((*config.bounds)[2], "width");
+	EXPECT_EQ((*config.bounds)[3], "max(height/4, 16)");
+}
+
+TEST(testParse, invalidBounds) {
+	std::stringstream missing{"bounds = {0, 0, width}\n"};
+	EXPECT_THROW(parseConfig(missing), ParseException);
+
+	std::stringstream unknown{"bounds = {0, 0, depth, height}\n"};
+	EXPECT_THROW(parseConfig(unknown), ParseException);
+}
+
+TEST(testParse, instanceCount) {
+	std::stringstream stream{"instanceCount = width/6\n"};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.instanceCount);
+	EXPECT_EQ(config.instanceCount.value(), "width/6");
+
+	std::stringstream invalid{"instanceCount = bars/6\n"};
+	EXPECT_THROW(parseConfig(invalid), ParseException);
+
+	// parameters may be declared after the instance count, as long as they are not dynamic
+	std::stringstream parameters{
+		"instanceCount = width/(barWidth + barGap)\n"
+		"[parameters]\n"
+		"(id=11) int barWidth = 4\n"
+		"(id=12) float barGap = 2\n"
+	};
+	config = parseConfig(parameters);
+	EXPECT_EQ(config.instanceCount.value(), "width/(barWidth + barGap)");
+
+	std::stringstream dynamic{
+		"instanceCount = width/barWidth\n"
+		"[parameters]\n"
+		"(id=11) dynamic int barWidth = 4\n"
+	};
+	EXPECT_THROW(parseConfig(dynamic), ParseException);
+}
+
+TEST(testParse, computeResources) {
+	std::stringstream stream{
+		"workGroups = {1024/64, 1, 1}\n"
+		"[resources]\n"
+		"(id=0) storageBuffer particles = 1024*16\n"
+		"(id=1) storageImage field = {256, 128}\n"
+		"(id=2) storageImage trails = {width/2, height/2}\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_TRUE(config.workGroups);
+	EXPECT_EQ((*config.workGroups)[0], "1024/64");
+
+	ASSERT_EQ(config.storageBuffers.size(), 1);
+	EXPECT_EQ(config.storageBuffers[0].id, 0);
+	EXPECT_EQ(config.storageBuffers[0].size, 1024 * 16);
+
+	ASSERT_EQ(config.storageImages.size(), 2);
+	EXPECT_EQ(config.storageImages[0].id, 1);
+	EXPECT_EQ(config.storageImages[0].size[0], "256");
+	EXPECT_EQ(config.storageImages[0].size[1], "128");
+	EXPECT_EQ(config.storageImages[1].size[0], "width/2");
+	EXPECT_EQ(config.storageImages[1].size[1], "height/2");
+
+	std::stringstream invalid{"[resources]\n(id=1) storageImage field = {width, depth}\n"};
+	EXPECT_THROW(parseConfig(invalid), ParseException);
+}
+
+TEST(testParse, renderTargets) {
+	std::stringstream stream{
+		"layer.1 = -> scene\n"
+		"layer.2 = scene -> blur\n"
+		"layer.3 = scene, blur -> window\n"
+		"[resources]\n"
+		"(id=1) target scene = {width, height}\n"
+		"(id=2) target blur = {width/2, height/2}\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_EQ(config.targets.size(), 2);
+	EXPECT_EQ(config.targets[1].id, 2);
+	EXPECT_EQ(config.targets[1].name, "blur");
+	EXPECT_EQ(config.targets[1].size[0], "width/2");
+
+	ASSERT_EQ(config.layers.size(), 3);
+	EXPECT_EQ(config.layers[0].layer, 1);
+	EXPECT_TRUE(config.layers[0].inputs.empty());
+	EXPECT_EQ(config.layers[0].output, "scene");
+	EXPECT_EQ(config.layers[1].inputs, std::vector<std::string>{"scene"});
+	EXPECT_EQ(config.layers[2].inputs, (std::vector<std::string>{"scene", "blur"}));
+	EXPECT_TRUE(config.layers[2].output.empty());
+
+	std::stringstream invalid{"layer.1 = scene\n"};
+	EXPECT_THROW(parseConfig(invalid), ParseException);
+}
+
+TEST(testParse, meshes) {
+	std::stringstream stream{
+		"layer.1 = model -> window\n"
+		"[resources]\n"
+		"(id=0) mesh model = \"model.obj\"\n"
+		"(id=1) mesh other = \"meshes/other model.mesh\" # comment\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_EQ(config.meshes.size(), 2);
+	EXPECT_EQ(config.meshes[0].id, 0);
+	EXPECT_EQ(config.meshes[0].name, "model");
+	EXPECT_EQ(config.meshes[0].path, "model.obj");
+	EXPECT_EQ(config.meshes[1].path, "meshes/other model.mesh");
+	EXPECT_EQ(config.layers[0].inputs, std::vector<std::string>{"model"});
+}
+
+TEST(testParse, tables) {
+	std::stringstream stream{
+		"[resources]\n"
+		"(id=0) buffer weights = {0.25, 0.5, 1/4}\n"
+		"(id=1) lut gradient = {0, 0, 0, 1,  1, 0.5, 0, 1}\n"
+		"(id=2) lut palette = \"palette.lut\" # comment\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_EQ(config.buffers.size(), 1);
+	EXPECT_EQ(config.buffers[0].id, 0);
+	EXPECT_EQ(config.buffers[0].values, (std::vector<float>{0.25f, 0.5f, 0.25f}));
+	EXPECT_TRUE(config.buffers[0].path.empty());
+
+	ASSERT_EQ(config.luts.size(), 2);
+	EXPECT_EQ(config.luts[0].values.size(), 8);
+	EXPECT_FLOAT_EQ(config.luts[0].values[5], 0.5f);
+	EXPECT_TRUE(config.luts[1].values.empty());
+	EXPECT_EQ(config.luts[1].path, "palette.lut");
+
+	std::stringstream texels{"[resources]\n(id=0) lut gradient = {0, 0, 0}\n"};
+	EXPECT_THROW(parseConfig(texels), ParseException);
+
+	std::stringstream empty{"[resources]\n(id=0) buffer weights = {}\n"};
+	EXPECT_THROW(parseConfig(empty), ParseException);
+
+	std::stringstream invalid{"[resources]\n(id=0) buffer weights = {1, a}\n"};
+	EXPECT_THROW(parseConfig(invalid), ParseException);
+}
+
+TEST(testParse, values) {
+	std::stringstream stream{
+		"# red to blue\n"
+		"1, 0, 0, 1,\n"
+		"0,0,1,1, # comment\n"
+		"\n"
+		"1 / 2, 2 * 3\n"
+	};
+
+	EXPECT_EQ(parseValues(stream), (std::vector<float>{1, 0, 0, 1, 0, 0, 1, 1, 0.5f, 6}));
+
+	std::stringstream invalid{"1, 2 three"};
+	EXPECT_THROW(parseValues(invalid), std::invalid_argument);
+
+	std::stringstream empty{"1, , 2"};
+	EXPECT_THROW(parseValues(empty), std::invalid_argument);
+}
+
+TEST(testParse, parameterExpressions) {
+	std::stringstream stream{
+		"[parameters]\n"
+		"(id=11) dynamic float rotation = time*0.1 + volume\n"
+		"(id=12) dynamic float constant = 2*pi\n"
+		"(id=13) float size = 1/2\n"
+	};
+
+	auto config = parseConfig(stream);
+
+	ASSERT_EQ(config.params.size(), 3);
+	EXPECT_EQ(config.params[0].expression, "time*0.1 + volume");
+	EXPECT_FLOAT_EQ(std::get<float>(config.params[0].value), 0.f);
+	EXPECT_TRUE(config.params[1].expression.empty());
+	EXPECT_FLOAT_EQ(std::get<float>(config.params[1].value), 2 * M_PI);
+	EXPECT_FLOAT_EQ(std::get<float>(config.params[2].value), 0.5f);
+
+	// frame variables change every frame, so they cannot be used by specialization constants
+	std::stringstream constant{"[parameters]\n(id=11) float rotation = time*0.1\n"};
+	EXPECT_THROW(parseConfig(constant), ParseException);
+}
+
+TEST(testParse, initialParameterValues) {
+	std::stringstream stream{
+		"[parameters]\n"
+		"(id=11) dynamic int samples = 1 + 3*quality\n"
+		"(id=12) dynamic int taps = 64/volume\n"
+		"(id=13) dynamic int offset = -64/volume\n"
+	};
+
+	// evaluated like the renderer does before the first frame, integers saturate
+	auto config = parseConfig(stream);
+	ASSERT_EQ(config.params.size(), 3);
+	EXPECT_EQ(std::get<int32_t>(config.params[0].value), 4);
+	EXPECT_EQ(std::get<int32_t>(config.params[1].value), std::numeric_limits<int32_t>::max());
+	EXPECT_EQ(std::get<int32_t>(config.params[2].value), std::numeric_limits<int32_t>::min());
+
+	std::stringstream nan{"[parameters]\n(id=11) dynamic float ratio = low/mid\n"};
+	EXPECT_THROW(parseConfig(nan), ParseException);
+}
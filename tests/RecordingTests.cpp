@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "Data.hpp"
+#include "Recording.hpp"
+
+namespace {
+	constexpr size_t audioSize = 64;
+
+	std::filesystem::path recordingPath(const char* name) {
+		return std::filesystem::temp_directory_path() / name;
+	}
+
+	void fill(AudioData& audioData, float offset) {
+		for (size_t i = 0; i < audioSize; ++i) {
+			audioData.lBuffer[i] = offset + i;
+			audioData.rBuffer[i] = offset - i;
+		}
+		audioData.lVolume = offset;
+		audioData.rVolume = 2.f * offset;
+	}
+}  // namespace
+
+TEST(testRecording, roundTrip) {
+	const auto path = recordingPath("vkavRecordingRoundTrip");
+	AudioData audioData;
+	audioData.allocate(2, 2 * audioSize);
+	{
+		RecordingWriter writer(path, audioSize);
+		for (int record = 0; record < 3; ++record) {
+			fill(audioData, record);
+			writer.write(audioData, std::chrono::milliseconds(10 * record));
+		}
+	}
+
+	Recording recording(path);
+	ASSERT_EQ(recording.size(), 3);
+	EXPECT_EQ(recording.audioSize(), audioSize);
+	EXPECT_EQ(recording.timestamp(2), std::chrono::milliseconds(20));
+
+	AudioData replayed;
+	replayed.allocate(2, 2 * audioSize);
+	recording.copyRecord(1, replayed);
+	EXPECT_FLOAT_EQ(replayed.lVolume, 1.f);
+	EXPECT_FLOAT_EQ(replayed.rVolume, 2.f);
+	for (size_t i = 0; i < audioSize; ++i) {
+		EXPECT_EQ(replayed.lBuffer[i], 1.f + i);
+		EXPECT_EQ(replayed.rBuffer[i], 1.f - i);
+	}
+
+	EXPECT_THROW(recording.copyRecord(3, replayed), std::out_of_range);
+	std::filesystem::remove(path);
+}
+
+TEST(testRecording, find) {
+	const auto path = recordingPath("vkavRecordingFind");
+	AudioData audioData;
+	audioData.allocate(2, 2 * audioSize);
+	{
+		RecordingWriter writer(path, audioSize);
+		for (int record = 0; record < 5; ++record)
+			writer.write(audioData, std::chrono::milliseconds(10 * record));
+	}
+
+	Recording recording(path);
+	EXPECT_EQ(recording.find(std::chrono::milliseconds(0)), 0);
+	EXPECT_EQ(recording.find(std::chrono::milliseconds(9)), 0);
+	EXPECT_EQ(recording.find(std::chrono::milliseconds(10)), 1);
+	EXPECT_EQ(recording.find(std::chrono::milliseconds(35)), 3);
+	EXPECT_EQ(recording.find(std::chrono::seconds(1)), 4);
+	std::filesystem::remove(path);
+}
+
+TEST(testRecording, truncated) {
+	const auto path = recordingPath("vkavRecordingTruncated");
+	AudioData audioData;
+	audioData.allocate(2, 2 * audioSize);
+	{
+		RecordingWriter writer(path, audioSize);
+		writer.write(audioData, std::chrono::nanoseconds(0));
+		writer.write(audioData, std::chrono::nanoseconds(1));
+	}
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+
+	// the partially written record is dropped
+	Recording recording(path);
+	EXPECT_EQ(recording.size(), 1);
+
+	Recording moved = std::move(recording);
+	EXPECT_EQ(moved.size(), 1);
+	EXPECT_EQ(recording.size(), 0);
+	std::filesystem::remove(path);
+}
+
+TEST(testRecording, invalid) {
+	EXPECT_THROW(Recording(recordingPath("vkavRecordingMissing")), std::runtime_error);
+
+	const auto path = recordingPath("vkavRecordingInvalid");
+	std::ofstream(path) << "not a recording at all";
+	EXPECT_THROW(Recording{path}, std::runtime_error);
+
+	std::ofstream(path) << "short";
+	EXPECT_THROW(Recording{path}, std::runtime_error);
+	std::filesystem::remove(path);
+}
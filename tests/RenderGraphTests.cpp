@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "RenderGraph.hpp"
+
+TEST(testRenderGraph, windowOnly) {
+	auto graph = compileRenderGraph({{}, {}}, 0);
+
+	EXPECT_TRUE(graph.passes.empty());
+	ASSERT_EQ(graph.windowLayers.size(), 2);
+	EXPECT_EQ(graph.windowLayers[0], 0);
+	EXPECT_EQ(graph.windowLayers[1], 1);
+	EXPECT_EQ(graph.memoryBlockCount, 0);
+}
+
+TEST(testRenderGraph, separableBlur) {
+	// scene -> horizontal blur -> vertical blur -> composite onto the window
+	auto graph = compileRenderGraph({{{}, 0}, {{0}, 1}, {{1}, 2}, {{0, 2}, std::nullopt}}, 3);
+
+	ASSERT_EQ(graph.passes.size(), 3);
+	for (uint32_t pass = 0; pass < 3; ++pass) {
+		EXPECT_EQ(graph.passes[pass].layer, pass);
+		EXPECT_EQ(graph.passes[pass].target, pass);
+		EXPECT_TRUE(graph.passes[pass].clear);
+	}
+	ASSERT_EQ(graph.windowLayers.size(), 1);
+	EXPECT_EQ(graph.windowLayers[0], 3);
+
+	// the vertical blur reads the horizontal one while it is drawn and the scene is read by the
+	// composite, so no two targets are alive at disjoint times and none can share memory
+	EXPECT_EQ(graph.memoryBlockCount, 3);
+	EXPECT_NE(graph.memoryBlocks[0], graph.memoryBlocks[1]);
+	EXPECT_NE(graph.memoryBlocks[1], graph.memoryBlocks[2]);
+	EXPECT_NE(graph.memoryBlocks[0], graph.memoryBlocks[2]);
+}
+
+TEST(testRenderGraph, aliasing) {
+	// a -> b -> c -> window, a is free again by the time c is drawn
+	auto graph = compileRenderGraph({{{}, 0}, {{0}, 1}, {{1}, 2}, {{2}, std::nullopt}}, 3);
+
+	EXPECT_EQ(graph.memoryBlockCount, 2);
+	EXPECT_EQ(graph.memoryBlocks[0], graph.memoryBlocks[2]);
+	EXPECT_NE(graph.memoryBlocks[0], graph.memoryBlocks[1]);
+}
+
+TEST(testRenderGraph, repeatedTarget) {
+	auto graph = compileRenderGraph({{{}, 0}, {{}, 0}, {{0}, std::nullopt}}, 1);
+
+	ASSERT_EQ(graph.passes.size(), 2);
+	EXPECT_TRUE(graph.passes[0].clear);
+	EXPECT_FALSE(graph.passes[1].clear);
+}
+
+TEST(testRenderGraph, invalid) {
+	// sampled before it is drawn to
+	EXPECT_THROW(compileRenderGraph({{{0}, std::nullopt}, {{}, 0}}, 1), std::invalid_argument);
+	// sampling its own output
+	EXPECT_THROW(compileRenderGraph({{{}, 0}, {{0}, 0}}, 1), std::invalid_argument);
+	// unknown target
+	EXPECT_THROW(compileRenderGraph({{{}, 1}}, 1), std::invalid_argument);
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Data.hpp"
+#include "Process.hpp"
+#include "Render.hpp"
+
+/*
+ * Renders every module offscreen for a fixed number of frames at several resolutions, on the
+ * first suitable Vulkan device, and compares the GPU time of a frame against tests/renderBaseline.
+ * Times are only compared with those recorded on a device of the same name, cases without one
+ * are reported and the test is skipped. Run with VKAV_UPDATE_BASELINE=1 to write the measured
+ * times of the device to the baseline instead.
+ */
+
+namespace {
+	constexpr size_t warmupFrames = 16;
+	constexpr size_t measuredFrames = 128;
+
+	const std::vector<std::pair<uint32_t, uint32_t>> resolutions = {
+	    {640, 360}, {1280, 720}, {1920, 1080}};
+
+	// a frame may take this much longer than the baseline before the test fails
+	constexpr double relativeTolerance = 0.25;
+	// milliseconds, keeps very cheap modules from failing on timer noise
+	constexpr double absoluteTolerance = 0.05;
+
+	// ctest runs the test in the build directory
+	const std::filesystem::path modulePath = std::filesystem::path(VKAV_SOURCE_DIR) / "src";
+	const std::filesystem::path baselinePath =
+	    std::filesystem::path(VKAV_SOURCE_DIR) / "tests" / "renderBaseline";
+
+	constexpr size_t bufferSize = 2048;
+	constexpr unsigned char channels = 2;
+	constexpr uint32_t sampleRate = 5625;
+
+	// device, module, width and height
+	using Case = std::tuple<std::string, std::string, uint32_t, uint32_t>;
+
+	std::vector<std::string> findModules() {
+		std::vector<std::string> modules;
+		for (const auto& entry : std::filesystem::directory_iterator(modulePath / "modules"))
+			if (std::filesystem::exists(entry.path() / "1"))
+				modules.push_back(entry.path().filename().string());
+		std::sort(modules.begin(), modules.end());
+		return modules;
+	}
+
+	/**
+	 * Lines of the form "DEVICE" "MODULE" WIDTH HEIGHT MILLISECONDS, # starts a comment
+	 */
+	std::map<Case, double> readBaseline() {
+		std::map<Case, double> baseline;
+		std::ifstream file(baselinePath);
+		std::string lineStr;
+		while (std::getline(file, lineStr)) {
+			std::stringstream line(lineStr.substr(0, lineStr.find('#')));
+			std::string device, module;
+			uint32_t width, height;
+			double milliseconds;
+			if (line >> std::quoted(device) >> std::quoted(module) >> width >> height >>
+			    milliseconds)
+				baseline[{device, module, width, height}] = milliseconds;
+		}
+		return baseline;
+	}
+
+	void writeBaseline(const std::map<Case, double>& baseline) {
+		std::ofstream file(baselinePath);
+		file << "# GPU milliseconds per frame: \"DEVICE\" \"MODULE\" WIDTH HEIGHT MILLISECONDS\n"
+		        "# Record a device with VKAV_UPDATE_BASELINE=1 ctest -L performance\n";
+		for (const auto& [key, milliseconds] : baseline) {
+			const auto& [device, module, width, height] = key;
+			file << std::quoted(device) << ' ' << std::quoted(module) << ' ' << width << ' '
+			     << height << ' ' << milliseconds << '\n';
+		}
+	}
+
+	/**
+	 * Spectrum of a chord with a slowly moving fundamental, the same for every run
+	 */
+	class RecordedSpectrum {
+	public:
+		RecordedSpectrum() {
+			Process::Settings settings = {};
+			settings.size = bufferSize;
+			settings.channels = channels;
+			settings.smoothingLevel = 0.f;
+			settings.amplitude = 0.4f;
+			settings.sampleRate = sampleRate;
+			process = Process(settings);
+			audioData.allocate(channels, bufferSize);
+		}
+
+		const AudioData& frame(size_t index) {
+			const float fundamental = 110.f * (1.f + 0.5f * std::sin(0.05f * index));
+			for (size_t i = 0; i < bufferSize; ++i) {
+				const float t = static_cast<float>(i) / sampleRate;
+				for (size_t channel = 0; channel < channels; ++channel) {
+					float sample = 0.f;
+					for (float harmonic : {1.f, 2.f, 3.f, 5.f})
+						sample += std::sin(2.f * static_cast<float>(M_PI) * fundamental *
+						                   harmonic * (channel + 1) * t) /
+						          harmonic;
+					audioData.buffer[i * channels + channel] = 0.5f * sample;
+				}
+			}
+			process.processSignal(audioData);
+			return audioData;
+		}
+
+	private:
+		Process process;
+		AudioData audioData;
+	};
+
+	/**
+	 * Average GPU milliseconds per frame, or nullopt if the device cannot measure it
+	 */
+	std::optional<double> measure(const std::string& module, uint32_t width, uint32_t height,
+	                              RecordedSpectrum& spectrum, std::string& device) {
+		Renderer::Settings settings = {};
+		settings.headless = true;
+		settings.window.width = width;
+		settings.window.height = height;
+		settings.audioSize = bufferSize / 2;
+		settings.smoothingLevel = 16.f;
+		settings.moduleLocations = {modulePath};
+		settings.modules = {module};
+		settings.shaderCacheLocation =
+		    std::filesystem::temp_directory_path() / "vkavRenderPerformance";
+		settings.vsync = false;
+
+		Renderer renderer(settings);
+		device = renderer.deviceName();
+		for (size_t frame = 0; frame < warmupFrames; ++frame)
+			renderer.drawFrame(spectrum.frame(frame));
+		renderer.frameTime();
+
+		for (size_t frame = 0; frame < measuredFrames; ++frame)
+			renderer.drawFrame(spectrum.frame(warmupFrames + frame));
+		return renderer.frameTime();
+	}
+}  // namespace
+
+TEST(testRenderPerformance, modules) {
+	// e.g. a build machine without lavapipe, any failure once a device exists is an error
+	if (!Renderer::deviceAvailable()) GTEST_SKIP() << "no Vulkan device is available";
+
+	const bool updateBaseline = std::getenv("VKAV_UPDATE_BASELINE");
+	auto baseline = readBaseline();
+	RecordedSpectrum spectrum;
+	std::string device;
+	size_t unrecorded = 0;
+
+	for (const auto& module : findModules()) {
+		for (const auto& [width, height] : resolutions) {
+			SCOPED_TRACE(module + " at " + std::to_string(width) + "x" + std::to_string(height));
+
+			std::optional<double> milliseconds;
+			try {
+				milliseconds = measure(module, width, height, spectrum, device);
+			} catch (const std::exception& e) {
+				ADD_FAILURE() << e.what();
+				continue;
+			}
+			if (!milliseconds) GTEST_SKIP() << "timestamp queries are unsupported";
+
+			const Case key = {device, module, width, height};
+			auto expected = baseline.find(key);
+			std::cout << std::left << std::setw(20) << module << std::right << std::setw(5)
+			          << width << 'x' << std::left << std::setw(5) << height << std::right
+			          << std::fixed << std::setprecision(3) << std::setw(9) << *milliseconds
+			          << " ms";
+			if (expected != baseline.end())
+				std::cout << " (baseline " << expected->second << " ms)";
+			std::cout << std::endl;
+
+			if (updateBaseline) {
+				baseline[key] = *milliseconds;
+			} else if (expected == baseline.end()) {
+				++unrecorded;
+			} else {
+				EXPECT_LE(*milliseconds,
+				          expected->second * (1.0 + relativeTolerance) + absoluteTolerance);
+			}
+		}
+	}
+
+	if (updateBaseline) writeBaseline(baseline);
+	if (unrecorded > 0)
+		GTEST_SKIP() << unrecorded << " cases have no baseline for '" << device
+		             << "', record one with VKAV_UPDATE_BASELINE=1";
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ShaderCompiler.hpp"
+
+namespace {
+	void writeFile(const std::filesystem::path& path, const std::string& contents) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << contents;
+	}
+}  // namespace
+
+class testShaderCompiler : public ::testing::Test {
+protected:
+	std::filesystem::path dir;
+
+	void SetUp() override {
+		dir = std::filesystem::temp_directory_path() / "vkav-shader-compiler-test";
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directories(dir);
+	}
+
+	void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+TEST_F(testShaderCompiler, hashFollowsIncludes) {
+	writeFile(dir / "shader.frag", "#version 450\n#include \"common.glsl\"\nvoid main() {}\n");
+	writeFile(dir / "common.glsl", "float f() { return 1.0; }\n");
+
+	const auto first = hashShaderSource(dir / "shader.frag");
+	EXPECT_EQ(first, hashShaderSource(dir / "shader.frag"));
+
+	writeFile(dir / "common.glsl", "float f() { return 2.0; }\n");
+	EXPECT_NE(first, hashShaderSource(dir / "shader.frag"));
+}
+
+TEST_F(testShaderCompiler, includeCycle) {
+	writeFile(dir / "shader.frag", "#include \"a.glsl\"\n");
+	writeFile(dir / "a.glsl", "#include \"b.glsl\"\n");
+	writeFile(dir / "b.glsl", "  #  include \"a.glsl\"\n");
+
+	EXPECT_NO_THROW(hashShaderSource(dir / "shader.frag"));
+}
+
+TEST_F(testShaderCompiler, prebuiltFallback) {
+	writeFile(dir / "frag.spv", "SPIRV");
+	EXPECT_TRUE(ShaderCompiler::hasShader(dir, ShaderCompiler::Stage::fragment));
+	EXPECT_FALSE(ShaderCompiler::hasShader(dir, ShaderCompiler::Stage::vertex));
+
+	ShaderCompiler compiler({dir / "cache"});
+	auto spirv = compiler.load(dir, ShaderCompiler::Stage::fragment);
+	EXPECT_EQ(std::string(spirv.begin(), spirv.end()), "SPIRV");
+}
+
+TEST_F(testShaderCompiler, invalidCacheEntry) {
+	if (!ShaderCompiler::supported()) GTEST_SKIP() << "runtime shader compilation is unavailable";
+
+	writeFile(dir / "shader.frag", "#version 450\nvoid main() {}\n");
+	ShaderCompiler compiler({dir / "cache"});
+	const auto spirv = compiler.load(dir, ShaderCompiler::Stage::fragment);
+
+	// e.g. truncated by a full disk
+	size_t entries = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(dir / "cache")) {
+		std::filesystem::resize_file(entry.path(), 6);
+		++entries;
+	}
+	ASSERT_EQ(entries, 1);
+
+	EXPECT_EQ(compiler.load(dir, ShaderCompiler::Stage::fragment), spirv);
+	for (const auto& entry : std::filesystem::directory_iterator(dir / "cache"))
+		EXPECT_EQ(std::filesystem::file_size(entry.path()), spirv.size());
+}
+
+TEST(testSpirv, descriptorBindings) {
+	const std::vector<uint32_t> words = {
+	    0x07230203, 0x00010000, 0, 20, 0,
+	    // OpDecorate %10 DescriptorSet 1, OpDecorate %10 Binding 3
+	    (4 << 16) | 71, 10, 34, 1, (4 << 16) | 71, 10, 33, 3,
+	    // OpDecorate %11 Binding 2 without a set, OpDecorate %12 Location 0
+	    (4 << 16) | 71, 11, 33, 2, (4 << 16) | 71, 12, 30, 0};
+	std::vector<char> spirv(words.size() * sizeof(uint32_t));
+	std::memcpy(spirv.data(), words.data(), spirv.size());
+
+	const auto bindings = descriptorBindings(spirv);
+	ASSERT_EQ(bindings.size(), 2);
+	EXPECT_EQ(bindings[0], std::make_pair(1u, 3u));
+	EXPECT_EQ(bindings[1], std::make_pair(0u, 2u));
+
+	EXPECT_THROW(descriptorBindings({'S', 'P', 'I', 'R', 'V'}), std::invalid_argument);
+	spirv.resize(spirv.size() - sizeof(uint32_t));
+	EXPECT_THROW(descriptorBindings(spirv), std::invalid_argument);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "Data.hpp"
+#include "SharedSpectrum.hpp"
+
+namespace {
+	constexpr size_t audioSize = 256;
+
+	// unique per run so that concurrent test runs do not share objects
+	std::string objectName(const char* name) {
+		const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+		return std::string("vkavTest") + name + std::to_string(now);
+	}
+
+	void fill(AudioData& audioData, float value) {
+		for (size_t i = 0; i < audioSize; ++i) {
+			audioData.lBuffer[i] = value;
+			audioData.rBuffer[i] = -value;
+		}
+		audioData.lVolume = value;
+		audioData.rVolume = -value;
+	}
+}  // namespace
+
+TEST(testSharedSpectrum, publish) {
+	const auto name = objectName("Publish");
+	SharedSpectrumWriter writer(name, audioSize);
+	SharedSpectrumReader reader(name);
+	EXPECT_EQ(reader.audioSize(), audioSize);
+
+	AudioData audioData, received;
+	audioData.allocate(2, 2 * audioSize);
+	received.allocate(2, 2 * audioSize);
+	EXPECT_FALSE(reader.read(received));
+
+	const auto timestamp = std::chrono::steady_clock::now();
+	fill(audioData, 1.f);
+	writer.publish(audioData, timestamp);
+	ASSERT_TRUE(reader.read(received));
+	EXPECT_EQ(reader.sequence(), 1);
+	EXPECT_EQ(reader.timestamp(), timestamp);
+	EXPECT_FLOAT_EQ(received.lVolume, 1.f);
+	EXPECT_FLOAT_EQ(received.rBuffer[audioSize - 1], -1.f);
+
+	// nothing new
+	EXPECT_FALSE(reader.read(received));
+
+	// only the latest of several updates is read
+	for (int update = 2; update <= 20; ++update) {
+		fill(audioData, update);
+		writer.publish(audioData, timestamp);
+	}
+	ASSERT_TRUE(reader.read(received));
+	EXPECT_EQ(reader.sequence(), 20);
+	EXPECT_FLOAT_EQ(received.lBuffer[0], 20.f);
+
+	EXPECT_FALSE(reader.closed());
+	writer = SharedSpectrumWriter();
+	EXPECT_TRUE(reader.closed());
+}
+
+TEST(testSharedSpectrum, concurrent) {
+	const auto name = objectName("Concurrent");
+	SharedSpectrumWriter writer(name, audioSize);
+	SharedSpectrumReader reader(name);
+
+	constexpr int updates = 20000;
+	std::atomic<bool> done = false;
+	std::thread writerThread([&] {
+		AudioData audioData;
+		audioData.allocate(2, 2 * audioSize);
+		for (int update = 1; update <= updates; ++update) {
+			fill(audioData, update);
+			writer.publish(audioData, std::chrono::steady_clock::now());
+		}
+		done = true;
+	});
+
+	AudioData received;
+	received.allocate(2, 2 * audioSize);
+	uint64_t lastSequence = 0;
+	int torn = 0;
+	while (!done || lastSequence < updates) {
+		if (!reader.read(received)) continue;
+		EXPECT_GT(reader.sequence(), lastSequence);
+		lastSequence = reader.sequence();
+		// every value of an update is its sequence number
+		for (size_t i = 0; i < audioSize; ++i)
+			if (received.lBuffer[i] != lastSequence || received.rBuffer[i] != -received.lVolume)
+				++torn;
+	}
+	writerThread.join();
+	EXPECT_EQ(torn, 0);
+}
+
+TEST(testSharedSpectrum, invalid) {
+	EXPECT_THROW(SharedSpectrumReader(objectName("Missing")), std::runtime_error);
+}
+
+TEST(testSharedSpectrum, inUse) {
+	const auto name = objectName("InUse");
+	{
+		SharedSpectrumWriter writer(name, audioSize);
+		// a second writer must not take the object away from a running one
+		EXPECT_THROW(SharedSpectrumWriter(name, audioSize), std::runtime_error);
+		SharedSpectrumReader reader(name);
+		EXPECT_FALSE(reader.closed());
+	}
+	SharedSpectrumWriter writer(name, audioSize);
+	EXPECT_TRUE(writer.isOpen());
+}
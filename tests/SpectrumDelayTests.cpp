@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+
+#include "Data.hpp"
+#include "SpectrumDelay.hpp"
+
+namespace {
+	constexpr size_t audioSize = 64;
+
+	using milliseconds = std::chrono::milliseconds;
+	const auto start = std::chrono::steady_clock::now();
+
+	void fill(AudioData& audioData, float value) {
+		for (size_t i = 0; i < audioSize; ++i) {
+			audioData.lBuffer[i] = value;
+			audioData.rBuffer[i] = -value;
+		}
+		audioData.lVolume = value;
+		audioData.rVolume = -value;
+	}
+
+	void expectFilled(const AudioData& audioData, float value) {
+		for (size_t i = 0; i < audioSize; ++i) {
+			ASSERT_EQ(audioData.lBuffer[i], value);
+			ASSERT_EQ(audioData.rBuffer[i], -value);
+		}
+		EXPECT_EQ(audioData.lVolume, value);
+		EXPECT_EQ(audioData.rVolume, -value);
+	}
+}  // namespace
+
+TEST(testSpectrumDelay, delay) {
+	SpectrumDelay delay(audioSize, 8);
+	AudioData audioData, delayed;
+	audioData.allocate(2, 2 * audioSize);
+	delayed.allocate(2, 2 * audioSize);
+
+	for (int i = 0; i < 4; ++i) {
+		fill(audioData, i);
+		delay.push(audioData, start + milliseconds(10 * i));
+	}
+	EXPECT_EQ(delay.size(), 4);
+
+	EXPECT_FALSE(delay.pop(delayed, start - milliseconds(1)));
+	ASSERT_TRUE(delay.pop(delayed, start));
+	expectFilled(delayed, 0);
+
+	// spectra that fell due together are skipped up to the newest one
+	ASSERT_TRUE(delay.pop(delayed, start + milliseconds(25)));
+	expectFilled(delayed, 2);
+	EXPECT_EQ(delay.size(), 1);
+
+	EXPECT_FALSE(delay.pop(delayed, start + milliseconds(25)));
+	ASSERT_TRUE(delay.pop(delayed, start + milliseconds(100)));
+	expectFilled(delayed, 3);
+	EXPECT_EQ(delay.size(), 0);
+	EXPECT_FALSE(delay.pop(delayed, start + milliseconds(100)));
+}
+
+TEST(testSpectrumDelay, full) {
+	SpectrumDelay delay(audioSize, 3);
+	AudioData audioData, delayed;
+	audioData.allocate(2, 2 * audioSize);
+	delayed.allocate(2, 2 * audioSize);
+
+	// the oldest spectra are dropped once the ring is full
+	for (int i = 0; i < 5; ++i) {
+		fill(audioData, i);
+		delay.push(audioData, start + milliseconds(10 * i));
+	}
+	EXPECT_EQ(delay.size(), 3);
+
+	ASSERT_TRUE(delay.pop(delayed, start + milliseconds(20)));
+	expectFilled(delayed, 2);
+	ASSERT_TRUE(delay.pop(delayed, start + milliseconds(30)));
+	expectFilled(delayed, 3);
+
+	delay.clear();
+	EXPECT_EQ(delay.size(), 0);
+	EXPECT_FALSE(delay.pop(delayed, start + milliseconds(100)));
+
+	fill(audioData, 7);
+	delay.push(audioData, start + milliseconds(50));
+	ASSERT_TRUE(delay.pop(delayed, start + milliseconds(50)));
+	expectFilled(delayed, 7);
+}
+
+TEST(testSpectrumDelay, invalid) {
+	EXPECT_THROW(SpectrumDelay(audioSize, 0), std::invalid_argument);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Data.hpp"
+#include "Half.hpp"
+#include "SpectrumStream.hpp"
+
+namespace {
+	constexpr size_t audioSize = 512;
+
+	void fill(AudioData& audioData, float scale) {
+		for (size_t i = 0; i < audioSize; ++i) {
+			audioData.lBuffer[i] = scale * (1.f + std::sin(0.01f * i));
+			audioData.rBuffer[i] = scale * (1.f + std::cos(0.01f * i));
+		}
+		audioData.lVolume = scale;
+		audioData.rVolume = 2.f * scale;
+	}
+
+	/**
+	 * Receives for up to a second, loopback datagrams normally arrive immediately
+	 */
+	bool receive(SpectrumReceiver& receiver, AudioData& audioData) {
+		for (int attempt = 0; attempt < 1000; ++attempt) {
+			if (receiver.receive(audioData)) return true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return false;
+	}
+}  // namespace
+
+TEST(testSpectrumStream, half) {
+	// every finite half survives the round trip
+	for (uint32_t half = 0; half < 0x10000; ++half) {
+		if ((half & 0x7c00) == 0x7c00 && (half & 0x3ff)) continue;
+		ASSERT_EQ(floatToHalf(halfToFloat(half)), half) << half;
+	}
+
+	EXPECT_EQ(floatToHalf(1.f), 0x3c00);
+	EXPECT_EQ(floatToHalf(-2.f), 0xc000);
+	EXPECT_EQ(floatToHalf(65504.f), 0x7bff);
+	EXPECT_EQ(floatToHalf(1e6f), 0x7c00);
+	EXPECT_TRUE(std::isnan(halfToFloat(floatToHalf(NAN))));
+	// ties round to even
+	EXPECT_EQ(floatToHalf(1.f + 1.f / 2048), 0x3c00);
+	EXPECT_EQ(floatToHalf(1.f + 3.f / 2048), 0x3c02);
+	// smallest subnormal
+	EXPECT_EQ(floatToHalf(std::ldexp(1.f, -24)), 0x0001);
+}
+
+TEST(testSpectrumStream, packet) {
+	SpectrumPacket packet;
+	packet.sequence = 7;
+	packet.timestamp = -123456789;
+	packet.lVolume = 0.25f;
+	packet.rVolume = 0.5f;
+	packet.left = {0.f, 1e-5f, 0.001f, 0.1f, 1.f, 3.f};
+	packet.right = {20.f, 2.f, 0.2f, 0.02f, 0.002f, 0.f};
+
+	for (auto encoding : {SpectrumEncoding::fp16, SpectrumEncoding::log8}) {
+		std::vector<uint8_t> datagram;
+		encodeSpectrumPacket(packet, encoding, datagram);
+		const size_t valueSize = encoding == SpectrumEncoding::fp16 ? 2 : 1;
+		EXPECT_EQ(datagram.size(), SpectrumPacket::headerSize + 2 * 6 * valueSize);
+
+		SpectrumPacket decoded;
+		decodeSpectrumPacket(datagram.data(), datagram.size(), decoded);
+		EXPECT_EQ(decoded.sequence, 7);
+		EXPECT_EQ(decoded.timestamp, -123456789);
+		EXPECT_EQ(decoded.lVolume, 0.25f);
+		ASSERT_EQ(decoded.left.size(), 6);
+		ASSERT_EQ(decoded.right.size(), 6);
+
+		for (size_t i = 0; i < 6; ++i) {
+			for (auto [original, value] : {std::pair{packet.left[i], decoded.left[i]},
+			                               std::pair{packet.right[i], decoded.right[i]}}) {
+				if (encoding == SpectrumEncoding::fp16) {
+					EXPECT_NEAR(value, original, original / 1024 + 1e-7f);
+				} else if (original <= SpectrumPacket::logFloor) {
+					EXPECT_EQ(value, 0.f);
+				} else {
+					// clamped to the ceiling, otherwise within half a step
+					EXPECT_NEAR(value, std::min(original, SpectrumPacket::logCeiling),
+					            0.025f * original);
+				}
+			}
+		}
+
+		EXPECT_THROW(decodeSpectrumPacket(datagram.data(), datagram.size() - 1, decoded),
+		             std::invalid_argument);
+		datagram[0] = 'X';
+		EXPECT_THROW(decodeSpectrumPacket(datagram.data(), datagram.size(), decoded),
+		             std::invalid_argument);
+	}
+}
+
+TEST(testSpectrumStream, loopback) {
+	SpectrumReceiver::Settings receiverSettings;
+	receiverSettings.source = "127.0.0.1:0";
+	receiverSettings.audioSize = audioSize;
+	SpectrumReceiver receiver(receiverSettings);
+
+	SpectrumSender::Settings senderSettings;
+	senderSettings.destination = "127.0.0.1:" + std::to_string(receiver.port());
+	senderSettings.audioSize = audioSize;
+	senderSettings.bands = 128;
+	SpectrumSender sender(senderSettings);
+
+	AudioData audioData, received;
+	audioData.allocate(2, 2 * audioSize);
+	received.allocate(2, 2 * audioSize);
+	EXPECT_FALSE(receiver.receive(received));
+
+	fill(audioData, 1.f);
+	const auto timestamp = std::chrono::steady_clock::now();
+	sender.send(audioData, timestamp);
+	ASSERT_TRUE(receive(receiver, received));
+	EXPECT_EQ(receiver.packet().sequence, 1);
+	EXPECT_EQ(receiver.packet().timestamp,
+	          std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch())
+	              .count());
+	EXPECT_EQ(receiver.packet().left.size(), 128);
+	EXPECT_FLOAT_EQ(received.rVolume, 2.f);
+	// the slowly varying spectrum survives the band reduction, up to the slope over a band
+	for (size_t i = 0; i < audioSize; ++i) {
+		EXPECT_NEAR(received.lBuffer[i], audioData.lBuffer[i], 0.02f) << i;
+		EXPECT_NEAR(received.rBuffer[i], audioData.rBuffer[i], 0.02f) << i;
+	}
+
+	// only the newest of several pending updates is used
+	for (int update = 2; update <= 5; ++update) {
+		fill(audioData, update);
+		sender.send(audioData, timestamp);
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	ASSERT_TRUE(receive(receiver, received));
+	EXPECT_EQ(receiver.packet().sequence, 5);
+	EXPECT_FLOAT_EQ(received.lVolume, 5.f);
+	EXPECT_EQ(receiver.stats().received, 5);
+	EXPECT_EQ(receiver.stats().lost, 0);
+}
+
+TEST(testSpectrumStream, invalidSettings) {
+	SpectrumSender::Settings settings;
+	settings.destination = "127.0.0.1:9";
+	settings.audioSize = audioSize;
+	settings.bands = SpectrumPacket::maxBands(SpectrumEncoding::fp16) + 1;
+	EXPECT_THROW(SpectrumSender{settings}, std::invalid_argument);
+
+	settings.bands = 64;
+	settings.destination = "no port";
+	EXPECT_THROW(SpectrumSender{settings}, std::invalid_argument);
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "Trace.hpp"
+
+namespace {
+	std::string readFile(const std::filesystem::path& path) {
+		std::ifstream file(path);
+		std::stringstream contents;
+		contents << file.rdbuf();
+		return contents.str();
+	}
+
+	size_t count(const std::string& str, const std::string& substr) {
+		size_t n = 0;
+		for (auto pos = str.find(substr); pos != std::string::npos;
+		     pos = str.find(substr, pos + 1))
+			++n;
+		return n;
+	}
+}  // namespace
+
+TEST(testTrace, spans) {
+	const auto path = std::filesystem::temp_directory_path() / "vkavTraceTest.json";
+
+	{ TRACE_SCOPE("untraced"); }
+
+	startTrace(path);
+	{
+		TRACE_SCOPE("outer");
+		TRACE_SCOPE("inner \"quoted\"");
+	}
+	std::thread([] { TRACE_SCOPE("thread"); }).join();
+	stopTrace();
+
+	{ TRACE_SCOPE("afterwards"); }
+	stopTrace();
+
+	const auto trace = readFile(path);
+	std::filesystem::remove(path);
+
+	EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+	EXPECT_EQ(count(trace, "\"ph\":\"X\""), 3);
+	EXPECT_EQ(count(trace, "\"name\":\"outer\""), 1);
+	EXPECT_EQ(count(trace, "\"name\":\"inner \\\"quoted\\\"\""), 1);
+	EXPECT_EQ(count(trace, "\"tid\":0"), 2);
+	EXPECT_EQ(count(trace, "\"tid\":1"), 1);
+	EXPECT_EQ(count(trace, "untraced"), 0);
+	EXPECT_EQ(count(trace, "afterwards"), 0);
+}
+
+TEST(testTrace, invalidPath) {
+	EXPECT_THROW(startTrace("/nonexistent/directory/trace.json"), std::runtime_error);
+	EXPECT_FALSE(tracing);
+}